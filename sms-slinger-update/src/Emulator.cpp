@@ -31,39 +31,37 @@
 #include <cstdio>
 #include <cassert>
 #include <cstring>
+#include <algorithm>
 
-namespace
-{
-    BYTE readByte(WORD address)
-    {
-        return Emulator::getSingleton()->readMemory(address);
-    }
+#ifdef Z80_WIDE
+#include "Z80.Wide.hpp"
+#endif
 
-    void writeByte(WORD address, BYTE data)
-    {
-        Emulator::getSingleton()->writeMemory(address, data);
-    }
+#ifdef Z80_RECOMPILED
+#include "Z80.Recompiled.hpp"
 
-    BYTE readIOByte(BYTE address)
-    {
-        return Emulator::getSingleton()->readIOMemory(address);
-    }
+#include <string>
 
-    void writeIOByte(BYTE address, BYTE data)
-    {
-        Emulator::getSingleton()->writeIOMemory(address, data);
-    }
-}
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#endif
 
 std::unique_ptr<Emulator> Emulator::m_instance;
 
 Emulator::Emulator()
     : m_cyclesThisUpdate(0),
     m_FPS               (60),
+    m_Z80               (*this),
     m_isPAL             (false),
     m_isCodeMasters     (false),
     m_oneMegCartridge   (false),
     m_clockInfo         (0),
+    m_instructionCount  (0),
     m_firstBankPage     (0),
     m_secondBankPage    (0),
     m_thirdBankPage     (0),
@@ -95,10 +93,20 @@ Emulator* Emulator::getSingleton()
 void Emulator::reset()
 {
     m_clockInfo = 0;
+    m_instructionCount = 0;
+    m_clock = 0;
+    m_graphicsClock = 0;
+    m_soundClock = 0;
+    std::fill(m_events.begin(), m_events.end(), 0);
+    m_nextEvent = 0;
+    m_idleLoop = {};
+
+    //make sure no pending lazy flags get written over the reset AF
+    m_Z80.SyncFlags();
 
     CONTEXTZ80* context = m_Z80.GetContext();
-    std::memset(&context->m_CartridgeMemory, 0, sizeof(context->m_CartridgeMemory));
-    std::memset(&context->m_InternalMemory, 0, sizeof(context->m_InternalMemory));
+    std::fill(m_cartridgeMemory.begin(), m_cartridgeMemory.end(), 0);
+    std::fill(m_internalMemory.begin(), m_internalMemory.end(), 0);
    
     std::memset(&m_ramBank, 0, sizeof(m_ramBank));
 
@@ -120,17 +128,13 @@ void Emulator::reset()
     context->m_ProgramCounter = 0;
     context->m_OpcodeCycle = 0;
     context->m_StackPointer.reg = 0xDFF0;
-    context->m_InternalMemory[0xFFFF] = 2; // official sega doc
-    context->m_InternalMemory[0xFFFE] = 1; // official sega doc
-    context->m_FuncPtrRead = &readByte;
-    context->m_FuncPtrWrite = &writeByte;
-    context->m_FuncPtrIORead = &readIOByte;
-    context->m_FuncPtrIOWrite = &writeIOByte;
+    m_internalMemory[0xFFFF] = 2; // official sega doc
+    m_internalMemory[0xFFFE] = 1; // official sega doc
     context->m_IFF1 = false;
     context->m_IFF2 = false;
     context->m_Halted = false;
     context->m_InteruptMode = 1;
-    context->m_NMI = false;
+    context->m_InteruptLines = 0;
     context->m_NMIServicing = false;
     context->m_EIPending = false;
 
@@ -139,14 +143,26 @@ void Emulator::reset()
     m_cyclesThisUpdate = 0;
     m_oneMegCartridge = false;
     m_currentRam = -1;
+#ifdef Z80_RECOMPILED
+    unloadRecompiledRom();
+#endif
+#ifdef Z80_BLOCK_CACHE
+    m_codePages.clear();
+    m_Z80.FlushCodeCache();
+#endif
+#ifdef Z80_PROFILER
+    m_Z80.GetProfiler().reset();
+#endif
+#ifdef Z80_TRACE
+    m_Z80.GetTrace().reset();
+#endif
+    updatePageTables();
 
     m_soundChip.reset();
 }
 
 void Emulator::insertCartridge(const char* path)
 {
-    CONTEXTZ80* context = m_Z80.GetContext();
-
     FILE *in = nullptr;
 
     // get the file size
@@ -175,13 +191,13 @@ void Emulator::insertCartridge(const char* path)
         }
     }
 
-    fread(context->m_CartridgeMemory, 1, 0x100000, in);
+    fread(m_cartridgeMemory.data(), 1, m_cartridgeMemory.size(), in);
     m_oneMegCartridge = (endPos > 0x80000) ? true : false;
     
-    std::memcpy(&context->m_InternalMemory[0x0], &context->m_CartridgeMemory[0x0], 0xC000);
+    std::memcpy(&m_internalMemory[0x0], &m_cartridgeMemory[0x0], 0xC000);
 
-    context->m_InternalMemory[0xFFFE] = 0x01;
-    context->m_InternalMemory[0xFFFF] = 0x02;
+    m_internalMemory[0xFFFE] = 0x01;
+    m_internalMemory[0xFFFF] = 0x02;
 
     m_firstBankPage = 0;
     m_secondBankPage = 1;
@@ -199,159 +215,173 @@ void Emulator::insertCartridge(const char* path)
         doMemPageCM(0x4000, 1);
         doMemPageCM(0x8000, 0);
     }
+#ifdef Z80_BLOCK_CACHE
+    m_codePages.clear();
+    m_Z80.FlushCodeCache();
+#endif
+    updatePageTables();
+#ifdef Z80_RECOMPILED
+    loadRecompiledRom(path);
+#endif
 }
 
 void Emulator::update()
 {
-    m_cyclesThisUpdate = 0;
-    m_graphicsChip.resetScreen();
+#ifdef Z80_DEBUGGER
+    //a frame which the debugger stopped part way through carries on
+    if (!m_midFrame)
+#endif
+    {
+        m_cyclesThisUpdate = 0;
+        m_graphicsChip.resetScreen();
+    }
+
     while (!m_graphicsChip.getRefresh())
     { 
-        int cycles = 0;
+#ifdef Z80_DEBUGGER
+        //everything is left as it is until the debugger carries on
+        m_midFrame = m_Z80.GetDebugger().isPaused();
+        if (m_midFrame)
+        {
+            return;
+        }
+#endif
+        scheduleEvents();
+
         if (m_Z80.GetContext()->m_Halted)
         {
-            cycles = 4;
+            skipHaltedCycles();
         }
         else
         {
-            cycles = m_Z80.ExecuteNextOpcode();
+            //the cpu runs on by itself up to the next event. When that is
+            //already due it runs a single instruction.
+            m_Z80.Run(getQuietCycles());
+#ifdef Z80_DEBUGGER
+            //stop before an interrupt can move the pc on
+            if (m_Z80.GetDebugger().isPaused())
+            {
+                continue;
+            }
+#endif
         }
-        checkInterupts();
-        
-        //sound chip is 1/3 cycles so do this before scaling
-        m_soundChip.update(cycles);
-
-
-
-        //http://www.smspower.org/forums/viewtopic.php?p=44198      
-                
-        // convert from clock cycles to machine cycles
-        // FIX ME! THIS SHOULD BE * 3, not * 2. HOWEVER WITH * 3 SOME GAMES FEEL REALLY CRAP AND SLOW
-        // I BELIEVE ITS A VSYNC INTERRUPT ISSUE
-
-        //potentially related to the (fixed) typo in TMS9918A::GetHCount()? - M
-        //cycles *= 2;
-        cycles *= 3;
-
-        m_cyclesThisUpdate += cycles;
-        m_clockInfo += cycles;
-
-        // graphics chips clock is half of that of the sms machine clock
-        /*float vdpClock = static_cast<float>(cycles);
-        vdpClock /= 2;*/
-        m_graphicsChip.update(cycles);      
+        finishCpuSlice();
     }
+#ifdef Z80_DEBUGGER
+    m_midFrame = false;
+#endif
+
+    //the samples for this frame are read as soon as we return
+    flushSound();
 }
 
-BYTE Emulator::readMemory(const WORD& address)
+void Emulator::skipHaltedCycles()
 {
-    CONTEXTZ80* context = m_Z80.GetContext();
-    WORD addr = address;
-
-    if (addr >= 0xFFFC)
-    {
-        addr -= 0x2000;
-    }
+    //nothing but an interrupt can end a halt, so the 4 cycle steps
+    //which fit before the next event are counted off in one go
+    int steps = getQuietCycles() / 4;
+    addMachineCycles((steps + 1) * 4, 0);
+    m_idleLoop.count = IDLE_LOOP_MAX_INSTRUCTIONS + 1;
+}
 
-    // the fixed memory address
-    if (!m_isCodeMasters && (addr < 0x400))
-    {
-        return context->m_InternalMemory[addr];
-    }
-    // bank 0
-    else if (addr < 0x4000)
-    {
-        unsigned int bankaddr = addr + (0x4000 * m_firstBankPage);
-        return context->m_CartridgeMemory[bankaddr];
-    }
-    // bank 1
-    else if (addr < 0x8000)
-    {
-        unsigned int bankaddr = addr + (0x4000 * m_secondBankPage);
-        bankaddr-=0x4000;
-        return context->m_CartridgeMemory[bankaddr];
-    }
-    // bank 2
-    else if (addr < 0xC000)
+void Emulator::finishCpuSlice()
+{
+    if (m_Z80.IsInteruptPending())
     {
-        // is ram banking mapped in this slot?
-        if (m_currentRam > -1)
-        {
-            return m_ramBank[m_currentRam][addr-0x8000];
-        }
-        else
-        {
-            unsigned int bankaddr = addr + (0x4000 * m_thirdBankPage);
-            bankaddr-=0x8000;
-            return context->m_CartridgeMemory[bankaddr];
-        }
+        m_Z80.TakeInterupt();
     }
-
-    return context->m_InternalMemory[addr];
+    flushCycles();
 }
 
-void Emulator::writeMemory(const WORD& address, const BYTE& data)
+#ifdef Z80_WIDE
+unsigned long long Emulator::updateLockstep(Emulator* const* emulators, std::size_t count)
 {
-    CONTEXTZ80* context = m_Z80.GetContext();
-
-    if (m_isCodeMasters)
+#ifdef Z80_DEBUGGER
+    //the debugger can stop an emulator part way through a frame, which
+    //only update() knows how to carry on from
+    for (std::size_t i = 0; i < count; ++i)
     {
-        if (address == 0x0)
-        {
-            doMemPageCM(address,data);
-        }
-        else if (address == 0x4000)
-        {
-            doMemPageCM(address,data);
-        }
-        else if (address == 0x8000)
-        {
-            doMemPageCM(address,data);
-        }
+        emulators[i]->update();
+    }
+    return 0;
+#else
+    unsigned long long lockstep = 0;
+    constexpr std::size_t MAX_LANES = Z80Wide<Emulator>::MAX_LANES;
+    for (; count > MAX_LANES; count -= MAX_LANES, emulators += MAX_LANES)
+    {
+        lockstep += updateLockstep(emulators, MAX_LANES);
     }
 
-    // cant write to rom
-    if (address < 0x8000)
+    //each emulator goes through exactly the same steps as it would in
+    //update(), only the cpus of all of them run together
+    std::array<bool, MAX_LANES> running = {};
+    for (std::size_t i = 0; i < count; ++i)
     {
-        return;
+        emulators[i]->m_cyclesThisUpdate = 0;
+        emulators[i]->m_graphicsChip.resetScreen();
+        running[i] = true;
     }
 
-    // only allow writing to here if a ram bank is mapped into this slot
-    else if (address < 0xC000)
+    Z80Wide<Emulator> wide;
+    bool anyRunning = true;
+    while (anyRunning)
     {
-        if (m_currentRam > -1)
+        anyRunning = false;
+        for (std::size_t i = 0; i < count; ++i)
         {
-            m_ramBank[m_currentRam][address-0x8000] = data;
-            return;
-        }
-        else
-        {
-            // this is rom so lets return
-            return;
+            //getRefresh() only says so once, so a finished frame is remembered
+            Emulator& emulator = *emulators[i];
+            running[i] = running[i] && !emulator.m_graphicsChip.getRefresh();
+            if (running[i])
+            {
+                anyRunning = true;
+                emulator.scheduleEvents();
+                if (emulator.m_Z80.GetContext()->m_Halted)
+                {
+                    emulator.skipHaltedCycles();
+                }
+                else
+                {
+                    wide.AddLane(emulator.m_Z80, emulator, emulator.getQuietCycles());
+                }
+            }
         }
-    }
 
-    context->m_InternalMemory[address] = data;
+        wide.Run();
 
-    if (address >= 0xFFFC)
-    {
-        if (!m_isCodeMasters)
+        for (std::size_t i = 0; i < count; ++i)
         {
-            doMemPage(address, data);
+            if (running[i])
+            {
+                emulators[i]->finishCpuSlice();
+            }
         }
     }
 
-    //  if you uncomment the following crap, you need to find out what happens to the rom/ram banking with mirroring
-    // for example if address == 0xDFFF then mirroring with overwrite 0xFFFF which is a ram bank. Should I allow this?
-    if (address >= 0xC000 && address < 0xDFFC)
+    for (std::size_t i = 0; i < count; ++i)
     {
-        context->m_InternalMemory[address + 0x2000] = data;
+        emulators[i]->flushSound();
     }
+    return lockstep + wide.GetLockstepCount();
+#endif
+}
+#endif
 
-    if (address >= 0xE000)
+void Emulator::scheduleEvents()
+{
+    //every pass of update() picks the earliest event off the clock
+    //for the cpu to run up to. Input needs no event of its own as the
+    //ports only change between calls to update()
+    m_events[Event::Interupt] = m_Z80.IsInteruptPending() ? m_clock : NEVER;
+    m_events[Event::EndOfLine] = m_graphicsClock + (m_graphicsChip.getCyclesToNextLine() / CPU_CYCLES_TO_MACHINE_CLICKS);
+
+    if (m_events[Event::Sound] <= m_clock)
     {
-        context->m_InternalMemory[address - 0x2000] = data;
+        flushSound();
+        m_events[Event::Sound] = m_clock + SOUND_SYNC_CYCLES;
     }
+
+    m_nextEvent = *std::min_element(m_events.begin(), m_events.end());
 }
 
 BYTE Emulator::readIOMemory(const BYTE& address)
@@ -373,12 +403,18 @@ BYTE Emulator::readIOMemory(const BYTE& address)
 
     if ((address >= 0x80) && (address <= 0xBF))
     {
+        //reading either port changes the vdp's state
+        ++m_sideEffects;
+
         //Even locations are data port, odd locations are control port.
         if ((address % 2)== 0)
         {
             return m_graphicsChip.readDataPort();
         }
-        return m_graphicsChip.getStatus();    
+        //reading the status lowers the interrupt line
+        BYTE status = m_graphicsChip.getStatus();
+        updateInteruptLine();
+        return status;
     }
 
     switch (address)
@@ -399,6 +435,8 @@ BYTE Emulator::readIOMemory(const BYTE& address)
 
 void Emulator::writeIOMemory(const BYTE& address, const BYTE& data)
 {
+    ++m_sideEffects;
+
     if (address < 0x40)
     {
         return;
@@ -407,6 +445,7 @@ void Emulator::writeIOMemory(const BYTE& address, const BYTE& data)
     if ((address >=0x40) && (address < 0x80))
     {
         //sound
+        flushSound();
         m_soundChip.writeData(data);
         return;
     }
@@ -420,6 +459,9 @@ void Emulator::writeIOMemory(const BYTE& address, const BYTE& data)
 //          sprintf(buffer, "PC is %x", context->m_ProgramCounterStart);
 //          LogMessage::GetSingleton()->DoLogMessage(buffer, false);
             m_graphicsChip.writeVDPAddress(data);
+            //a register write can enable an interrupt which is already waiting
+            updateInteruptLine();
+            scheduleEvent(Event::Interupt, m_clock);
         }break;
         case 0xBD: 
             {
@@ -427,6 +469,8 @@ void Emulator::writeIOMemory(const BYTE& address, const BYTE& data)
 //              sprintf(buffer, "PC is %x", context->m_ProgramCounterStart);
 //              LogMessage::GetSingleton()->DoLogMessage(buffer, false);
                 m_graphicsChip.writeVDPAddress(data);
+                updateInteruptLine();
+                scheduleEvent(Event::Interupt, m_clock);
             }
             break;
         default:  break;
@@ -449,11 +493,11 @@ void Emulator::setKeyReleased(int player, int key)
 
 void Emulator::resetButton()
 {
-    CONTEXTZ80* context = m_Z80.GetContext();
-
-    if (!context->m_NMIServicing)
+    //the pause button is wired to the nmi, which can't be raised again
+    //until the handler for the last one has returned
+    if (!m_Z80.GetContext()->m_NMIServicing)
     {
-        context->m_NMI = true;
+        m_Z80.SetInteruptLine(InteruptLine::NMI, true);
     }
 
     setKeyPressed(0, 4);
@@ -479,34 +523,69 @@ void Emulator::dumpClockInfo()
     m_clockInfo = 0;
 }
 
-void Emulator::checkInterupts()
+int Emulator::getBlockRepeatLimit(int cycles)
 {
-    if  (m_Z80.GetContext()->m_NMI && (m_Z80.GetContext()->m_NMIServicing == false))
+    //the number of extra iterations a repeating block instruction taking
+    //this many cycles can run within getQuietCycles()
+#ifdef Z80_DEBUGGER
+    //none while debugging, so a step or a watchpoint stops the cpu after a
+    //single iteration. This also keeps OTIR/OTDR away from writeIOBlock()
+    if (m_Z80.GetDebugger().isActive())
     {
-        m_Z80.IncreaseRReg();
-        m_Z80.GetContext()->m_NMIServicing = true;
-        m_Z80.GetContext()->m_NMI = false;
-
-        CONTEXTZ80* context = m_Z80.GetContext();
-        context->m_IFF1 = false;
-        context->m_Halted = false;
-        m_Z80.PushWordOntoStack(context->m_ProgramCounter);
-        context->m_ProgramCounter = 0x66;
+        return 0;
     }
+#endif
+    return getQuietCycles() / cycles;
+}
 
-    if (m_graphicsChip.isRequestingInterupt())
+void Emulator::addCycles(const BYTE* cycles, int count)
+{
+    //accounts for instructions which the cpu ran within getQuietCycles()
+    //without returning, as if each had gone through update()
+    int total = 0;
+    for (int i = 0; i < count; ++i)
     {
-        m_Z80.IncreaseRReg();
-        CONTEXTZ80* context = m_Z80.GetContext();
-        if (context->m_IFF1 && context->m_InteruptMode == 1)
-        {
-            context->m_Halted = false;
+        countIdleLoopCycles(cycles[i]);
+        total += cycles[i];
+    }
+    addMachineCycles(total, count);
+}
 
-            m_Z80.PushWordOntoStack(context->m_ProgramCounter);
-            context->m_ProgramCounter = 0x38;
-            context->m_IFF1 = false;
-            context->m_IFF2 = false;
-        }
+void Emulator::addBlockCycles(int cycles, int count)
+{
+    ++m_sideEffects;
+
+    //accounts for iterations of a block instruction which the cpu ran
+    //without returning, exactly as if they went through update() one by one
+    addMachineCycles(cycles * count, count);
+}
+
+bool Emulator::isBlockIOPort(BYTE address) const
+{
+    //ports which an OTIR/OTDR can stream into with writeIOBlock().
+    //the vdp control port is left out as it can change the interrupt state
+    return (address == 0xBE) || ((address >= 0x40) && (address < 0x80));
+}
+
+void Emulator::writeIOBlock(BYTE address, const BYTE* data, int count, int cycles)
+{
+    ++m_sideEffects;
+
+    //the rest of an OTIR/OTDR which the cpu ran without returning. Each
+    //write follows an iteration of the instruction, which is accounted
+    //for here as it is in addBlockCycles()
+    if (address == 0xBE)
+    {
+        m_graphicsChip.writeDataPortBlock(data, count);
+        addMachineCycles(cycles * count, count);
+    }
+    else
+    {
+        assert(isBlockIOPort(address));
+        flushSound();
+        m_soundChip.writeDataBlock(data, count, cycles);
+        addMachineCycles(cycles * count, count);
+        m_soundClock = m_clock;
     }
 }
 
@@ -514,10 +593,8 @@ void Emulator::checkInterupts()
 bool Emulator::isCodeMasters()
 {
     // a code masters rom header has a checksum. So if the checksum is correct it must be a code masters game
-    CONTEXTZ80* context = m_Z80.GetContext();
-
-    WORD checksum = context->m_InternalMemory[0x7fe7] << 8;
-    checksum |= context->m_InternalMemory[0x7fe6];
+    WORD checksum = m_internalMemory[0x7fe7] << 8;
+    checksum |= m_internalMemory[0x7fe6];
 
     if (checksum == 0x0)
     {
@@ -526,8 +603,8 @@ bool Emulator::isCodeMasters()
 
     WORD compute = 0x10000 - checksum;
 
-    WORD answer = context->m_InternalMemory[0x7fe9] << 8;
-    answer |= context->m_InternalMemory[0x7fe8];
+    WORD answer = m_internalMemory[0x7fe9] << 8;
+    answer |= m_internalMemory[0x7fe8];
 
     return (compute == answer);
 }
@@ -544,19 +621,18 @@ void Emulator::doMemPageCM(WORD address, BYTE data)
         case 0x4000: m_secondBankPage = page; break;//memcpy(&context->m_InternalMemory[0x4000], &context->m_CartridgeMemory[(0x4000*page)], 0x4000); break;
         case 0x8000: m_thirdBankPage = page; break;//memcpy(&context->m_InternalMemory[0x8000], &context->m_CartridgeMemory[(0x4000*page)], 0x4000); break;
     }
+    updatePageTables();
 }
 
 void Emulator::doMemPage(WORD address, BYTE data)
 {
-    CONTEXTZ80* context = m_Z80.GetContext();
-
     // memory paging. ROXOR!!!
     if (address >= 0xFFFC)
     {
         // I think the seventh bit is never used in page mirroring.
         BYTE page = m_oneMegCartridge ? (data & 0x3F) : (data & 0x1F);
 
-        context->m_InternalMemory[address-0x2000] = data; // ram mirror
+        m_internalMemory[address-0x2000] = data; // ram mirror
 
         if (false)
         {
@@ -600,7 +676,7 @@ void Emulator::doMemPage(WORD address, BYTE data)
             case 0xFFFF:
             {
                 // only allow rom banking in slot 2 if ram is not mapped there!
-                if (false == testBit(context->m_InternalMemory[0xFFFC],3))
+                if (false == testBit(m_internalMemory[0xFFFC],3))
                 {
                     m_thirdBankPage = page;
                     //memcpy(&context->m_InternalMemory[0x8000], &context->m_CartridgeMemory[0x4000*page], 0x4000);
@@ -608,5 +684,408 @@ void Emulator::doMemPage(WORD address, BYTE data)
             }
             break;
         }
+        updatePageTables();
+    }
+}
+
+void Emulator::flushCycles()
+{
+    //http://www.smspower.org/forums/viewtopic.php?p=44198      
+            
+    // convert from clock cycles to machine cycles
+    // FIX ME! THIS SHOULD BE * 3, not * 2. HOWEVER WITH * 3 SOME GAMES FEEL REALLY CRAP AND SLOW
+    // I BELIEVE ITS A VSYNC INTERRUPT ISSUE
+
+    //potentially related to the (fixed) typo in TMS9918A::GetHCount()? - M
+    //cycles *= 2;
+    int cycles = static_cast<int>(m_clock - m_graphicsClock) * CPU_CYCLES_TO_MACHINE_CLICKS;
+    m_graphicsClock = m_clock;
+
+    m_cyclesThisUpdate += cycles;
+    m_clockInfo += cycles;
+
+    // graphics chips clock is half of that of the sms machine clock
+    /*float vdpClock = static_cast<float>(cycles);
+    vdpClock /= 2;*/
+    m_graphicsChip.update(cycles);
+    updateInteruptLine();
+}
+void Emulator::flushSound()
+{
+    //the psg only needs catching up before it's written to, or when its
+    //samples are wanted. Counting the cycles up in one go gives the same
+    //output as updating it after every instruction
+    m_soundChip.update(static_cast<int>(m_clock - m_soundClock));
+    m_soundClock = m_clock;
+}
+
+Emulator::IdleLoopState Emulator::getIdleLoopState()
+{
+    //everything but PC and R, which checkIdleLoop() deals with itself
+    const CONTEXTZ80* context = m_Z80.GetContext();
+    return
+    {
+        context->m_RegisterAF.reg, context->m_RegisterBC.reg,
+        context->m_RegisterDE.reg, context->m_RegisterHL.reg,
+        context->m_RegisterAFPrime.reg, context->m_RegisterBCPrime.reg,
+        context->m_RegisterDEPrime.reg, context->m_RegisterHLPrime.reg,
+        context->m_StackPointer.reg, context->m_RegisterIX.reg, context->m_RegisterIY.reg,
+        static_cast<WORD>(context->m_RegisterI | (context->m_InteruptMode << 8)),
+        static_cast<WORD>(context->m_IFF1 | (context->m_IFF2 << 1) | (context->m_EIPending << 2) | (context->m_NMIServicing << 3))
+    };
+}
+
+void Emulator::checkIdleLoop()
+{
+    //a jump back to the same place which leaves the cpu exactly as it was
+    //on the last pass, having written nothing and read nothing which can
+    //change before the next line, will do the same again until then. All
+    //the passes that fit before the next line or interrupt are accounted
+    //for here in one go, exactly as if they had been run.
+    CONTEXTZ80* context = m_Z80.GetContext();
+    WORD pc = context->m_ProgramCounter;
+    WORD start = context->m_ProgramCounterStart;
+    if ((pc > start) || ((start - pc) > IDLE_LOOP_MAX_SIZE))
+    {
+        return;
+    }
+
+#ifdef Z80_DEBUGGER
+    //a breakpoint in the loop has to see every pass
+    if (m_Z80.GetDebugger().isActive())
+    {
+        return;
+    }
+#endif
+
+    m_Z80.SyncFlags();
+    auto state = getIdleLoopState();
+    int quietCycles = getQuietCycles();
+
+    if ((pc == m_idleLoop.head)
+        && (m_idleLoop.count <= IDLE_LOOP_MAX_INSTRUCTIONS)
+        && (m_idleLoop.sideEffects == m_sideEffects)
+        && (m_idleLoop.state == state))
+    {
+        int loopCycles = 0;
+        for (int i = 0; i < m_idleLoop.count; ++i)
+        {
+            loopCycles += m_idleLoop.cycles[i];
+        }
+
+        //the last pass can only be repeated if it saw the same v counter
+        int passes = 0;
+        if ((loopCycles > 0) && (loopCycles <= m_idleLoop.quietCycles))
+        {
+            passes = quietCycles / loopCycles;
+        }
+
+        if (passes > 0)
+        {
+            int increment = ((context->m_RegisterR - m_idleLoop.registerR) & 0x7F) * passes;
+            context->m_RegisterR = (context->m_RegisterR & 0x80) | ((context->m_RegisterR + increment) & 0x7F);
+
+            addMachineCycles(loopCycles * passes, m_idleLoop.count * passes);
+            quietCycles -= loopCycles * passes;
+        }
+    }
+
+    m_idleLoop.head = pc;
+    m_idleLoop.state = state;
+    m_idleLoop.registerR = context->m_RegisterR;
+    m_idleLoop.quietCycles = quietCycles;
+    m_idleLoop.sideEffects = m_sideEffects;
+    m_idleLoop.count = 0;
+}
+
+void Emulator::updatePageTables()
+{
+    const BYTE* bankPages[] = { &m_firstBankPage, &m_secondBankPage, &m_thirdBankPage };
+
+    for (int i = 0; i < PAGE_COUNT; ++i)
+    {
+        unsigned int addr = i * PAGE_SIZE;
+        unsigned int slot = addr / 0x4000;
+
+        if (addr >= 0xC000)
+        {
+            // 0xE000-0xFFFF mirrors 0xC000-0xDFFF so both halves are stored in the lower one
+            m_readPages[i] = &m_internalMemory[0xC000 + (addr & 0x1FFF)];
+            m_writePages[i] = m_readPages[i];
+        }
+        else if (slot == 2 && m_currentRam > -1)
+        {
+            // ram banking mapped into slot 2
+            m_readPages[i] = &m_ramBank[m_currentRam][addr - 0x8000];
+            m_writePages[i] = m_readPages[i];
+        }
+        else
+        {
+            // the fixed memory address
+            if (!m_isCodeMasters && (addr < 0x400))
+            {
+                m_readPages[i] = &m_internalMemory[addr];
+            }
+            else
+            {
+                unsigned int bankaddr = (addr - (0x4000 * slot)) + (0x4000 * (*bankPages[slot]));
+                m_readPages[i] = &m_cartridgeMemory[bankaddr];
+            }
+
+            // cant write to rom
+            m_writePages[i] = m_romWriteSink.data();
+        }
+    }
+
+    // paging registers
+    m_writePages[0xFFFC >> PAGE_SHIFT] = nullptr;
+    if (m_isCodeMasters)
+    {
+        m_writePages[0x0000 >> PAGE_SHIFT] = nullptr;
+        m_writePages[0x4000 >> PAGE_SHIFT] = nullptr;
+        m_writePages[0x8000 >> PAGE_SHIFT] = nullptr;
+    }
+
+#ifdef Z80_BLOCK_CACHE
+    for (int i = 0; i < PAGE_COUNT; ++i)
+    {
+        if (std::find(m_codePages.begin(), m_codePages.end(), m_readPages[i]) != m_codePages.end())
+        {
+            m_writePages[i] = nullptr;
+        }
+    }
+#endif
+#ifdef Z80_DEBUGGER
+    updateWatchedPages();
+#endif
+}
+
+#ifdef Z80_BLOCK_CACHE
+bool Emulator::protectCode(WORD address)
+{
+    // rom can't change underneath the decoded code
+    bool isRam = (address >= 0xC000) || (address >= 0x8000 && m_currentRam > -1);
+    if (!isRam)
+    {
+        return false;
+    }
+
+    const BYTE* page = m_readPages[address >> PAGE_SHIFT];
+    if (std::find(m_codePages.begin(), m_codePages.end(), page) == m_codePages.end())
+    {
+        m_codePages.push_back(page);
+        watchCodePage(page, true);
+    }
+    return true;
+}
+
+void Emulator::watchCodePage(const BYTE* page, bool watch)
+{
+    // ram is always written through its read page, bar the paging registers
+    for (int i = 0; i < PAGE_COUNT; ++i)
+    {
+        if (m_readPages[i] == page)
+        {
+            bool isRegister = (i == (0xFFFC >> PAGE_SHIFT)) || (m_isCodeMasters && i < (0xC000 >> PAGE_SHIFT) && (i & 0xF) == 0);
+#ifdef Z80_DEBUGGER
+            isRegister = isRegister || m_watchWritePages[i];
+#endif
+            m_writePages[i] = (watch || isRegister) ? nullptr : m_readPages[i];
+        }
+    }
+}
+#endif
+
+#if defined(Z80_PROFILER) || defined(Z80_RECOMPILED)
+int Emulator::getBank(WORD address) const
+{
+    // the 16KB rom bank the address is currently paged to, or -1 for ram
+    int offset = getRomOffset(address);
+    return (offset < 0) ? -1 : offset / 0x4000;
+}
+#endif
+
+#ifdef Z80_RECOMPILED
+namespace
+{
+#ifdef _WIN32
+    const char* RECOMPILED_EXTENSION = ".dll";
+
+    void* openLibrary(const std::string& path)
+    {
+        return LoadLibraryA(path.c_str());
+    }
+
+    void* findSymbol(void* library, const char* name)
+    {
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), name));
+    }
+
+    void closeLibrary(void* library)
+    {
+        FreeLibrary(static_cast<HMODULE>(library));
+    }
+#else
+    const char* RECOMPILED_EXTENSION = ".so";
+
+    void* openLibrary(const std::string& path)
+    {
+        // without a slash dlopen() searches the library path rather than here
+        std::string local = (path.find('/') == std::string::npos) ? "./" + path : path;
+        return dlopen(local.c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+
+    void* findSymbol(void* library, const char* name)
+    {
+        return dlsym(library, name);
+    }
+
+    void closeLibrary(void* library)
+    {
+        dlclose(library);
+    }
+#endif
+}
+
+void Emulator::loadRecompiledRom(const char* path)
+{
+    // sms-recompile's output for game.sms is built into game.sms.so, or
+    // game.sms.dll on windows. Most roms won't have one
+    unloadRecompiledRom();
+
+    std::string libraryPath = std::string(path) + RECOMPILED_EXTENSION;
+    void* library = openLibrary(libraryPath);
+    if (library == nullptr)
+    {
+        return;
+    }
+
+    char buffer[512];
+    const auto* rom = static_cast<const Z80RecompiledRom*>(findSymbol(library, Z80RECOMPILED_SYMBOL));
+    if ((rom == nullptr) || (rom->version != Z80RECOMPILED_VERSION))
+    {
+        snprintf(buffer, sizeof(buffer), "%s was built for a different version of the emulator, not using it", libraryPath.c_str());
+        LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+        closeLibrary(library);
+        return;
+    }
+
+    if (rom->checksum != Z80RecompiledChecksum(m_cartridgeMemory.data(), m_cartridgeMemory.size()))
+    {
+        snprintf(buffer, sizeof(buffer), "%s was built from a different rom, not using it", libraryPath.c_str());
+        LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+        closeLibrary(library);
+        return;
+    }
+
+    m_recompiledLibrary = library;
+    m_Z80.SetRecompiledRom(rom);
+
+    snprintf(buffer, sizeof(buffer), "Using %zu recompiled blocks from %s", rom->count, libraryPath.c_str());
+    LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+}
+
+void Emulator::unloadRecompiledRom()
+{
+    m_Z80.SetRecompiledRom(nullptr);
+    if (m_recompiledLibrary != nullptr)
+    {
+        closeLibrary(m_recompiledLibrary);
+        m_recompiledLibrary = nullptr;
+    }
+}
+#endif
+
+#ifdef Z80_DEBUGGER
+void Emulator::addWatchpoint(WORD start, WORD end, int access)
+{
+    m_Z80.GetDebugger().addWatchpoint(start, end, access);
+    updatePageTables();
+}
+
+void Emulator::removeWatchpoint(std::size_t index)
+{
+    m_Z80.GetDebugger().removeWatchpoint(index);
+    updatePageTables();
+}
+
+void Emulator::updateWatchedPages()
+{
+    // called at the end of updatePageTables()
+    const auto& debugger = m_Z80.GetDebugger();
+    for (int i = 0; i < PAGE_COUNT; ++i)
+    {
+        WORD start = static_cast<WORD>(i * PAGE_SIZE);
+        int access = debugger.getWatchedAccess(start, start + (PAGE_SIZE - 1));
+
+        m_watchReadPages[i] = (access & Z80Debugger::Access::Read) ? nullptr : m_readPages[i];
+        m_watchWritePages[i] = (access & Z80Debugger::Access::Write) != 0;
+        if (m_watchWritePages[i])
+        {
+            m_writePages[i] = nullptr;
+        }
+    }
+}
+
+BYTE Emulator::readMemorySlow(WORD address)
+{
+    m_Z80.GetDebugger().checkWatchpoint(address, Z80Debugger::Access::Read);
+    return m_readPages[address >> PAGE_SHIFT][address & (PAGE_SIZE - 1)];
+}
+#endif
+
+void Emulator::writeMemorySlow(WORD address, BYTE data)
+{
+#ifdef Z80_DEBUGGER
+    if (m_watchWritePages[address >> PAGE_SHIFT])
+    {
+        m_Z80.GetDebugger().checkWatchpoint(address, Z80Debugger::Access::Write);
+    }
+#endif
+
+#ifdef Z80_BLOCK_CACHE
+    // first write to a page of ram holding decoded code
+    const BYTE* page = m_readPages[address >> PAGE_SHIFT];
+    auto codePage = std::find(m_codePages.begin(), m_codePages.end(), page);
+    if (codePage != m_codePages.end())
+    {
+        m_codePages.erase(codePage);
+        m_Z80.InvalidateCode(page, PAGE_SIZE);
+        watchCodePage(page, false);
+
+        BYTE* writePage = m_writePages[address >> PAGE_SHIFT];
+        if (writePage != nullptr)
+        {
+            writePage[address & (PAGE_SIZE - 1)] = data;
+            return;
+        }
+    }
+#endif
+
+    if (address >= 0xC000)
+    {
+        m_internalMemory[0xC000 + (address & 0x1FFF)] = data;
+
+        if (address >= 0xFFFC)
+        {
+            m_internalMemory[address] = data;
+            if (!m_isCodeMasters)
+            {
+                doMemPage(address, data);
+            }
+        }
+        return;
+    }
+
+    if (m_isCodeMasters && ((address & 0x3FFF) == 0))
+    {
+        doMemPageCM(address, data);
+        return;
+    }
+
+    // only allow writing to here if a ram bank is mapped into this slot
+    if (address >= 0x8000 && m_currentRam > -1)
+    {
+        m_ramBank[m_currentRam][address - 0x8000] = data;
     }
 }
\ No newline at end of file
@@ -31,20 +31,38 @@
 
 #include <memory>
 #include <array>
+#include <limits>
+#include <algorithm>
+#include <vector>
 
 class Emulator final
 {
 public:
     Emulator();
 
+    //the page tables point into this emulator's own memory and the cpu
+    //holds a reference to it as its bus, so a copy would still be using
+    //the original. Create another and insert the same cartridge instead
+    Emulator(const Emulator&) = delete;
+    Emulator(Emulator&&) = delete;
+    Emulator& operator=(const Emulator&) = delete;
+    Emulator& operator=(Emulator&&) = delete;
+
     static Emulator* createInstance();
     static Emulator* getSingleton();
 
     void reset();
     void insertCartridge(const char* path);
     void update();
+#ifdef Z80_WIDE
+    //updates each of the emulators by a frame as update() would, with their
+    //cpus run in lockstep while they're at the same place in the same rom.
+    //Returns the instructions which ran in lockstep, once for each emulator
+    static unsigned long long updateLockstep(Emulator* const* emulators, std::size_t count);
+#endif
 
     BYTE readMemory(const WORD& address);
+    BYTE peekMemory(WORD address) const;
     void writeMemory(const WORD& address, const BYTE& data);
     BYTE readIOMemory(const BYTE& address);
     void writeIOMemory(const BYTE& address, const BYTE& data);
@@ -55,8 +73,39 @@ public:
     void setKeyReleased(int player, int key);
     void resetButton();
     void dumpClockInfo();
+    unsigned long long getInstructionCount() const { return m_instructionCount; }
+    unsigned long long getClock() const { return m_clock; }
     void setGFXOpt(bool useGFXOpt) { m_graphicsChip.setGFXOpt(useGFXOpt); }
-    void checkInterupts();
+
+    int getQuietCycles();
+    int getBlockRepeatLimit(int cycles);
+    void addBlockCycles(int cycles, int count);
+    void addCycles(const BYTE* cycles, int count);
+    bool addInstructionCycles(int cycles);
+    void interuptPending() { scheduleEvent(Event::Interupt, m_clock); }
+    bool isBlockIOPort(BYTE address) const;
+    void writeIOBlock(BYTE address, const BYTE* data, int count, int cycles);
+#ifdef Z80_BLOCK_CACHE
+    const BYTE* getReadPointer(WORD address) const;
+    bool protectCode(WORD address);
+#endif
+#if defined(Z80_PROFILER) || defined(Z80_RECOMPILED)
+    int getBank(WORD address) const;
+    int getRomOffset(WORD address) const;
+#endif
+#ifdef Z80_PROFILER
+    Z80Profiler& getProfiler() { return m_Z80.GetProfiler(); }
+#endif
+#ifdef Z80_TRACE
+    Z80Trace& getTrace() { return m_Z80.GetTrace(); }
+#endif
+#ifdef Z80_DEBUGGER
+    Z80Debugger& getDebugger() { return m_Z80.GetDebugger(); }
+    const CONTEXTZ80& getCPUState() { m_Z80.SyncFlags(); return *m_Z80.GetContext(); }
+    // these go through here so the watched pages can be updated
+    void addWatchpoint(WORD start, WORD end, int access);
+    void removeWatchpoint(std::size_t index);
+#endif
 
 
     static constexpr long long MACHINE_CLICKS = 10738635;
@@ -70,21 +119,229 @@ private:
     TMS9918A m_graphicsChip;
     SN79489 m_soundChip;
 
-    Z80 m_Z80;
+    Z80<Emulator> m_Z80;
 
     BYTE m_ramBank[0x2][0x4000];
 
+    // kept on the heap so the emulator itself stays small
+    static constexpr std::size_t CARTRIDGE_SIZE = 0x100000;
+    std::vector<BYTE> m_cartridgeMemory = std::vector<BYTE>(CARTRIDGE_SIZE);
+    std::vector<BYTE> m_internalMemory = std::vector<BYTE>(0x10000);
+
     std::array<BYTE, 2u> m_keyboardPorts = {};
     bool m_isPAL;
     bool m_isCodeMasters;
     bool m_oneMegCartridge;
     unsigned long int m_clockInfo;
+    unsigned long long m_instructionCount;
     BYTE m_firstBankPage;
     BYTE m_secondBankPage;
     BYTE m_thirdBankPage;
     int m_currentRam;
 
+    // the address space is mapped in 1KB pages which point directly at
+    // the memory currently banked in. These are rebuilt on every bank
+    // switch. A null write page means the write has to be handled by
+    // writeMemorySlow(), ie the mapper registers.
+    static constexpr WORD PAGE_SHIFT = 10;
+    static constexpr WORD PAGE_SIZE = 1 << PAGE_SHIFT;
+    static constexpr WORD PAGE_COUNT = 0x10000 >> PAGE_SHIFT;
+    std::array<BYTE*, PAGE_COUNT> m_readPages = {};
+    std::array<BYTE*, PAGE_COUNT> m_writePages = {};
+    std::array<BYTE, PAGE_SIZE> m_romWriteSink = {};
+#ifdef Z80_BLOCK_CACHE
+    // ram pages which the Z80 has decoded code from. Their write pages
+    // are kept null so the first write lands in writeMemorySlow()
+    std::vector<const BYTE*> m_codePages;
+#endif
+#ifdef Z80_RECOMPILED
+    // the library which sms-recompile's output for the rom was built into
+    void* m_recompiledLibrary = nullptr;
+    void loadRecompiledRom(const char* path);
+    void unloadRecompiledRom();
+#endif
+#ifdef Z80_DEBUGGER
+    // reads go through these rather than m_readPages, which stays as the
+    // memory map. Pages holding a read watchpoint are null so they land in
+    // readMemorySlow(), and those holding a write watchpoint have a null
+    // write page in the same way as the paging registers
+    std::array<BYTE*, PAGE_COUNT> m_watchReadPages = {};
+    std::array<bool, PAGE_COUNT> m_watchWritePages = {};
+    void updateWatchedPages();
+    BYTE readMemorySlow(WORD address);
+    // set when update() returned with the debugger paused part way through a frame
+    bool m_midFrame = false;
+#endif
+
     bool isCodeMasters();
     void doMemPage(WORD address, BYTE data);
     void doMemPageCM(WORD address, BYTE data);
-};
\ No newline at end of file
+    void updatePageTables();
+    void addMachineCycles(int cycles, int instructions);
+    void skipHaltedCycles();
+    void finishCpuSlice();
+    void flushCycles();
+    void flushSound();
+    void updateInteruptLine() { m_Z80.SetInteruptLine(InteruptLine::IRQ, m_graphicsChip.isRequestingInterupt()); }
+
+    // the cpu clock, counted in cpu cycles since reset. The vdp and psg
+    // are only brought up to it when something needs them to be
+    unsigned long long m_clock = 0;
+    unsigned long long m_graphicsClock = 0;
+    unsigned long long m_soundClock = 0;
+
+    // the points on m_clock which the cpu can't run past without update()
+    // stepping in. Line interrupts and vblank are only raised at the end
+    // of a line, so once raised they are due straight away. An interrupt
+    // the cpu isn't accepting has no event until EI or RETN lets it through
+    struct Event final
+    {
+        enum
+        {
+            EndOfLine,
+            Interupt,
+            Sound,
+
+            Count
+        };
+    };
+    static constexpr unsigned long long NEVER = std::numeric_limits<unsigned long long>::max();
+    // the psg is caught up at least this often so the sampler never has much to do at once
+    static constexpr int SOUND_SYNC_CYCLES = 0x1000;
+    std::array<unsigned long long, Event::Count> m_events = {};
+    unsigned long long m_nextEvent = 0;
+
+    void scheduleEvents();
+    void scheduleEvent(int event, unsigned long long time);
+
+    // a loop which polls memory or the v counter without changing anything
+    // can be skipped up to the next line or interrupt, see checkIdleLoop()
+    static constexpr int IDLE_LOOP_MAX_INSTRUCTIONS = 16;
+    static constexpr WORD IDLE_LOOP_MAX_SIZE = 0x40;
+    using IdleLoopState = std::array<WORD, 13>;
+    struct IdleLoop final
+    {
+        WORD head = 0;
+        IdleLoopState state = {};
+        BYTE registerR = 0;
+        int quietCycles = 0;
+        unsigned int sideEffects = 0;
+        int count = IDLE_LOOP_MAX_INSTRUCTIONS + 1;
+        std::array<BYTE, IDLE_LOOP_MAX_INSTRUCTIONS> cycles = {};
+    }m_idleLoop;
+
+    // counts anything the cpu does which might change what a loop reads
+    unsigned int m_sideEffects = 0;
+
+    void countIdleLoopCycles(int cycles);
+    IdleLoopState getIdleLoopState();
+    void checkIdleLoop();
+#ifdef Z80_BLOCK_CACHE
+    void watchCodePage(const BYTE* page, bool watch);
+#endif
+    void writeMemorySlow(WORD address, BYTE data);
+};
+
+inline void Emulator::countIdleLoopCycles(int cycles)
+{
+    if (m_idleLoop.count < IDLE_LOOP_MAX_INSTRUCTIONS)
+    {
+        m_idleLoop.cycles[m_idleLoop.count] = static_cast<BYTE>(cycles);
+    }
+    ++m_idleLoop.count;
+}
+
+inline void Emulator::addMachineCycles(int cycles, int instructions)
+{
+    //the vdp catches up in flushCycles() and the psg in flushSound()
+    m_clock += cycles;
+    m_instructionCount += instructions;
+}
+
+inline int Emulator::getQuietCycles()
+{
+    //the number of cpu cycles which can be run before update() would have
+    //to do anything other than count them, ie the next scheduled event
+    return (m_nextEvent > m_clock) ? static_cast<int>(m_nextEvent - m_clock) : 0;
+}
+
+inline void Emulator::scheduleEvent(int event, unsigned long long time)
+{
+    m_events[event] = time;
+    m_nextEvent = std::min(m_nextEvent, time);
+}
+
+inline bool Emulator::addInstructionCycles(int cycles)
+{
+    //called by Z80::Run() after each instruction. Returns false
+    //once the next event is due and update() needs to step in
+    countIdleLoopCycles(cycles);
+    addMachineCycles(cycles, 1);
+    checkIdleLoop();
+    return m_clock < m_nextEvent;
+}
+
+#if defined(Z80_PROFILER) || defined(Z80_RECOMPILED)
+inline int Emulator::getRomOffset(WORD address) const
+{
+    // where the address currently is in the rom, or -1 for ram
+    const BYTE* page = m_readPages[address >> PAGE_SHIFT];
+    const BYTE* rom = m_cartridgeMemory.data();
+    if (page >= rom && page < rom + m_cartridgeMemory.size())
+    {
+        return static_cast<int>(page - rom) + (address & (PAGE_SIZE - 1));
+    }
+    // the first 1KB is a copy of bank 0 held in internal memory
+    return (address < 0x400) ? address : -1;
+}
+#endif
+
+inline BYTE Emulator::readMemory(const WORD& address)
+{
+#ifdef Z80_PROFILER
+    if (m_Z80.GetProfiler().isEnabled())
+    {
+        m_Z80.GetProfiler().addRead(getRomOffset(address));
+    }
+#endif
+
+#ifdef Z80_DEBUGGER
+    const BYTE* page = m_watchReadPages[address >> PAGE_SHIFT];
+    if (page == nullptr)
+    {
+        return readMemorySlow(address);
+    }
+    return page[address & (PAGE_SIZE - 1)];
+#else
+    return m_readPages[address >> PAGE_SHIFT][address & (PAGE_SIZE - 1)];
+#endif
+}
+
+inline BYTE Emulator::peekMemory(WORD address) const
+{
+    //the cpu looking at code rather than reading it, which neither the
+    //debugger nor the profiler should see
+    return m_readPages[address >> PAGE_SHIFT][address & (PAGE_SIZE - 1)];
+}
+
+#ifdef Z80_BLOCK_CACHE
+inline const BYTE* Emulator::getReadPointer(WORD address) const
+{
+    return &m_readPages[address >> PAGE_SHIFT][address & (PAGE_SIZE - 1)];
+}
+#endif
+
+inline void Emulator::writeMemory(const WORD& address, const BYTE& data)
+{
+    ++m_sideEffects;
+
+    BYTE* page = m_writePages[address >> PAGE_SHIFT];
+    if (page != nullptr)
+    {
+        page[address & (PAGE_SIZE - 1)] = data;
+    }
+    else
+    {
+        writeMemorySlow(address, data);
+    }
+}
\ No newline at end of file
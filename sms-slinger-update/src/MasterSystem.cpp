@@ -41,6 +41,7 @@
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <cstdlib>
 
 namespace
 {
@@ -785,6 +786,30 @@ void MasterSystem::doImGui()
                     }
                 }
 
+#ifdef Z80_PROFILER
+                auto& profiler = m_emulator->getProfiler();
+                if (ImGui::MenuItem("Profile", nullptr, profiler.isEnabled()))
+                {
+                    profiler.setEnabled(!profiler.isEnabled());
+                }
+
+                if (ImGui::MenuItem("Save Profile", nullptr, nullptr, !m_currentRom.empty()))
+                {
+                    //written next to the rom, in the same way as the benchmark
+                    profiler.writeReport(m_currentRom + ".profile.txt");
+                    profiler.writeCSV(m_currentRom + ".profile.csv");
+                    profiler.writeCoverage(m_currentRom + ".coverage.bin");
+                }
+#endif
+
+#ifdef Z80_TRACE
+                if (ImGui::MenuItem("Save Trace", nullptr, nullptr, !m_currentRom.empty()))
+                {
+                    //read back with sms-trace-decode
+                    m_emulator->getTrace().write(m_currentRom + ".trace.bin");
+                }
+#endif
+
                 if (ImGui::MenuItem("Quit", "ALT+F4", nullptr))
                 {
                     m_running = false;
@@ -804,6 +829,9 @@ void MasterSystem::doImGui()
                 }
 
                 ImGui::MenuItem("Shader Editor", nullptr, &m_showEditor);
+#ifdef Z80_DEBUGGER
+                ImGui::MenuItem("Debugger", nullptr, &m_showDebugger);
+#endif
                 
                 if (ImGui::MenuItem("Hide UI", "Esc, Ins", nullptr))
                 {
@@ -961,6 +989,14 @@ void MasterSystem::doImGui()
     {
         shaderEditor();
     }
+
+#ifdef Z80_DEBUGGER
+    //always shown while paused as the emulator won't carry on without it
+    if (m_showDebugger || m_emulator->getDebugger().isPaused())
+    {
+        debugger();
+    }
+#endif
 }
 
 void MasterSystem::browseRom()
@@ -1159,6 +1195,120 @@ void MasterSystem::shaderEditor()
     }
 }
 
+#ifdef Z80_DEBUGGER
+void MasterSystem::debugger()
+{
+    auto& debugger = m_emulator->getDebugger();
+
+    ImGui::SetNextWindowSize({ 300.f, 460.f }, ImGuiCond_FirstUseEver);
+    ImGui::Begin("Debugger", &m_showDebugger);
+
+    if (debugger.isPaused())
+    {
+        static const char* reasons[] = { "Stopped", "Paused", "Breakpoint", "Watchpoint", "Step" };
+        ImGui::Text("%s at %04X", reasons[debugger.getReason()], debugger.getAddress());
+
+        if (ImGui::Button("Continue"))
+        {
+            debugger.resume();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Step"))
+        {
+            debugger.step();
+        }
+    }
+    else
+    {
+        ImGui::Text("Running");
+        if (ImGui::Button("Pause"))
+        {
+            debugger.pause();
+        }
+    }
+
+    const auto& cpu = m_emulator->getCPUState();
+    ImGui::NewLine();
+    ImGui::Text("PC %04X  SP %04X", cpu.m_ProgramCounter, cpu.m_StackPointer.reg);
+    ImGui::Text("AF %04X  BC %04X", cpu.m_RegisterAF.reg, cpu.m_RegisterBC.reg);
+    ImGui::Text("DE %04X  HL %04X", cpu.m_RegisterDE.reg, cpu.m_RegisterHL.reg);
+    ImGui::Text("IX %04X  IY %04X", cpu.m_RegisterIX.reg, cpu.m_RegisterIY.reg);
+    ImGui::Text("I  %02X    R  %02X    IFF %d  IM %d", cpu.m_RegisterI, cpu.m_RegisterR, cpu.m_IFF1, cpu.m_InteruptMode);
+
+    //addresses are typed in as hex
+    const auto parseAddress = [](const char* str)
+    {
+        return static_cast<WORD>(std::strtoul(str, nullptr, 16));
+    };
+
+    ImGui::NewLine();
+    ImGui::Text("Breakpoints");
+    static char breakAddress[5] = {};
+    ImGui::SetNextItemWidth(60.f);
+    ImGui::InputText("##break", breakAddress, sizeof(breakAddress), ImGuiInputTextFlags_CharsHexadecimal);
+    ImGui::SameLine();
+    if (ImGui::Button("Add##break") && breakAddress[0] != 0)
+    {
+        debugger.addBreakpoint(parseAddress(breakAddress));
+    }
+
+    for (auto address : debugger.getBreakpoints())
+    {
+        ImGui::PushID(address);
+        ImGui::Text("%04X", address);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Remove"))
+        {
+            debugger.removeBreakpoint(address);
+        }
+        ImGui::PopID();
+    }
+
+    ImGui::NewLine();
+    ImGui::Text("Watchpoints");
+    static char watchStart[5] = {};
+    static char watchEnd[5] = {};
+    static bool watchRead = false;
+    static bool watchWrite = true;
+    ImGui::SetNextItemWidth(60.f);
+    ImGui::InputText("##start", watchStart, sizeof(watchStart), ImGuiInputTextFlags_CharsHexadecimal);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(60.f);
+    ImGui::InputText("##end", watchEnd, sizeof(watchEnd), ImGuiInputTextFlags_CharsHexadecimal);
+    ImGui::Checkbox("Read", &watchRead);
+    ImGui::SameLine();
+    ImGui::Checkbox("Write", &watchWrite);
+    ImGui::SameLine();
+    if (ImGui::Button("Add##watch") && watchStart[0] != 0 && (watchRead || watchWrite))
+    {
+        WORD start = parseAddress(watchStart);
+        WORD end = (watchEnd[0] != 0) ? parseAddress(watchEnd) : start;
+        int access = (watchRead ? Z80Debugger::Access::Read : 0) | (watchWrite ? Z80Debugger::Access::Write : 0);
+        m_emulator->addWatchpoint(start, end, access);
+    }
+
+    const auto& watchpoints = debugger.getWatchpoints();
+    for (std::size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        const auto& watchpoint = watchpoints[i];
+        ImGui::PushID(static_cast<int>(i));
+        ImGui::Text("%04X-%04X %s%s", watchpoint.start, watchpoint.end,
+            (watchpoint.access & Z80Debugger::Access::Read) ? "R" : "",
+            (watchpoint.access & Z80Debugger::Access::Write) ? "W" : "");
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Remove"))
+        {
+            m_emulator->removeWatchpoint(i);
+            ImGui::PopID();
+            break;
+        }
+        ImGui::PopID();
+    }
+
+    ImGui::End();
+}
+#endif
+
 void MasterSystem::uiTimeout()
 {
     if (m_showOptions || m_showEditor)
@@ -64,6 +64,10 @@ private:
     bool m_running;
     std::string m_currentRom;
 
+#ifdef Z80_DEBUGGER
+    bool m_showDebugger = false;
+#endif
+
     TextEditor m_textEditor;
     std::string m_currentShaderPath;
 
@@ -101,6 +105,9 @@ private:
 
     void browseRom();
     void shaderEditor();
+#ifdef Z80_DEBUGGER
+    void debugger();
+#endif
     void uiTimeout();
 
     void loadSettings();
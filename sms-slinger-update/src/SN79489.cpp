@@ -163,6 +163,18 @@ void SN79489::writeData(BYTE data)
     }
 }
 
+void SN79489::writeDataBlock(const BYTE* data, std::size_t size, int cyclesBetween)
+{
+    //a run of writes such as an OTIR to the psg, each one arriving
+    //cyclesBetween after the last so the output is the same as
+    //interleaving writeData() and update() one byte at a time
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        update(cyclesBetween);
+        writeData(data[i]);
+    }
+}
+
 void SN79489::reset()
 {
     std::fill(m_buffer.begin(), m_buffer.end(), 0.f);
@@ -272,7 +284,9 @@ void SN79489::update(int cyclesMac)
         m_sampler.push(tone);
     }
 
-    if (m_sampler.pending())
+    //the emulator may run many instructions between updates so take
+    //everything the sampler has ready, not just the one sample
+    while (m_sampler.pending())
     {
         m_buffer[m_currentBufferPos] = static_cast<float>(m_sampler.pop()) * m_mixerVolumes[MixerChannel::Master];   
         m_currentBufferPos = (m_currentBufferPos + 1) % BUFFERSIZE;      
@@ -29,6 +29,7 @@
 #include "HiResTimer.hpp"
 
 #include <vector>
+#include <cstddef>
 #include <array>
 #include <cstdint>
 
@@ -41,6 +42,7 @@ public:
     SN79489();
 
     void writeData(BYTE data);
+    void writeDataBlock(const BYTE* data, std::size_t size, int cyclesBetween);
     void reset();
     void update(int cycles);
     void audioCallback(std::uint8_t*, std::int32_t);
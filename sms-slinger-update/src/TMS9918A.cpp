@@ -27,6 +27,7 @@
 #include "TMS9918A.hpp"
 #include "LogMessages.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -90,20 +91,21 @@ void TMS9918A::update(int cycles)
 {
     m_requestInterrupt = testBit(m_status, 7) && isRegBitSet(1, 5);
 
-    WORD hcount = m_HCounter;
     bool nextline = false;
     m_isVBlank = false;
     m_refresh = false;
 
 
-    //are we moving off this scanline onto the next?
-    if ((hcount + cycles) > MACHINE_CLICKS_PER_SCANLINE)
+    //are we moving off this scanline onto the next? The emulator updates
+    //at least once a line (see getCyclesToNextLine()) so at most one is crossed
+    m_HCounter += cycles;
+    if (m_HCounter > MACHINE_CLICKS_PER_SCANLINE)
     {
         nextline = true;
+        m_HCounter -= (MACHINE_CLICKS_PER_SCANLINE + 1);
+        assert(m_HCounter <= MACHINE_CLICKS_PER_SCANLINE);
     }
 
-    m_HCounter = (m_HCounter + cycles) % (MACHINE_CLICKS_PER_SCANLINE + 1);
-
     //TODO this should only be updated half as often as the incoming number
     //of cycles - although I can't see where they're actually counted?
 
@@ -322,6 +324,41 @@ void TMS9918A::writeDataPort(BYTE data)
     incrementAddress();
 }
 
+void TMS9918A::writeDataPortBlock(const BYTE* data, std::size_t size)
+{
+    //the same as calling writeDataPort() for each byte, but the code
+    //register is only decoded once and VRAM is written in runs
+    if (size == 0)
+    {
+        return;
+    }
+
+    m_isSecondControlWrite = false;
+    m_readBuffer = data[size - 1];
+
+    if (getCodeRegister() == 3)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            m_CRAM[getAddressRegister() & 31] = data[i];
+            incrementAddress();
+        }
+        return;
+    }
+
+    while (size != 0)
+    {
+        //the address wraps at the end of VRAM without touching the code
+        WORD address = getAddressRegister();
+        std::size_t count = std::min(size, m_VRAM.size() - address);
+        std::memcpy(&m_VRAM[address], data, count);
+
+        m_controlWord = (m_controlWord & 0xC000) | ((address + count) & 0x3FFF);
+        data += count;
+        size -= count;
+    }
+}
+
 BYTE TMS9918A::getStatus()
 {
     BYTE res = m_status;
@@ -363,6 +400,13 @@ BYTE TMS9918A::getHCounter() const
     return res;
 }
 
+int TMS9918A::getCyclesToNextLine() const
+{
+    //how many cycles can be passed to update() without it doing anything
+    //other than moving the h counter along
+    return MACHINE_CLICKS_PER_SCANLINE - m_HCounter;
+}
+
 bool TMS9918A::getRefresh()
 {
     if (m_refresh)
@@ -967,7 +1011,7 @@ void TMS9918A::renderBackgroundMode4()
     }
 }
 
-bool TMS9918A::isRegBitSet(int reg, BYTE bit)
+bool TMS9918A::isRegBitSet(int reg, BYTE bit) const
 {
     return testBit(m_VDPRegisters[reg], bit);
 }
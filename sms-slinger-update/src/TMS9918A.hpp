@@ -26,6 +26,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 class TMS9918A final
 {
@@ -50,11 +51,13 @@ public:
     void writeVDPAddress(BYTE data);
     BYTE readDataPort();
     void writeDataPort(BYTE data);
+    void writeDataPortBlock(const BYTE* data, std::size_t size);
     BYTE getStatus();
     void resetScreen();
     BYTE getHCounter() const;
     BYTE getVCounter() const { return m_VCounter; }
     bool isRequestingInterupt() const { return m_requestInterrupt; }
+    int getCyclesToNextLine() const;
     WORD getWidth() const { return m_width; }
     WORD getHeight() const { return m_height; }
     bool getRefresh();
@@ -106,7 +109,7 @@ private:
     void renderSpritesMode4();
     void renderBackgroundMode2();
     void renderBackgroundMode4();
-    bool isRegBitSet(int reg, BYTE bit);
+    bool isRegBitSet(int reg, BYTE bit) const;
     void setSpriteOverflow();
     void setSpriteCollision();
     WORD getSATBase() const;
@@ -0,0 +1,907 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Config.hpp"
+#include "Z80.hpp"
+#include "Z80.Opcodes.hpp"
+#include "Z80.Bus.hpp"
+
+#ifdef Z80_BLOCK_CACHE
+
+#include <algorithm>
+#include <cstdint>
+
+// ExecuteNextOpcode() takes its instructions from here. Blocks of straight
+// line code are decoded into micro ops the first time they're reached and
+// then replayed, so the opcode and any immediate data aren't fetched or
+// decoded again. Only the common, simple opcodes get their own handler,
+// everything else is a MICRO_INTERPRET op which runs through ExecuteOpcode()
+// exactly as it would without the cache.
+//
+// Blocks are keyed on the host address of their first byte so the same Z80
+// address in two different rom banks gives two different blocks. When a block
+// is decoded the bus is asked to protectCode() its page. This returns true
+// for ram, after which the first write to that page must call InvalidateCode()
+// before it lands.
+//
+// A few runs of two or three instructions which games spend a lot of time
+// in, such as DEC B / JR NZ,e or IN A,(n) / AND n / JR Z,e, are fused into
+// one op by FuseBlock(). A fused op only runs when none of its instructions
+// but the last can reach the next event, so an interrupt can never land in
+// the middle of it. Otherwise its instructions are run one at a time.
+
+namespace
+{
+    // length in bytes of each unprefixed opcode
+    constexpr BYTE BaseOpcodeLength(int opcode)
+    {
+        switch (opcode)
+        {
+        case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x36: case 0x3E:
+        case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+        case 0xD3: case 0xDB:
+        case 0x10: case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+            return 2;
+        case 0x01: case 0x11: case 0x21: case 0x31: case 0x22: case 0x2A: case 0x32: case 0x3A:
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE2: case 0xEA: case 0xF2: case 0xFA:
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC: case 0xE4: case 0xEC: case 0xF4: case 0xFC:
+            return 3;
+        default:
+            return 1;
+        }
+    }
+
+    // opcodes which end a block, ie anything which can change the PC
+    // other than by moving on to the next instruction, and the prefixes
+    constexpr bool EndsBlock(int opcode)
+    {
+        switch (opcode)
+        {
+        case 0x10: case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE2: case 0xEA: case 0xF2: case 0xFA:
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC: case 0xE4: case 0xEC: case 0xF4: case 0xFC:
+        case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xE0: case 0xE8: case 0xF0: case 0xF8:
+        case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+        case 0xE9: case 0x76:
+        case 0xCB: case 0xDD: case 0xED: case 0xFD:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // same as Z80::IncreaseRReg(), which lives in another translation unit
+    inline void IncreaseR(BYTE& r)
+    {
+        r = (r & 0x80) | ((r + 1) & 0x7F);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::FlushCodeCache()
+{
+    if (m_BlockCache.empty())
+    {
+        m_BlockCache.resize(BLOCK_CACHE_SIZE);
+    }
+
+    for (auto& block : m_BlockCache)
+    {
+        block.source = nullptr;
+        block.inRam = false;
+    }
+    m_RamBlocks.clear();
+    m_Block = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::InvalidateCode(const BYTE* start, std::size_t size)
+{
+    auto removed = std::remove_if(m_RamBlocks.begin(), m_RamBlocks.end(),
+        [start, size](DecodedBlock* block)
+        {
+            if ((block->source >= start) && (block->source < start + size))
+            {
+                // the ops are left alone as one may still be running
+                block->source = nullptr;
+                block->inRam = false;
+                return true;
+            }
+            return false;
+        });
+    m_RamBlocks.erase(removed, m_RamBlocks.end());
+
+    if ((m_Block != nullptr) && (m_Block->source == nullptr))
+    {
+        m_Block = nullptr;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+BYTE Z80<Bus>::ExecuteCachedOpcode(bool batch)
+{
+    // while the bus says that nothing but its counters would change, the
+    // simple ops at the start of the rest of the block are run here rather
+    // than going back round the main loop for each one. The last op always
+    // returns as normal so that interrupts are still taken at its end, as
+    // do jumps so that the bus sees every loop.
+    if (batch && (m_Block != nullptr) && !m_ContextZ80.m_EIPending)
+    {
+        const int budget = m_Bus.getQuietCycles();
+        BYTE cycles[BLOCK_MAX_OPS];
+        int count = 0;
+        int total = 0;
+
+        // a fused op which ends in a jump is left to run as the last op
+        const MicroOp* op = nullptr;
+        while (((op = NextBlockOp()) != nullptr)
+            && (op->handler != &Z80::MICRO_INTERPRET)
+            && !EndsBlock(op->opcode)
+            && ((op->fusion == Fusion::None) || !EndsBlock(op[FUSED_COUNT[op->fusion] - 1].opcode))
+            && (total + op->cycles <= budget))
+        {
+            AdvanceBlock();
+
+            m_ContextZ80.m_ProgramCounterStart = m_ContextZ80.m_ProgramCounter;
+            m_ContextZ80.m_ProgramCounter += op->length;
+#ifdef Z80_PROFILER
+            if (m_Profiler.isEnabled())
+            {
+                ProfileFetch();
+            }
+#endif
+
+            (this->*op->handler)(*op);
+
+#ifdef Z80_PROFILER
+            if (m_Profiler.isEnabled())
+            {
+                ProfileInstruction(m_ContextZ80.m_ProgramCounterStart, op->cycles);
+            }
+#endif
+#ifdef Z80_TRACE
+            TraceInstruction(m_ContextZ80.m_ProgramCounterStart, total + op->cycles);
+#endif
+            cycles[count++] = op->cycles;
+            total += op->cycles;
+        }
+
+        if (count != 0)
+        {
+            m_Bus.addCycles(cycles, count);
+            m_ContextZ80.m_OpcodeCycle = 0;
+        }
+    }
+
+    const MicroOp& op = FetchMicroOp();
+
+    m_ContextZ80.m_ProgramCounterStart = m_ContextZ80.m_ProgramCounter;
+    m_ContextZ80.m_ProgramCounter += op.length;
+#ifdef Z80_PROFILER
+    if (m_Profiler.isEnabled())
+    {
+        ProfileFetch();
+    }
+#endif
+
+    if (batch && (op.fusion != Fusion::None) && !m_ContextZ80.m_EIPending
+        && (op.fusedCycles < m_Bus.getQuietCycles()))
+    {
+        ExecuteFused(op);
+        return (&op)[FUSED_COUNT[op.fusion] - 1].opcode;
+    }
+
+    (this->*op.handler)(op);
+    return op.opcode;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+inline const typename Z80<Bus>::MicroOp* Z80<Bus>::NextBlockOp() const
+{
+    // the current block carries on as long as nothing has jumped away
+    // or changed the memory map since the last op
+    if (m_Block != nullptr)
+    {
+        WORD pc = m_ContextZ80.m_ProgramCounter;
+        const MicroOp& op = m_Block->ops[m_BlockIndex];
+        if ((pc == static_cast<WORD>(m_BlockStart + op.offset))
+            && (m_Bus.getReadPointer(pc) == m_Block->source + op.offset))
+        {
+            return &op;
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+inline void Z80<Bus>::AdvanceBlock()
+{
+    if (++m_BlockIndex == m_Block->count)
+    {
+        m_Block = nullptr;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+inline const typename Z80<Bus>::MicroOp& Z80<Bus>::FetchMicroOp()
+{
+    const MicroOp* next = NextBlockOp();
+    if (next != nullptr)
+    {
+        AdvanceBlock();
+        return *next;
+    }
+
+    WORD pc = m_ContextZ80.m_ProgramCounter;
+    const BYTE* source = m_Bus.getReadPointer(pc);
+    auto hash = reinterpret_cast<std::uintptr_t>(source);
+    hash ^= hash >> 11;
+    DecodedBlock& block = m_BlockCache[hash & (BLOCK_CACHE_SIZE - 1)];
+
+    if (block.source != source)
+    {
+        DecodeBlock(block, source);
+    }
+
+    m_BlockStart = pc;
+    if (block.count > 1)
+    {
+        m_Block = &block;
+        m_BlockIndex = 1;
+    }
+    else
+    {
+        m_Block = nullptr;
+    }
+    return block.ops[0];
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::DecodeBlock(DecodedBlock& block, const BYTE* source)
+{
+    WORD start = m_ContextZ80.m_ProgramCounter;
+    WORD spanEnd = (start & ~(BLOCK_SPAN - 1)) + BLOCK_SPAN;
+    WORD pc = start;
+
+    block.source = source;
+    block.count = 0;
+
+    bool done = false;
+    while (!done)
+    {
+        MicroOp& op = block.ops[block.count++];
+        BYTE opcode = m_Bus.peekMemory(pc);
+
+        op.handler = &Z80::MICRO_INTERPRET;
+        op.dst = nullptr;
+        op.src = nullptr;
+        op.pair = nullptr;
+        op.operand = 0;
+        op.opcode = opcode;
+        op.length = BaseOpcodeLength(opcode);
+        // conditional jumps are counted as taken so that anything checking
+        // the budget for a run of ops never underestimates it
+        op.cycles = Z80CYCLES.Main.taken[opcode];
+        op.offset = static_cast<BYTE>(pc - start);
+        op.fusion = Fusion::None;
+        op.fusedCycles = 0;
+
+        // an instruction which runs off the end of the span is left to the
+        // interpreter as its operands might be somewhere else by the time it runs
+        unsigned int end = pc + op.length;
+        bool fits = (pc >= start) && (end <= static_cast<unsigned int>(spanEnd ? spanEnd : 0x10000));
+        if (fits && (op.length > 1))
+        {
+            op.operand = m_Bus.peekMemory(pc + 1);
+            if (op.length == 3)
+            {
+                op.operand |= m_Bus.peekMemory(pc + 2) << 8;
+            }
+        }
+
+        int dst = (opcode >> 3) & 7;
+        int src = opcode & 7;
+
+        if (!fits)
+        {
+            // leave it to the interpreter
+        }
+        else if (opcode == 0x00)
+        {
+            op.handler = &Z80::MICRO_NOP;
+        }
+        else if ((opcode >= 0x40) && (opcode < 0x80) && (opcode != 0x76))
+        {
+            if (src == 6)
+            {
+                op.handler = &Z80::MICRO_LOAD_FROM_HL;
+                op.dst = GetRegister8(dst);
+            }
+            else if (dst == 6)
+            {
+                op.handler = &Z80::MICRO_STORE_TO_HL;
+                op.src = GetRegister8(src);
+            }
+            else
+            {
+                op.handler = &Z80::MICRO_LOAD;
+                op.dst = GetRegister8(dst);
+                op.src = GetRegister8(src);
+            }
+        }
+        else if (((opcode & 0xC7) == 0x06) && (dst != 6))
+        {
+            op.handler = &Z80::MICRO_LOAD_IMMEDIATE;
+            op.dst = GetRegister8(dst);
+        }
+        else if ((opcode & 0xCF) == 0x01)
+        {
+            op.handler = &Z80::MICRO_16BIT_LOAD;
+            op.pair = GetRegister16(opcode >> 4);
+        }
+        else if ((opcode & 0xC7) == 0x03)
+        {
+            op.handler = (opcode & 0x08) ? &Z80::MICRO_16BIT_DEC : &Z80::MICRO_16BIT_INC;
+            op.pair = GetRegister16((opcode >> 4) & 3);
+        }
+        else if (((opcode >= 0x80) && (opcode < 0xC0)) || ((opcode & 0xC7) == 0xC6))
+        {
+            // the immediate forms only differ in having no register
+            bool immediate = (opcode >= 0xC0);
+            if (!immediate)
+            {
+                if (src == 6)
+                {
+                    op.pair = &m_ContextZ80.m_RegisterHL.reg;
+                }
+                else
+                {
+                    op.src = GetRegister8(src);
+                }
+            }
+
+            switch (dst)
+            {
+            case 0: op.handler = &Z80::MICRO_ADD; break;
+            case 2: op.handler = &Z80::MICRO_SUB; break;
+            case 4: op.handler = &Z80::MICRO_AND; break;
+            case 5: op.handler = &Z80::MICRO_XOR; break;
+            case 6: op.handler = &Z80::MICRO_OR; break;
+            case 7: op.handler = &Z80::MICRO_COMPARE; break;
+            default: // ADC and SBC read the carry
+                op.handler = &Z80::MICRO_INTERPRET;
+                op.src = nullptr;
+                op.pair = nullptr;
+                break;
+            }
+        }
+        else if (((opcode & 0xC6) == 0x04) && (dst != 6))
+        {
+            op.handler = (opcode & 0x01) ? &Z80::MICRO_DEC : &Z80::MICRO_INC;
+            op.dst = GetRegister8(dst);
+        }
+        else if ((opcode & 0xE7) == 0x20)
+        {
+            op.handler = &Z80::MICRO_JUMP_CONDITIONAL;
+        }
+        else if (opcode == 0xDB)
+        {
+            // IN A,(n) is left to the interpreter unless it's fused
+        }
+        else if (opcode == 0xC3)
+        {
+            op.handler = &Z80::MICRO_JUMP;
+        }
+        else if (opcode == 0x18)
+        {
+            op.handler = &Z80::MICRO_JUMP_IMMEDIATE;
+        }
+
+        pc += op.length;
+        done = !fits || EndsBlock(opcode) || (block.count == BLOCK_MAX_OPS)
+            || (static_cast<WORD>(pc - start) >= static_cast<WORD>(spanEnd - start));
+    }
+
+    FuseBlock(block);
+
+    // a slot which is reused keeps its place in the list
+    if (m_Bus.protectCode(start) && !block.inRam)
+    {
+        block.inRam = true;
+        m_RamBlocks.push_back(&block);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::FuseBlock(DecodedBlock& block)
+{
+    // the runs which are fused, the ones game code spends its time in. An op which
+    // ran off the end of the span is always the last one and is interpreted,
+    // so it can't be part of a run which doesn't start with it
+    auto isALU = [](const MicroOp& op)
+    {
+        return (op.handler == &Z80::MICRO_ADD) || (op.handler == &Z80::MICRO_SUB)
+            || (op.handler == &Z80::MICRO_AND) || (op.handler == &Z80::MICRO_OR)
+            || (op.handler == &Z80::MICRO_XOR) || (op.handler == &Z80::MICRO_COMPARE);
+    };
+    auto isJump = [](const MicroOp& op)
+    {
+        return op.handler == &Z80::MICRO_JUMP_CONDITIONAL;
+    };
+
+    for (int i = 0; i < block.count; ++i)
+    {
+        MicroOp* op = &block.ops[i];
+        int remaining = block.count - i;
+
+        if ((remaining >= 3) && (op[0].opcode == 0xDB) && isALU(op[1]) && isJump(op[2]))
+        {
+            // IN A,(n) / AND n / JR Z,e, ie polling a port
+            op->fusion = Fusion::InALUJump;
+        }
+        else if ((remaining >= 2) && isALU(op[0]) && isJump(op[1]))
+        {
+            // OR A / JR Z,e, CP n / JR NZ,e and so on
+            op->fusion = Fusion::ALUJump;
+        }
+        else if ((remaining >= 2) && ((op[0].handler == &Z80::MICRO_INC) || (op[0].handler == &Z80::MICRO_DEC)) && isJump(op[1]))
+        {
+            // DEC B / JR NZ,e, a loop counter
+            op->fusion = Fusion::IncDecJump;
+        }
+        else if ((remaining >= 2) && (op[0].handler == &Z80::MICRO_LOAD_FROM_HL)
+            && ((op[1].opcode == 0x23) || (op[1].opcode == 0x2B)))
+        {
+            // LD A,(HL) / INC HL, stepping through a table
+            op->fusion = Fusion::LoadHLStep;
+        }
+
+        for (int j = 0; j < FUSED_COUNT[op->fusion] - 1; ++j)
+        {
+            op->fusedCycles += op[j].cycles;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+BYTE* Z80<Bus>::GetRegister8(int code)
+{
+    switch (code)
+    {
+    case 0: return &m_ContextZ80.m_RegisterBC.hi;
+    case 1: return &m_ContextZ80.m_RegisterBC.lo;
+    case 2: return &m_ContextZ80.m_RegisterDE.hi;
+    case 3: return &m_ContextZ80.m_RegisterDE.lo;
+    case 4: return &m_ContextZ80.m_RegisterHL.hi;
+    case 5: return &m_ContextZ80.m_RegisterHL.lo;
+    default: return &m_ContextZ80.m_RegisterAF.hi;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+WORD* Z80<Bus>::GetRegister16(int code)
+{
+    switch (code)
+    {
+    case 0: return &m_ContextZ80.m_RegisterBC.reg;
+    case 1: return &m_ContextZ80.m_RegisterDE.reg;
+    case 2: return &m_ContextZ80.m_RegisterHL.reg;
+    default: return &m_ContextZ80.m_StackPointer.reg;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// ExecuteNextOpcode() has already moved the PC past the whole instruction
+
+template <class Bus>
+void Z80<Bus>::MICRO_INTERPRET(const MicroOp& op)
+{
+    m_ContextZ80.m_ProgramCounter = m_ContextZ80.m_ProgramCounterStart + 1;
+    ExecuteOpcode(op.opcode);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_NOP(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_LOAD(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    *op.dst = *op.src;
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_LOAD_IMMEDIATE(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    *op.dst = static_cast<BYTE>(op.operand);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_LOAD_FROM_HL(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    *op.dst = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_STORE_TO_HL(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, *op.src);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_16BIT_LOAD(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    *op.pair = op.operand;
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_16BIT_INC(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    ++*op.pair;
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_16BIT_DEC(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    --*op.pair;
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+BYTE Z80<Bus>::MicroSource(const MicroOp& op)
+{
+    if (op.src != nullptr)
+    {
+        return *op.src;
+    }
+    if (op.pair != nullptr)
+    {
+        return m_Bus.readMemory(*op.pair);
+    }
+    return static_cast<BYTE>(op.operand);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_ADD(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, MicroSource(op), false, false);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_SUB(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, MicroSource(op), false, false);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_AND(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, MicroSource(op), false);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_OR(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, MicroSource(op), false);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_XOR(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, MicroSource(op), false);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_COMPARE(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, MicroSource(op), false);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_JUMP(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_ProgramCounter = op.operand;
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_JUMP_IMMEDIATE(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_ProgramCounter += static_cast<SIGNED_BYTE>(op.operand);
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_INC(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+#ifdef Z80_LAZY_FLAGS
+    // the carry is left as it was
+    if (m_LazyFlags != LazyFlags::None)
+    {
+        SyncFlags();
+    }
+#endif
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_INC(*op.dst);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_DEC(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+#ifdef Z80_LAZY_FLAGS
+    if (m_LazyFlags != LazyFlags::None)
+    {
+        SyncFlags();
+    }
+#endif
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    CPU_8BIT_DEC(*op.dst);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+bool Z80<Bus>::MicroCondition(BYTE opcode) const
+{
+    // the condition of JR cc,e. Pending lazy flags aren't synced as the zero
+    // and carry flags can be read straight from the result
+    int flag = (opcode & 0x10) ? FLAG_C : FLAG_Z;
+    bool set = false;
+#ifdef Z80_LAZY_FLAGS
+    if (m_LazyFlags != LazyFlags::None)
+    {
+        if (flag == FLAG_Z)
+        {
+            set = (m_LazyResult & 0xFF) == 0;
+        }
+        else
+        {
+            bool hasCarry = (m_LazyFlags == LazyFlags::Add) || (m_LazyFlags == LazyFlags::Sub);
+            set = hasCarry && ((m_LazyResult & 0x100) != 0);
+        }
+    }
+    else
+#endif
+    {
+        set = testBit(m_ContextZ80.m_RegisterAF.lo, flag);
+    }
+    return set == ((opcode & 0x08) != 0);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::MICRO_JUMP_CONDITIONAL(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_OpcodeCycle = Z80CYCLES.Main.base[op.opcode];
+    if (MicroCondition(op.opcode))
+    {
+        m_ContextZ80.m_ProgramCounter += static_cast<SIGNED_BYTE>(op.operand);
+        m_ContextZ80.m_OpcodeCycle = op.cycles;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::ExecuteFused(const MicroOp& op)
+{
+    switch (op.fusion)
+    {
+    case Fusion::ALUJump: FUSED_ALU_JUMP(op); break;
+    case Fusion::IncDecJump: FUSED_INCDEC_JUMP(op); break;
+    case Fusion::InALUJump: FUSED_IN_ALU_JUMP(op); break;
+    case Fusion::LoadHLStep: FUSED_LOAD_HL_STEP(op); break;
+    default: break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// Each part of a fused op counts as an instruction of its own, so once one
+// has run it's accounted for just as the batch in ExecuteCachedOpcode() does.
+// The last leaves its cycles in m_OpcodeCycle like any other op.
+
+template <class Bus>
+inline const typename Z80<Bus>::MicroOp& Z80<Bus>::NextFusedOp(const MicroOp& op)
+{
+#ifdef Z80_PROFILER
+    if (m_Profiler.isEnabled())
+    {
+        ProfileInstruction(m_ContextZ80.m_ProgramCounterStart, op.cycles);
+    }
+#endif
+#ifdef Z80_TRACE
+    TraceInstruction(m_ContextZ80.m_ProgramCounterStart, op.cycles);
+#endif
+    m_Bus.addCycles(&op.cycles, 1);
+    AdvanceBlock();
+
+    const MicroOp& next = (&op)[1];
+    m_ContextZ80.m_ProgramCounterStart = m_ContextZ80.m_ProgramCounter;
+    m_ContextZ80.m_ProgramCounter += next.length;
+#ifdef Z80_PROFILER
+    if (m_Profiler.isEnabled())
+    {
+        ProfileFetch();
+    }
+#endif
+
+    return next;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::FUSED_ALU_JUMP(const MicroOp& op)
+{
+    (this->*op.handler)(op);
+    MICRO_JUMP_CONDITIONAL(NextFusedOp(op));
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::FUSED_INCDEC_JUMP(const MicroOp& op)
+{
+    if (op.opcode & 0x01)
+    {
+        MICRO_DEC(op);
+    }
+    else
+    {
+        MICRO_INC(op);
+    }
+    MICRO_JUMP_CONDITIONAL(NextFusedOp(op));
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::FUSED_IN_ALU_JUMP(const MicroOp& op)
+{
+    IncreaseR(m_ContextZ80.m_RegisterR);
+    m_ContextZ80.m_RegisterAF.hi = m_Bus.readIOMemory(static_cast<BYTE>(op.operand));
+    m_ContextZ80.m_OpcodeCycle = op.cycles;
+    FUSED_ALU_JUMP(NextFusedOp(op));
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80<Bus>::FUSED_LOAD_HL_STEP(const MicroOp& op)
+{
+    MICRO_LOAD_FROM_HL(op);
+    const MicroOp& step = NextFusedOp(op);
+    if (step.opcode == 0x23)
+    {
+        MICRO_16BIT_INC(step);
+    }
+    else
+    {
+        MICRO_16BIT_DEC(step);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// the rest of Z80<Z80Bus> is instantiated in Z80.cpp
+template void Z80<Z80Bus>::FlushCodeCache();
+template void Z80<Z80Bus>::InvalidateCode(const BYTE*, std::size_t);
+template BYTE Z80<Z80Bus>::ExecuteCachedOpcode(bool);
+
+#endif //Z80_BLOCK_CACHE
@@ -0,0 +1,251 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+
+// Cycle counts for every opcode, built at compile time and shared by every
+// Z80 instance. The interpreter loads the count before running an opcode so
+// handlers never write it themselves, except to add on the extra cycles of a
+// taken branch or block repeat. The block cache and anything else which needs
+// to know how long a run of code will take reads them from here too.
+//
+// Counts include any prefix and displacement bytes. The base count is for a
+// conditional op which isn't taken, the taken count is the same as the base
+// for everything else. A zero is an opcode the interpreter doesn't handle,
+// or a prefix which is counted in the page it selects.
+
+// the extra cycles taken by a conditional op when it branches or repeats
+struct Z80TakenCycles final
+{
+    enum
+    {
+        JumpRelative = 5,   // JR cc and DJNZ
+        Call = 7,           // CALL cc
+        Return = 6,         // RET cc
+        Repeat = 5          // LDIR, CPIR, INIR, OTIR and their decrementing forms
+    };
+};
+
+struct Z80CycleTable
+{
+    BYTE    base[256];
+    BYTE    taken[256];
+};
+
+struct Z80CycleTables
+{
+    Z80CycleTable   Main;
+    Z80CycleTable   CB;
+    Z80CycleTable   ED;
+    Z80CycleTable   DDFD;       // DD and FD cost the same, as do their CB pages
+    Z80CycleTable   DDFDCB;
+};
+
+// The counts the interpreter has always used. Most match the data sheet but a
+// few don't, such as ADD A,n (C6), LD SP,HL (F9) and HALT (76). They're kept
+// as they are so that timing doesn't change.
+constexpr BYTE Z80CYCLES_MAIN[256] =
+{
+     4, 10,  7,  6,  4,  4,  7,  4,  4, 11,  7,  6,  4,  4,  7,  4,   // 00
+     8, 10,  7,  6,  4,  4,  7,  4, 12, 11,  7,  6,  4,  4,  7,  4,   // 10
+     7, 10, 16,  6,  4,  4,  7,  4,  7, 11, 16,  6,  4,  4,  7,  4,   // 20
+     7, 10, 13,  6, 11, 11, 10,  4,  7, 11, 13,  6,  4,  4,  7,  4,   // 30
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // 40
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // 50
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // 60
+     7,  7,  7,  7,  7,  7,  1,  7,  4,  4,  4,  4,  4,  4,  7,  4,   // 70
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // 80
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // 90
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // A0
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,   // B0
+     5, 10, 10, 10, 10, 11,  8, 11,  5, 10, 10,  0, 10, 17,  7, 11,   // C0
+     5, 10, 10, 11, 10, 11,  7, 11,  5,  4, 10, 11, 10,  0,  7, 11,   // D0
+     5, 10, 10, 19, 10, 11,  7, 11,  5,  4, 10,  4, 10,  0,  7, 11,   // E0
+     5, 10, 10,  4, 10, 11,  7, 11,  5,  2, 10,  4, 10,  0,  7, 11,   // F0
+};
+
+constexpr BYTE Z80CYCLES_CB[256] =
+{
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // 00
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // 10
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // 20
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // 30
+     8,  8,  8,  8,  8,  8, 12,  8,  8,  8,  8,  8,  8,  8, 12,  8,   // 40
+     8,  8,  8,  8,  8,  8, 12,  8,  8,  8,  8,  8,  8,  8, 12,  8,   // 50
+     8,  8,  8,  8,  8,  8, 12,  8,  8,  8,  8,  8,  8,  8, 12,  8,   // 60
+     8,  8,  8,  8,  8,  8, 12,  8,  8,  8,  8,  8,  8,  8, 12,  8,   // 70
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // 80
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // 90
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // A0
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // B0
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // C0
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // D0
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // E0
+     8,  8,  8,  8,  8,  8, 15,  8,  8,  8,  8,  8,  8,  8, 15,  8,   // F0
+};
+
+constexpr BYTE Z80CYCLES_ED[256] =
+{
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // 00
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // 10
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // 20
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // 30
+    12, 12, 15, 16,  8,  4,  8,  8, 12, 12, 15, 20,  0, 14,  0,  8,   // 40
+    12, 12, 15, 16,  0,  0,  8,  9, 12, 12, 15, 20,  0,  0,  8,  9,   // 50
+    12, 12, 15, 16,  0,  0,  0, 18, 12, 12, 15, 20,  0,  0,  0, 18,   // 60
+     0, 12, 15, 16,  0,  0,  0,  0, 12, 12, 15, 20,  0,  0,  0,  0,   // 70
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // 80
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // 90
+    16, 16, 16, 16,  0,  0,  0,  0, 16, 16, 16, 16,  0,  0,  0,  0,   // A0
+    16, 16, 16, 16,  0,  0,  0,  0, 16, 16, 16, 16,  0,  0,  0,  0,   // B0
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // C0
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // D0
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // E0
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // F0
+};
+
+constexpr BYTE Z80CYCLES_DDFD[256] =
+{
+     0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,   // 00
+     0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,   // 10
+     0, 14, 20, 10, 10, 10, 11,  0,  0, 15, 20, 10, 10, 10, 11,  0,   // 20
+     0,  0,  0,  0, 23, 23, 19,  0,  0, 15,  0,  0,  0,  0,  0,  0,   // 30
+     8,  8,  8,  8,  8,  8, 11,  8,  8,  8,  8,  8,  8,  8, 11,  8,   // 40
+     8,  8,  8,  8,  8,  8, 11,  8,  8,  8,  8,  8,  8,  8, 11,  8,   // 50
+     8,  8,  8,  8,  8,  8, 11,  8,  8,  8,  8,  8,  8,  8, 11,  8,   // 60
+    19, 19, 19, 19, 19, 19,  0, 19,  8,  8,  8,  8,  8,  8, 11,  8,   // 70
+     0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,   // 80
+     0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,   // 90
+     0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,   // A0
+     0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,   // B0
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // C0
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   // D0
+     0, 14,  0, 23,  0, 15,  0,  0,  0,  8,  0,  0,  0,  0,  0,  0,   // E0
+     0,  0,  0,  0,  0,  0,  0,  0,  0, 10,  0,  0,  0,  0,  0,  0,   // F0
+};
+
+constexpr BYTE Z80CYCLES_DDFDCB[256] =
+{
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // 00
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // 10
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // 20
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // 30
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,   // 40
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,   // 50
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,   // 60
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,   // 70
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // 80
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // 90
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // A0
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // B0
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // C0
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // D0
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // E0
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23, 23,   // F0
+};
+
+constexpr Z80CycleTable BuildZ80CycleTable(const BYTE (&base)[256])
+{
+    Z80CycleTable table = {};
+    for (int i = 0; i < 256; ++i)
+    {
+        table.base[i] = base[i];
+        table.taken[i] = base[i];
+    }
+    return table;
+}
+
+constexpr Z80CycleTables BuildZ80CycleTables()
+{
+    Z80CycleTables tables = {};
+    tables.Main = BuildZ80CycleTable(Z80CYCLES_MAIN);
+    tables.CB = BuildZ80CycleTable(Z80CYCLES_CB);
+    tables.ED = BuildZ80CycleTable(Z80CYCLES_ED);
+    tables.DDFD = BuildZ80CycleTable(Z80CYCLES_DDFD);
+    tables.DDFDCB = BuildZ80CycleTable(Z80CYCLES_DDFDCB);
+
+    // DJNZ and JR cc
+    constexpr BYTE jumps[] = { 0x10, 0x20, 0x28, 0x30, 0x38 };
+    for (auto op : jumps)
+    {
+        tables.Main.taken[op] += Z80TakenCycles::JumpRelative;
+    }
+
+    for (int cc = 0; cc < 8; ++cc)
+    {
+        tables.Main.taken[0xC0 | (cc << 3)] += Z80TakenCycles::Return;
+        tables.Main.taken[0xC4 | (cc << 3)] += Z80TakenCycles::Call;
+    }
+
+    // LDIR, CPIR, INIR, OTIR, LDDR, CPDR, INDR and OTDR
+    for (int op = 0xB0; op < 0xBC; ++op)
+    {
+        if ((op & 0x04) == 0)
+        {
+            tables.ED.taken[op] += Z80TakenCycles::Repeat;
+        }
+    }
+
+    return tables;
+}
+
+inline constexpr Z80CycleTables Z80CYCLES = BuildZ80CycleTables();
+
+// checked here so that a typo in a table fails the build rather than
+// turning up as an opcode which takes no time. ED, DD and FD are allowed
+// gaps as the interpreter logs those opcodes as unhandled.
+constexpr bool Z80CyclesArePlausible(const Z80CycleTable& table, bool complete)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        if ((complete && (table.base[i] == 0)) || (table.taken[i] < table.base[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool Z80CyclesCoverMain()
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        bool prefix = (i == 0xCB) || (i == 0xDD) || (i == 0xED) || (i == 0xFD);
+        if ((Z80CYCLES.Main.base[i] == 0) != prefix)
+        {
+            return false;
+        }
+    }
+    return Z80CyclesArePlausible(Z80CYCLES.Main, false);
+}
+
+static_assert(Z80CyclesCoverMain(), "every unprefixed opcode needs a cycle count");
+static_assert(Z80CyclesArePlausible(Z80CYCLES.CB, true), "every CB opcode needs a cycle count");
+static_assert(Z80CyclesArePlausible(Z80CYCLES.DDFDCB, true), "every DDCB and FDCB opcode needs a cycle count");
+static_assert(Z80CyclesArePlausible(Z80CYCLES.ED, false) && Z80CyclesArePlausible(Z80CYCLES.DDFD, false), "taken counts can't be less than the base");
+static_assert(Z80CYCLES.Main.taken[0x20] == Z80CYCLES.Main.base[0x18], "a taken JR cc costs the same as JR");
+static_assert(Z80CYCLES.Main.taken[0xC4] == Z80CYCLES.Main.base[0xCD], "a taken CALL cc costs the same as CALL");
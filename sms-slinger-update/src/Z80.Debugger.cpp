@@ -0,0 +1,126 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Z80.Debugger.hpp"
+
+#include <algorithm>
+
+void Z80Debugger::addBreakpoint(WORD address)
+{
+    if (!hasBreakpoint(address))
+    {
+        m_breakpoints[address >> 6] |= (1ull << (address & 63));
+        m_breakpointCount++;
+    }
+}
+
+void Z80Debugger::removeBreakpoint(WORD address)
+{
+    if (hasBreakpoint(address))
+    {
+        m_breakpoints[address >> 6] &= ~(1ull << (address & 63));
+        m_breakpointCount--;
+    }
+}
+
+std::vector<WORD> Z80Debugger::getBreakpoints() const
+{
+    std::vector<WORD> breakpoints;
+    for (int address = 0; address < 0x10000; ++address)
+    {
+        if (hasBreakpoint(static_cast<WORD>(address)))
+        {
+            breakpoints.push_back(static_cast<WORD>(address));
+        }
+    }
+    return breakpoints;
+}
+
+void Z80Debugger::addWatchpoint(WORD start, WORD end, int access)
+{
+    Watchpoint watchpoint;
+    watchpoint.start = std::min(start, end);
+    watchpoint.end = std::max(start, end);
+    watchpoint.access = access;
+    m_watchpoints.push_back(watchpoint);
+}
+
+void Z80Debugger::removeWatchpoint(std::size_t index)
+{
+    if (index < m_watchpoints.size())
+    {
+        m_watchpoints.erase(m_watchpoints.begin() + index);
+    }
+}
+
+int Z80Debugger::getWatchedAccess(WORD start, WORD end) const
+{
+    int access = 0;
+    for (const auto& watchpoint : m_watchpoints)
+    {
+        if (watchpoint.start <= end && watchpoint.end >= start)
+        {
+            access |= watchpoint.access;
+        }
+    }
+    return access;
+}
+
+void Z80Debugger::pause(int reason, WORD address)
+{
+    m_paused = true;
+    m_stepping = false;
+    m_reason = reason;
+    m_address = address;
+}
+
+void Z80Debugger::resume()
+{
+    m_paused = false;
+    m_skipBreakpoint = true;
+}
+
+void Z80Debugger::step()
+{
+    resume();
+    m_stepping = true;
+}
+
+void Z80Debugger::checkWatchpoint(WORD address, int access)
+{
+    if (m_paused)
+    {
+        return;
+    }
+
+    for (const auto& watchpoint : m_watchpoints)
+    {
+        if ((watchpoint.access & access) && address >= watchpoint.start && address <= watchpoint.end)
+        {
+            pause(Reason::Watchpoint, address);
+            return;
+        }
+    }
+}
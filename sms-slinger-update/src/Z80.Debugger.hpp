@@ -0,0 +1,129 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// PC breakpoints and memory watchpoints, only built with Z80_DEBUGGER
+// defined. Nothing here is looked at while it is empty: Z80::Run() only
+// takes its debug path, which checks the pc before every instruction,
+// while isActive() is true. Watchpoints are checked by the bus, which
+// sends accesses to pages holding one down its slow path. With
+// Z80_BLOCK_CACHE defined opcode fetches don't go through the bus, so
+// read watchpoints only see the data an instruction reads.
+class Z80Debugger final
+{
+public:
+    struct Access final
+    {
+        enum
+        {
+            Read = 0x1, Write = 0x2
+        };
+    };
+
+    struct Reason final
+    {
+        enum
+        {
+            None, Pause, Breakpoint, Watchpoint, Step
+        };
+    };
+
+    struct Watchpoint final
+    {
+        WORD start = 0;
+        WORD end = 0; // inclusive
+        int access = Access::Write;
+    };
+
+    void addBreakpoint(WORD address);
+    void removeBreakpoint(WORD address);
+    bool hasBreakpoint(WORD address) const { return (m_breakpoints[address >> 6] >> (address & 63)) & 1; }
+    std::vector<WORD> getBreakpoints() const;
+
+    // the bus has to rebuild its page tables after these, see Emulator::addWatchpoint()
+    void addWatchpoint(WORD start, WORD end, int access);
+    void removeWatchpoint(std::size_t index);
+    const std::vector<Watchpoint>& getWatchpoints() const { return m_watchpoints; }
+    // the accesses watched anywhere between start and end
+    int getWatchedAccess(WORD start, WORD end) const;
+
+    bool isActive() const { return m_paused || m_stepping || m_breakpointCount != 0 || !m_watchpoints.empty(); }
+    bool isPaused() const { return m_paused; }
+    int getReason() const { return m_reason; }
+    WORD getAddress() const { return m_address; }
+
+    void pause(int reason = Reason::Pause, WORD address = 0);
+    // both carry on from the current pc without stopping at a breakpoint there
+    void resume();
+    void step();
+
+    // called by Z80::Run() before each instruction on the debug path, returns
+    // true if the cpu has to stop before running the instruction at pc
+    bool checkBreakpoint(WORD pc);
+
+    // called by the bus for accesses to pages holding a watchpoint. The cpu
+    // stops once the instruction making the access has finished
+    void checkWatchpoint(WORD address, int access);
+
+private:
+    std::array<std::uint64_t, 0x10000 / 64> m_breakpoints = {};
+    std::size_t m_breakpointCount = 0;
+    std::vector<Watchpoint> m_watchpoints;
+
+    bool m_paused = false;
+    bool m_stepping = false;
+    bool m_skipBreakpoint = false;
+    int m_reason = Reason::None;
+    WORD m_address = 0;
+};
+
+inline bool Z80Debugger::checkBreakpoint(WORD pc)
+{
+    if (m_skipBreakpoint)
+    {
+        m_skipBreakpoint = false;
+        return m_paused;
+    }
+
+    if (!m_paused)
+    {
+        if (m_stepping)
+        {
+            pause(Reason::Step, pc);
+        }
+        else if (hasBreakpoint(pc))
+        {
+            pause(Reason::Breakpoint, pc);
+        }
+    }
+    return m_paused;
+}
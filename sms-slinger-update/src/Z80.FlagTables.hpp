@@ -0,0 +1,152 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+#include "Z80.hpp"
+
+// the flags written by ops such as INC and DEC which leave the carry alone
+constexpr BYTE Z80FLAGS_SZHVN = (1 << FLAG_S) | (1 << FLAG_Z) | (1 << FLAG_H) | (1 << FLAG_PV) | (1 << FLAG_N);
+
+// Flag results for the 8 bit ALU, built at compile time and shared by every
+// Z80 instance. The results are already in the bit positions of the F register.
+struct Z80FlagTables
+{
+    BYTE    SZ[256];        // S and Z for a result
+    BYTE    SZP[256];       // S, Z and parity in PV for a result
+    BYTE    Inc[256];       // S, Z, H and V for the result of an 8 bit increment
+    BYTE    Dec[256];       // S, Z, H, V and N for the result of an 8 bit decrement
+    WORD    DAA[0x800];     // AF after DAA, indexed by A | C << 8 | H << 9 | N << 10
+};
+
+constexpr Z80FlagTables BuildZ80FlagTables()
+{
+    Z80FlagTables tables = {};
+
+    for (int i = 0; i < 256; ++i)
+    {
+        BYTE zFlag = (i == 0) ? (1 << FLAG_Z) : 0;
+        BYTE sFlag = i & (1 << FLAG_S);
+        BYTE vFlag = (1 << FLAG_PV);
+        for (int v = 128; v != 0; v >>= 1)
+        {
+            if (i & v)
+            {
+                vFlag ^= (1 << FLAG_PV);
+            }
+        }
+        tables.SZ[i] = zFlag | sFlag;
+        tables.SZP[i] = zFlag | sFlag | vFlag;
+
+        // the half carry and overflow of inc/dec can be worked out from the result alone
+        tables.Inc[i] = zFlag | sFlag;
+        if ((i & 0xF) == 0)
+        {
+            tables.Inc[i] |= (1 << FLAG_H);
+        }
+        if (i == 0x80)
+        {
+            tables.Inc[i] |= (1 << FLAG_PV);
+        }
+
+        tables.Dec[i] = zFlag | sFlag | (1 << FLAG_N);
+        if ((i & 0xF) == 0xF)
+        {
+            tables.Dec[i] |= (1 << FLAG_H);
+        }
+        if (i == 0x7F)
+        {
+            tables.Dec[i] |= (1 << FLAG_PV);
+        }
+    }
+
+    for (int x = 0; x < 0x800; ++x)
+    {
+        bool nf = x & 0x400;
+        bool hf = x & 0x200;
+        bool cf = x & 0x100;
+        BYTE a = x & 0xFF;
+        BYTE hi = a / 16;
+        BYTE lo = a & 15;
+        BYTE diff = 0;
+        if (cf)
+        {
+            diff = ((lo <= 9) && !hf) ? 0x60 : 0x66;
+        }
+        else
+        {
+            if (lo >= 10)
+            {
+                diff = (hi <= 8) ? 0x06 : 0x66;
+            }
+            else
+            {
+                if (hi >= 10)
+                {
+                    diff = hf ? 0x66 : 0x60;
+                }
+                else
+                {
+                    diff = hf ? 0x06 : 0x00;
+                }
+            }
+        }
+        BYTE res_a = nf ? a - diff : a + diff;
+        BYTE res_f = tables.SZP[res_a] | (nf ? 0x02 : 0);
+        if (cf || ((lo <= 9) ? (hi >= 10) : (hi >= 9)))
+        {
+            res_f |= 0x01;
+        }
+        if (nf ? (hf && (lo <= 5)) : (lo >= 10))
+        {
+            res_f |= 0x10;
+        }
+        tables.DAA[x] = (res_a << 8) + res_f;
+    }
+
+    return tables;
+}
+
+inline constexpr Z80FlagTables Z80FLAGTABLES = BuildZ80FlagTables();
+
+// F after an 8 bit add or subtract. These are shared by the ALU ops and by
+// the lazy flag path, which only keeps the operands around until F is needed.
+// res is the unmasked result, so bit 8 holds the carry or borrow.
+constexpr BYTE Z80AddFlags(BYTE before, BYTE operand, int res)
+{
+    return Z80FLAGTABLES.SZ[res & 0xFF]
+        | ((before ^ res ^ operand) & (1 << FLAG_H))
+        | ((((operand ^ before ^ 0x80) & (operand ^ res)) >> 5) & (1 << FLAG_PV))
+        | ((res >> 8) & (1 << FLAG_C));
+}
+
+constexpr BYTE Z80SubFlags(BYTE before, BYTE operand, int res)
+{
+    return Z80FLAGTABLES.SZ[res & 0xFF] | (1 << FLAG_N)
+        | ((res >> 8) & (1 << FLAG_C))
+        | ((before ^ res ^ operand) & (1 << FLAG_H))
+        | ((((operand ^ before) & (before ^ res)) >> 5) & (1 << FLAG_PV));
+}
@@ -27,11 +27,98 @@
 #include "Z80.hpp"
 #include "Z80.Opcodes.hpp"
 #include "LogMessages.hpp"
+#include "Z80.Bus.hpp"
 
+#include <array>
 #include <cassert>
 #include <cstdio>
 
-void Z80::IncreaseRReg()
+// GCC and Clang support taking the address of a label, so each decoder
+// jumps straight to its handler through a table instead of going through
+// the switch range check. The switch is what everything else compiles.
+#if defined(__GNUC__) && !defined(Z80_NO_THREADED_DISPATCH)
+#define Z80_THREADED_DISPATCH
+#define Z80_OP(op) case op: op_##op
+#define Z80_OP_DEFAULT default: op_default
+#else
+#define Z80_OP(op) case op
+#define Z80_OP_DEFAULT default
+#endif
+
+#ifdef Z80_LAZY_FLAGS
+namespace
+{
+    // Base opcodes which neither read F nor leave part of it alone, so they
+    // can run while the flags of the last ALU op are still pending. Anything
+    // else, including all of the prefixed opcodes, syncs F first.
+    constexpr std::array<bool, 256> BuildLazyFlagSafeOpcodes()
+    {
+        std::array<bool, 256> safe = {};
+
+        // LD r,r' and LD r,(HL) / LD (HL),r, HALT included
+        for (int i = 0x40; i < 0x80; ++i)
+        {
+            safe[i] = true;
+        }
+
+        // ADD, SUB, AND, XOR, OR and CP, but not ADC or SBC
+        for (int i = 0x80; i < 0xC0; ++i)
+        {
+            bool isADCorSBC = (i >= 0x88 && i < 0x90) || (i >= 0x98 && i < 0xA0);
+            safe[i] = !isADCorSBC;
+        }
+
+        constexpr BYTE others[] =
+        {
+            0x00, 0x01, 0x02, 0x03, 0x06, 0x0A, 0x0B, 0x0E,
+            0x10, 0x11, 0x12, 0x13, 0x16, 0x18, 0x1A, 0x1B, 0x1E,
+            0x21, 0x22, 0x23, 0x26, 0x2A, 0x2B, 0x2E,
+            0x31, 0x32, 0x33, 0x36, 0x3A, 0x3B, 0x3E,
+            0xC1, 0xC3, 0xC5, 0xC6, 0xC7, 0xC9, 0xCD, 0xCF,
+            0xD1, 0xD3, 0xD5, 0xD6, 0xD7, 0xD9, 0xDB, 0xDF,
+            0xE1, 0xE3, 0xE5, 0xE6, 0xE7, 0xE9, 0xEB, 0xEE, 0xEF,
+            0xF3, 0xF6, 0xF7, 0xF9, 0xFB, 0xFE, 0xFF
+        };
+        for (auto op : others)
+        {
+            safe[op] = true;
+        }
+
+        return safe;
+    }
+
+    constexpr std::array<bool, 256> LAZYFLAGSAFEOPCODES = BuildLazyFlagSafeOpcodes();
+}
+#endif
+
+template <class Bus>
+void Z80<Bus>::SyncFlags()
+{
+#ifdef Z80_LAZY_FLAGS
+    switch (m_LazyFlags)
+    {
+    default:
+    case LazyFlags::None:
+        return;
+    case LazyFlags::Add:
+        m_ContextZ80.m_RegisterAF.lo = Z80AddFlags(m_LazyBefore, m_LazyOperand, m_LazyResult);
+        break;
+    case LazyFlags::Sub:
+        m_ContextZ80.m_RegisterAF.lo = Z80SubFlags(m_LazyBefore, m_LazyOperand, m_LazyResult);
+        break;
+    case LazyFlags::And:
+        m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[m_LazyResult & 0xFF] | (1 << FLAG_H);
+        break;
+    case LazyFlags::OrXor:
+        m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[m_LazyResult & 0xFF];
+        break;
+    }
+    m_LazyFlags = LazyFlags::None;
+#endif
+}
+
+template <class Bus>
+void Z80<Bus>::IncreaseRReg()
 {
     if ((m_ContextZ80.m_RegisterR & 127) == 127)
     {
@@ -43,342 +130,390 @@ void Z80::IncreaseRReg()
     }
 }
 
-void Z80::ExecuteOpcode(const BYTE& opcode)
+template <class Bus>
+void Z80<Bus>::ExecuteOpcode(const BYTE& opcode)
 {
     IncreaseRReg();
-    
+
+    // handlers only touch this to add on the cycles of a taken branch
+    m_ContextZ80.m_OpcodeCycle = Z80CYCLES.Main.base[opcode];
+
+#ifdef Z80_LAZY_FLAGS
+    if (m_LazyFlags != LazyFlags::None && !LAZYFLAGSAFEOPCODES[opcode])
+    {
+        SyncFlags();
+    }
+#endif
 
 //  char buffer[255];
 //  sprintf(buffer, "Executing Opcode %x",opcode);
     //LogMessage::GetSingleton()->DoLogMessage(buffer,true);
 
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatchTable[256] =
+    {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+        &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+        &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+        &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+        &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+        &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+        &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+        &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_0xF4, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+        &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+    };
+    goto *dispatchTable[opcode];
+#endif
+
     switch(opcode)
     {
         //no-op
-        case 0x00: m_ContextZ80.m_OpcodeCycle=4; break;
+        Z80_OP(0x00): break;
 
         // 8-Bit Loads
-        case 0x06: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x0E: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x16: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x1E: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x26: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x2E: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x3E: CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x06): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x0E): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x16): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x1E): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x26): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x2E): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x3E): CPU_8BIT_LOAD_IMMEDIATE(m_ContextZ80.m_RegisterAF.hi); break;
 
         // 8-Bit Reg Loads
-        case 0x7F: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0x78: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x79: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x7A: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x7B: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x7C: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x7D: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x40: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x41: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x42: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x43: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x44: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x45: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x48: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x49: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x4A: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x4B: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x4C: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x4D: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x50: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x51: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x52: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x53: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x54: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x55: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x58: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x59: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x5A: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x5B: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x5C: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x5D: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x60: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x61: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x62: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x63: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x64: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x65: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x68: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x69: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x6A: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x6B: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x6C: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x6D: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x47: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0x4F: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0x57: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0x5F: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0x67: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0x6F: CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x7F): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x78): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x79): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x7A): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x7B): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x7C): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x7D): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x40): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x41): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x42): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x43): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x44): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x45): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x48): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x49): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x4A): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x4B): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x4C): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x4D): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x50): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x51): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x52): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x53): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x54): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x55): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x58): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x59): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x5A): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x5B): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x5C): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x5D): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x60): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x61): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x62): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x63): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x64): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x65): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x68): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x69): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x6A): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x6B): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x6C): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x6D): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x47): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x4F): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x57): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x5F): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x67): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x6F): CPU_REG_LOAD(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterAF.hi); break;
 
         // write reg to memory
-        case 0x70: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.hi); m_ContextZ80.m_OpcodeCycle=7; break;
-        case 0x71: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.lo); m_ContextZ80.m_OpcodeCycle=7;break;
-        case 0x72: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.hi); m_ContextZ80.m_OpcodeCycle=7;break;
-        case 0x73: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.lo); m_ContextZ80.m_OpcodeCycle=7;break;
-        case 0x74: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.hi); m_ContextZ80.m_OpcodeCycle=7;break;
-        case 0x75: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.lo); m_ContextZ80.m_OpcodeCycle=7;break;
-        case 0x02: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterBC.reg, m_ContextZ80.m_RegisterAF.hi); m_ContextZ80.m_OpcodeCycle=7; break;
-        case 0x12: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterDE.reg, m_ContextZ80.m_RegisterAF.hi); m_ContextZ80.m_OpcodeCycle=7; break;
-        case 0x77: m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterAF.hi); m_ContextZ80.m_OpcodeCycle=7; break;
+        Z80_OP(0x70): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x71): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x72): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x73): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x74): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.hi);break;
+        Z80_OP(0x75): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.lo);break;
+        Z80_OP(0x02): m_Bus.writeMemory(m_ContextZ80.m_RegisterBC.reg, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x12): m_Bus.writeMemory(m_ContextZ80.m_RegisterDE.reg, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x77): m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterAF.hi); break;
 
         // write memory to reg
-        case 0x7E: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x46: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x4E: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x56: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x5E: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x66: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x6E: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x0A: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.reg); break;
-        case 0x1A: CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.reg); break;
+        Z80_OP(0x7E): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x46): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x4E): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x56): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x5E): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x66): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterHL.hi, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x6E): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterHL.lo, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x0A): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.reg); break;
+        Z80_OP(0x1A): CPU_REG_LOAD_ROM(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.reg); break;
 
         // 16 bit loads
-        case 0x01: CPU_16BIT_LOAD(m_ContextZ80.m_RegisterBC.reg); break;
-        case 0x11: CPU_16BIT_LOAD(m_ContextZ80.m_RegisterDE.reg);break;
-        case 0x21: CPU_16BIT_LOAD(m_ContextZ80.m_RegisterHL.reg);break;
-        case 0x31: CPU_16BIT_LOAD(m_ContextZ80.m_StackPointer.reg);break;
-        case 0xF9: m_ContextZ80.m_StackPointer.reg = m_ContextZ80.m_RegisterHL.reg; m_ContextZ80.m_OpcodeCycle=2; break;
+        Z80_OP(0x01): CPU_16BIT_LOAD(m_ContextZ80.m_RegisterBC.reg); break;
+        Z80_OP(0x11): CPU_16BIT_LOAD(m_ContextZ80.m_RegisterDE.reg);break;
+        Z80_OP(0x21): CPU_16BIT_LOAD(m_ContextZ80.m_RegisterHL.reg);break;
+        Z80_OP(0x31): CPU_16BIT_LOAD(m_ContextZ80.m_StackPointer.reg);break;
+        Z80_OP(0xF9): m_ContextZ80.m_StackPointer.reg = m_ContextZ80.m_RegisterHL.reg; break;
 
         // push word onto stack
-        case 0xF5: PushWordOntoStack(m_ContextZ80.m_RegisterAF.reg);  m_ContextZ80.m_OpcodeCycle=11;break;
-        case 0xC5: PushWordOntoStack(m_ContextZ80.m_RegisterBC.reg);  m_ContextZ80.m_OpcodeCycle=11;break;
-        case 0xD5: PushWordOntoStack(m_ContextZ80.m_RegisterDE.reg);  m_ContextZ80.m_OpcodeCycle=11;break;
-        case 0xE5: PushWordOntoStack(m_ContextZ80.m_RegisterHL.reg);  m_ContextZ80.m_OpcodeCycle=11; break;
+        Z80_OP(0xF5): PushWordOntoStack(m_ContextZ80.m_RegisterAF.reg);break;
+        Z80_OP(0xC5): PushWordOntoStack(m_ContextZ80.m_RegisterBC.reg);break;
+        Z80_OP(0xD5): PushWordOntoStack(m_ContextZ80.m_RegisterDE.reg);break;
+        Z80_OP(0xE5): PushWordOntoStack(m_ContextZ80.m_RegisterHL.reg); break;
 
         // pop word from stack into reg
-        case 0xF1: m_ContextZ80.m_RegisterAF.reg = PopWordOffStack();  m_ContextZ80.m_OpcodeCycle=10;break;
-        case 0xC1: m_ContextZ80.m_RegisterBC.reg = PopWordOffStack();  m_ContextZ80.m_OpcodeCycle=10;break;
-        case 0xD1: m_ContextZ80.m_RegisterDE.reg = PopWordOffStack();  m_ContextZ80.m_OpcodeCycle=10;break;
-        case 0xE1: m_ContextZ80.m_RegisterHL.reg = PopWordOffStack();  m_ContextZ80.m_OpcodeCycle=10; break;
+        Z80_OP(0xF1): m_ContextZ80.m_RegisterAF.reg = PopWordOffStack();break;
+        Z80_OP(0xC1): m_ContextZ80.m_RegisterBC.reg = PopWordOffStack();break;
+        Z80_OP(0xD1): m_ContextZ80.m_RegisterDE.reg = PopWordOffStack();break;
+        Z80_OP(0xE1): m_ContextZ80.m_RegisterHL.reg = PopWordOffStack(); break;
 
             // 8-bit add
-        case 0x87: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4,false,false); break;
-        case 0x80: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4,false,false); break;
-        case 0x81: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80. m_RegisterBC.lo,4,false,false); break;
-        case 0x82: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4,false,false); break;
-        case 0x83: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4,false,false); break;
-        case 0x84: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4,false,false); break;
-        case 0x85: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4,false,false); break;
-        case 0x86: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7,false,false); break;
-        case 0xC6: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, 0,8,true,false); break;
+        Z80_OP(0x87): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,false,false); break;
+        Z80_OP(0x80): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,false,false); break;
+        Z80_OP(0x81): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80. m_RegisterBC.lo,false,false); break;
+        Z80_OP(0x82): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,false,false); break;
+        Z80_OP(0x83): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,false,false); break;
+        Z80_OP(0x84): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,false,false); break;
+        Z80_OP(0x85): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,false,false); break;
+        Z80_OP(0x86): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg),false,false); break;
+        Z80_OP(0xC6): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, 0,true,false); break;
 
             // 8-bit add + carry
-        case 0x8F: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4,false,true); break;
-        case 0x88: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4,false,true); break;
-        case 0x89: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4,false,true); break;
-        case 0x8A: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4,false,true); break;
-        case 0x8B: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4,false,true); break;
-        case 0x8C: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4,false,true); break;
-        case 0x8D: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4,false,true); break;
-        case 0x8E: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7,false,true); break;
-        case 0xCE: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, 0,7,true,true); break;
+        Z80_OP(0x8F): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,false,true); break;
+        Z80_OP(0x88): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,false,true); break;
+        Z80_OP(0x89): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,false,true); break;
+        Z80_OP(0x8A): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,false,true); break;
+        Z80_OP(0x8B): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,false,true); break;
+        Z80_OP(0x8C): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,false,true); break;
+        Z80_OP(0x8D): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,false,true); break;
+        Z80_OP(0x8E): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg),false,true); break;
+        Z80_OP(0xCE): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, 0,true,true); break;
 
         // 8-bit subtract
-        case 0x97: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4,false,false); break;
-        case 0x90: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4,false,false); break;
-        case 0x91: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4,false,false); break;
-        case 0x92: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4,false,false); break;
-        case 0x93: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4,false,false); break;
-        case 0x94: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4,false,false); break;
-        case 0x95: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4,false,false); break;
-        case 0x96: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7,false,false); break;
-        case 0xD6: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, 0,7,true,false); break;
+        Z80_OP(0x97): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,false,false); break;
+        Z80_OP(0x90): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,false,false); break;
+        Z80_OP(0x91): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,false,false); break;
+        Z80_OP(0x92): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,false,false); break;
+        Z80_OP(0x93): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,false,false); break;
+        Z80_OP(0x94): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,false,false); break;
+        Z80_OP(0x95): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,false,false); break;
+        Z80_OP(0x96): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg),false,false); break;
+        Z80_OP(0xD6): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, 0,true,false); break;
 
         // 8-bit subtract + carry
-        case 0x9F: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4,false,true); break;
-        case 0x98: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4,false,true); break;
-        case 0x99: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4,false,true); break;
-        case 0x9A: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4,false,true); break;
-        case 0x9B: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4,false,true); break;
-        case 0x9C: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4,false,true); break;
-        case 0x9D: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4,false,true); break;
-        case 0x9E: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7,false,true); break;
-        case 0xDE: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, 0,7,true,true); break;
+        Z80_OP(0x9F): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,false,true); break;
+        Z80_OP(0x98): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,false,true); break;
+        Z80_OP(0x99): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,false,true); break;
+        Z80_OP(0x9A): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,false,true); break;
+        Z80_OP(0x9B): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,false,true); break;
+        Z80_OP(0x9C): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,false,true); break;
+        Z80_OP(0x9D): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,false,true); break;
+        Z80_OP(0x9E): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg),false,true); break;
+        Z80_OP(0xDE): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, 0,true,true); break;
 
         // 8-bit AND reg with reg
-        case 0xA7: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4, false); break;
-        case 0xA0: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4, false); break;
-        case 0xA1: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4, false); break;
-        case 0xA2: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4, false); break;
-        case 0xA3: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4, false); break;
-        case 0xA4: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4, false); break;
-        case 0xA5: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4, false); break;
-        case 0xA6: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7, false); break;
-        case 0xE6: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, 0,7, true); break;
+        Z80_OP(0xA7): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi, false); break;
+        Z80_OP(0xA0): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi, false); break;
+        Z80_OP(0xA1): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo, false); break;
+        Z80_OP(0xA2): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi, false); break;
+        Z80_OP(0xA3): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo, false); break;
+        Z80_OP(0xA4): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi, false); break;
+        Z80_OP(0xA5): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo, false); break;
+        Z80_OP(0xA6): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), false); break;
+        Z80_OP(0xE6): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, 0, true); break;
 
         // 8-bit OR reg with reg
-        case 0xB7: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4, false); break;
-        case 0xB0: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4, false); break;
-        case 0xB1: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4, false); break;
-        case 0xB2: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4, false); break;
-        case 0xB3: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4, false); break;
-        case 0xB4: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4, false); break;
-        case 0xB5: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4, false); break;
-        case 0xB6: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7, false); break;
-        case 0xF6: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, 0,7, true); break;
+        Z80_OP(0xB7): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi, false); break;
+        Z80_OP(0xB0): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi, false); break;
+        Z80_OP(0xB1): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo, false); break;
+        Z80_OP(0xB2): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi, false); break;
+        Z80_OP(0xB3): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo, false); break;
+        Z80_OP(0xB4): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi, false); break;
+        Z80_OP(0xB5): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo, false); break;
+        Z80_OP(0xB6): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), false); break;
+        Z80_OP(0xF6): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, 0, true); break;
 
         // 8-bit XOR reg with reg
-        case 0xAF: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4, false); break;
-        case 0xA8: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4, false); break;
-        case 0xA9: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4, false); break;
-        case 0xAA: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4, false); break;
-        case 0xAB: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4, false); break;
-        case 0xAC: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4, false); break;
-        case 0xAD: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4, false); break;
-        case 0xAE: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7, false); break;
-        case 0xEE: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, 0,7, true); break;
+        Z80_OP(0xAF): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi, false); break;
+        Z80_OP(0xA8): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi, false); break;
+        Z80_OP(0xA9): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo, false); break;
+        Z80_OP(0xAA): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi, false); break;
+        Z80_OP(0xAB): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo, false); break;
+        Z80_OP(0xAC): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi, false); break;
+        Z80_OP(0xAD): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo, false); break;
+        Z80_OP(0xAE): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), false); break;
+        Z80_OP(0xEE): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, 0, true); break;
 
         // 8-Bit compare
-        case 0xBF: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi,4, false); break;
-        case 0xB8: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi,4, false); break;
-        case 0xB9: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo,4, false); break;
-        case 0xBA: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi,4, false); break;
-        case 0xBB: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo,4, false); break;
-        case 0xBC: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi,4, false); break;
-        case 0xBD: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo,4, false); break;
-        case 0xBE: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg),7, false); break;
-        case 0xFE: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, 0,7, true); break;
+        Z80_OP(0xBF): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi, false); break;
+        Z80_OP(0xB8): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi, false); break;
+        Z80_OP(0xB9): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo, false); break;
+        Z80_OP(0xBA): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi, false); break;
+        Z80_OP(0xBB): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo, false); break;
+        Z80_OP(0xBC): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.hi, false); break;
+        Z80_OP(0xBD): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterHL.lo, false); break;
+        Z80_OP(0xBE): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), false); break;
+        Z80_OP(0xFE): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, 0, true); break;
 
         // 8-bit inc
-        case 0x3C: CPU_8BIT_INC(m_ContextZ80.m_RegisterAF.hi,4); break;
-        case 0x04: CPU_8BIT_INC(m_ContextZ80.m_RegisterBC.hi,4); break;
-        case 0x0C: CPU_8BIT_INC(m_ContextZ80.m_RegisterBC.lo,4); break;
-        case 0x14: CPU_8BIT_INC(m_ContextZ80.m_RegisterDE.hi,4); break;
-        case 0x1C: CPU_8BIT_INC(m_ContextZ80.m_RegisterDE.lo,4); break;
-        case 0x24: CPU_8BIT_INC(m_ContextZ80.m_RegisterHL.hi,4); break;
-        case 0x2C: CPU_8BIT_INC(m_ContextZ80.m_RegisterHL.lo,4); break;
-        case 0x34: CPU_8BIT_MEMORY_INC(m_ContextZ80.m_RegisterHL.reg,11); break;
+        Z80_OP(0x3C): CPU_8BIT_INC(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x04): CPU_8BIT_INC(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x0C): CPU_8BIT_INC(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x14): CPU_8BIT_INC(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x1C): CPU_8BIT_INC(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x24): CPU_8BIT_INC(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x2C): CPU_8BIT_INC(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x34): CPU_8BIT_MEMORY_INC(m_ContextZ80.m_RegisterHL.reg); break;
 
         // 8-bit dec
-        case 0x3D: CPU_8BIT_DEC(m_ContextZ80.m_RegisterAF.hi,4); break;
-        case 0x05: CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi,4); break;
-        case 0x0D: CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.lo,4); break;
-        case 0x15: CPU_8BIT_DEC(m_ContextZ80.m_RegisterDE.hi,4); break;
-        case 0x1D: CPU_8BIT_DEC(m_ContextZ80.m_RegisterDE.lo,4); break;
-        case 0x25: CPU_8BIT_DEC(m_ContextZ80.m_RegisterHL.hi,4); break;
-        case 0x2D: CPU_8BIT_DEC(m_ContextZ80.m_RegisterHL.lo,4); break;
-        case 0x35: CPU_8BIT_MEMORY_DEC(m_ContextZ80.m_RegisterHL.reg,11); break;
+        Z80_OP(0x3D): CPU_8BIT_DEC(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x05): CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x0D): CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x15): CPU_8BIT_DEC(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x1D): CPU_8BIT_DEC(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x25): CPU_8BIT_DEC(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x2D): CPU_8BIT_DEC(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x35): CPU_8BIT_MEMORY_DEC(m_ContextZ80.m_RegisterHL.reg); break;
 
         // 16-bit add
-        case 0x09: CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_RegisterBC.reg,11,false); break;
-        case 0x19: CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_RegisterDE.reg,11,false); break;
-        case 0x29: CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_RegisterHL.reg,11,false); break;
-        case 0x39: CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_StackPointer.reg,11,false); break;
+        Z80_OP(0x09): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_RegisterBC.reg,false); break;
+        Z80_OP(0x19): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_RegisterDE.reg,false); break;
+        Z80_OP(0x29): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_RegisterHL.reg,false); break;
+        Z80_OP(0x39): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg,m_ContextZ80.m_StackPointer.reg,false); break;
 
         // inc 16-bit register
-        case 0x03: CPU_16BIT_INC(m_ContextZ80.m_RegisterBC.reg, 6); break;
-        case 0x13: CPU_16BIT_INC(m_ContextZ80.m_RegisterDE.reg, 6); break;
-        case 0x23: CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg, 6); break;
-        case 0x33: CPU_16BIT_INC(m_ContextZ80.m_StackPointer.reg, 6); break;
+        Z80_OP(0x03): CPU_16BIT_INC(m_ContextZ80.m_RegisterBC.reg); break;
+        Z80_OP(0x13): CPU_16BIT_INC(m_ContextZ80.m_RegisterDE.reg); break;
+        Z80_OP(0x23): CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x33): CPU_16BIT_INC(m_ContextZ80.m_StackPointer.reg); break;
 
         // dec 16-bit register
-        case 0x0B: CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg, 6); break;
-        case 0x1B: CPU_16BIT_DEC(m_ContextZ80.m_RegisterDE.reg, 6); break;
-        case 0x2B: CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg, 6); break;
-        case 0x3B: CPU_16BIT_DEC(m_ContextZ80.m_StackPointer.reg, 6); break;
+        Z80_OP(0x0B): CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg); break;
+        Z80_OP(0x1B): CPU_16BIT_DEC(m_ContextZ80.m_RegisterDE.reg); break;
+        Z80_OP(0x2B): CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x3B): CPU_16BIT_DEC(m_ContextZ80.m_StackPointer.reg); break;
 
         // jumps
-        case 0xE9: m_ContextZ80.m_OpcodeCycle=4; m_ContextZ80.m_ProgramCounter = m_ContextZ80.m_RegisterHL.reg; break;
-        case 0xC3: CPU_JUMP(false, 0, false); break;
-        case 0xC2: CPU_JUMP(true, FLAG_Z, false); break;
-        case 0xCA: CPU_JUMP(true, FLAG_Z, true); break;
-        case 0xD2: CPU_JUMP(true, FLAG_C, false); break;
-        case 0xDA: CPU_JUMP(true, FLAG_C, true); break;
-        case 0xFA: CPU_JUMP(true, FLAG_S, true); break;
-        case 0xF2: CPU_JUMP(true, FLAG_S, false); break;
-        case 0xE2: CPU_JUMP(true, FLAG_PV,false); break;
-        case 0xEA: CPU_JUMP(true, FLAG_PV,true); break;
-        case 0x10: CPU_DJNZ();break;
+        Z80_OP(0xE9): m_ContextZ80.m_ProgramCounter = m_ContextZ80.m_RegisterHL.reg; break;
+        Z80_OP(0xC3): CPU_JUMP(false, 0, false); break;
+        Z80_OP(0xC2): CPU_JUMP(true, FLAG_Z, false); break;
+        Z80_OP(0xCA): CPU_JUMP(true, FLAG_Z, true); break;
+        Z80_OP(0xD2): CPU_JUMP(true, FLAG_C, false); break;
+        Z80_OP(0xDA): CPU_JUMP(true, FLAG_C, true); break;
+        Z80_OP(0xFA): CPU_JUMP(true, FLAG_S, true); break;
+        Z80_OP(0xF2): CPU_JUMP(true, FLAG_S, false); break;
+        Z80_OP(0xE2): CPU_JUMP(true, FLAG_PV,false); break;
+        Z80_OP(0xEA): CPU_JUMP(true, FLAG_PV,true); break;
+        Z80_OP(0x10): CPU_DJNZ();break;
 
         // jump with immediate data
-        case 0x18 : CPU_JUMP_IMMEDIATE(false, 0, false); break;
-        case 0x20 : CPU_JUMP_IMMEDIATE(true, FLAG_Z, false);break;
-        case 0x28 : CPU_JUMP_IMMEDIATE(true, FLAG_Z, true);break;
-        case 0x30 : CPU_JUMP_IMMEDIATE(true, FLAG_C, false);break;
-        case 0x38 : CPU_JUMP_IMMEDIATE(true, FLAG_C, true);break;
+        Z80_OP(0x18): CPU_JUMP_IMMEDIATE(false, 0, false); break;
+        Z80_OP(0x20): CPU_JUMP_IMMEDIATE(true, FLAG_Z, false);break;
+        Z80_OP(0x28): CPU_JUMP_IMMEDIATE(true, FLAG_Z, true);break;
+        Z80_OP(0x30): CPU_JUMP_IMMEDIATE(true, FLAG_C, false);break;
+        Z80_OP(0x38): CPU_JUMP_IMMEDIATE(true, FLAG_C, true);break;
 
         // calls
-        case 0xCD : CPU_CALL(false, 0, false); break;
-        case 0xC4 : CPU_CALL(true, FLAG_Z, false);break;
-        case 0xCC : CPU_CALL(true, FLAG_Z, true);break;
-        case 0xD4 : CPU_CALL(true, FLAG_C, false);break;
-        case 0xDC : CPU_CALL(true, FLAG_C, true); break;
-        case 0xE4 : CPU_CALL(true, FLAG_PV, false); break;
-        case 0xEC : CPU_CALL(true, FLAG_PV, true); break;
-        case 0xF4 : CPU_CALL(true, FLAG_S, false); break;
-        case 0xFC : CPU_CALL(true, FLAG_S, true); break;
+        Z80_OP(0xCD): CPU_CALL(false, 0, false); break;
+        Z80_OP(0xC4): CPU_CALL(true, FLAG_Z, false);break;
+        Z80_OP(0xCC): CPU_CALL(true, FLAG_Z, true);break;
+        Z80_OP(0xD4): CPU_CALL(true, FLAG_C, false);break;
+        Z80_OP(0xDC): CPU_CALL(true, FLAG_C, true); break;
+        Z80_OP(0xE4): CPU_CALL(true, FLAG_PV, false); break;
+        Z80_OP(0xEC): CPU_CALL(true, FLAG_PV, true); break;
+        Z80_OP(0xF4): CPU_CALL(true, FLAG_S, false); break;
+        Z80_OP(0xFC): CPU_CALL(true, FLAG_S, true); break;
 
         // returns
-        case 0xC9: CPU_RETURN(false, 0, false); m_ContextZ80.m_OpcodeCycle = 10; break;
-        case 0xC0: CPU_RETURN(true, FLAG_Z, false); break;
-        case 0xC8: CPU_RETURN(true, FLAG_Z, true); break;
-        case 0xD0: CPU_RETURN(true, FLAG_C, false); break;
-        case 0xD8: CPU_RETURN(true, FLAG_C, true); break;
-        case 0xF8: CPU_RETURN(true, FLAG_S, true); break;
-        case 0xE8: CPU_RETURN(true, FLAG_PV, true); break;
-        case 0xE0: CPU_RETURN(true, FLAG_PV, false);break;
-        case 0xF0: CPU_RETURN(true, FLAG_S, false);break;
+        Z80_OP(0xC9): CPU_RETURN(false, 0, false); break;
+        Z80_OP(0xC0): CPU_RETURN(true, FLAG_Z, false); break;
+        Z80_OP(0xC8): CPU_RETURN(true, FLAG_Z, true); break;
+        Z80_OP(0xD0): CPU_RETURN(true, FLAG_C, false); break;
+        Z80_OP(0xD8): CPU_RETURN(true, FLAG_C, true); break;
+        Z80_OP(0xF8): CPU_RETURN(true, FLAG_S, true); break;
+        Z80_OP(0xE8): CPU_RETURN(true, FLAG_PV, true); break;
+        Z80_OP(0xE0): CPU_RETURN(true, FLAG_PV, false);break;
+        Z80_OP(0xF0): CPU_RETURN(true, FLAG_S, false);break;
 
         // restarts
-        case 0xC7: CPU_RESTARTS(0x00); break;
-        case 0xCF: CPU_RESTARTS(0x08); break;
-        case 0xD7: CPU_RESTARTS(0x10); break;
-        case 0xDF: CPU_RESTARTS(0x18); break;
-        case 0xE7: CPU_RESTARTS(0x20); break;
-        case 0xEF: CPU_RESTARTS(0x28); break;
-        case 0xF7: CPU_RESTARTS(0x30); break;
-        case 0xFF: CPU_RESTARTS(0x38); break;
+        Z80_OP(0xC7): CPU_RESTARTS(0x00); break;
+        Z80_OP(0xCF): CPU_RESTARTS(0x08); break;
+        Z80_OP(0xD7): CPU_RESTARTS(0x10); break;
+        Z80_OP(0xDF): CPU_RESTARTS(0x18); break;
+        Z80_OP(0xE7): CPU_RESTARTS(0x20); break;
+        Z80_OP(0xEF): CPU_RESTARTS(0x28); break;
+        Z80_OP(0xF7): CPU_RESTARTS(0x30); break;
+        Z80_OP(0xFF): CPU_RESTARTS(0x38); break;
 
         // rotates
-        case 0x07:CPU_RLC(m_ContextZ80.m_RegisterAF.hi,true); break;
-        case 0x0F:CPU_RRC(m_ContextZ80.m_RegisterAF.hi, true); break;
-        case 0x17:CPU_RL(m_ContextZ80.m_RegisterAF.hi, true); break;
-        case 0x1F:CPU_RR(m_ContextZ80.m_RegisterAF.hi, true); break;
+        Z80_OP(0x07):CPU_RLC(m_ContextZ80.m_RegisterAF.hi,true); break;
+        Z80_OP(0x0F):CPU_RRC(m_ContextZ80.m_RegisterAF.hi, true); break;
+        Z80_OP(0x17):CPU_RL(m_ContextZ80.m_RegisterAF.hi, true); break;
+        Z80_OP(0x1F):CPU_RR(m_ContextZ80.m_RegisterAF.hi, true); break;
 
-        case 0xCB: ExecuteCBOpcode(); break;
-        case 0xED: ExecuteEDOpcode(); break;
-        case 0xF3: m_ContextZ80.m_IFF1 = false; m_ContextZ80.m_IFF2 = false; m_ContextZ80.m_OpcodeCycle = 4; break;
+        Z80_OP(0xCB): ExecuteCBOpcode(); break;
+        Z80_OP(0xED): ExecuteEDOpcode(); break;
+        Z80_OP(0xF3): m_ContextZ80.m_IFF1 = false; m_ContextZ80.m_IFF2 = false; break;
 
-        case 0xD3: CPU_OUT_IMMEDIATE(m_ContextZ80.m_RegisterAF.hi); break;
-        case 0xDB: CPU_IN_IMMEDIATE(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0xD3): CPU_OUT_IMMEDIATE(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0xDB): CPU_IN_IMMEDIATE(m_ContextZ80.m_RegisterAF.hi); break;
 
         // exchanges
-        case 0xEB: CPU_EXCHANGE(m_ContextZ80.m_RegisterDE.reg, m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x08: CPU_EXCHANGE(m_ContextZ80.m_RegisterAF.reg, m_ContextZ80.m_RegisterAFPrime.reg); break;
+        Z80_OP(0xEB): CPU_EXCHANGE(m_ContextZ80.m_RegisterDE.reg, m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x08): CPU_EXCHANGE(m_ContextZ80.m_RegisterAF.reg, m_ContextZ80.m_RegisterAFPrime.reg); break;
 
-        case 0xFB: m_ContextZ80.m_EIPending = true; m_ContextZ80.m_OpcodeCycle = 4; break;
+        Z80_OP(0xFB): m_ContextZ80.m_EIPending = true; break;
 
-        case 0x22: CPU_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x22): CPU_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); break;
 
-        case 0x76: m_ContextZ80.m_Halted = true; m_ContextZ80.m_OpcodeCycle = 1; break;
+        Z80_OP(0x76): m_ContextZ80.m_Halted = true; break;
 
-        case 0xE3:
+        Z80_OP(0xE3):
         {
-            BYTE nhi = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_StackPointer.reg+1);
-            BYTE nlo = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_StackPointer.reg);
+            BYTE nhi = m_Bus.readMemory(m_ContextZ80.m_StackPointer.reg+1);
+            BYTE nlo = m_Bus.readMemory(m_ContextZ80.m_StackPointer.reg);
             BYTE h = m_ContextZ80.m_RegisterHL.hi;
             BYTE l = m_ContextZ80.m_RegisterHL.lo;
             m_ContextZ80.m_RegisterHL.hi = nhi;
             m_ContextZ80.m_RegisterHL.lo = nlo;
-            m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_StackPointer.reg+1, h);
-            m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_StackPointer.reg, l);
-            m_ContextZ80.m_OpcodeCycle = 19;
+            m_Bus.writeMemory(m_ContextZ80.m_StackPointer.reg+1, h);
+            m_Bus.writeMemory(m_ContextZ80.m_StackPointer.reg, l);
         }
         break;
 
 
-        case 0xDD: ExecuteDDFDOpcode(true); break;
-        case 0xFD: ExecuteDDFDOpcode(false); break;
+        Z80_OP(0xDD): ExecuteDDFDOpcode<true>(); break;
+        Z80_OP(0xFD): ExecuteDDFDOpcode<false>(); break;
 
-        case 0xD9:
+        Z80_OP(0xD9):
         {
             WORD bcTemp = m_ContextZ80.m_RegisterBC.reg;
             WORD deTemp = m_ContextZ80.m_RegisterDE.reg;
@@ -389,15 +524,13 @@ void Z80::ExecuteOpcode(const BYTE& opcode)
             m_ContextZ80.m_RegisterBCPrime.reg = bcTemp;
             m_ContextZ80.m_RegisterDEPrime.reg = deTemp;
             m_ContextZ80.m_RegisterHLPrime.reg = hlTemp;
-            m_ContextZ80.m_OpcodeCycle = 4;
 
         } break;
 
-        case 0x2A: CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x2A): CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); break;
 
-        case 0x2F:
+        Z80_OP(0x2F):
         {
-            m_ContextZ80.m_OpcodeCycle = 4;
             m_ContextZ80.m_RegisterAF.hi ^= 0xFF;
             m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
             m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
@@ -412,35 +545,31 @@ void Z80::ExecuteOpcode(const BYTE& opcode)
         }
         break;
 
-        case 0x3A:
+        Z80_OP(0x3A):
         {
             WORD nn = ReadWord();
             m_ContextZ80.m_ProgramCounter+=2;
-            m_ContextZ80.m_OpcodeCycle = 13;
-            m_ContextZ80.m_RegisterAF.hi = m_ContextZ80.m_FuncPtrRead(nn);
+            m_ContextZ80.m_RegisterAF.hi = m_Bus.readMemory(nn);
         }break;
 
-        case 0x32:
+        Z80_OP(0x32):
         {
             WORD nn = ReadWord();
             m_ContextZ80.m_ProgramCounter+=2;
-            m_ContextZ80.m_FuncPtrWrite(nn, m_ContextZ80.m_RegisterAF.hi);
-            m_ContextZ80.m_OpcodeCycle = 13;
+            m_Bus.writeMemory(nn, m_ContextZ80.m_RegisterAF.hi);
         }break;
 
-        case 0x36:
+        Z80_OP(0x36):
         {
-            m_ContextZ80.m_OpcodeCycle = 10;
-            BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+            BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
             m_ContextZ80.m_ProgramCounter++;
-            m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, n);
+            m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, n);
 
         } break;
 
         // complement the carry flag
-        case 0x3F:
+        Z80_OP(0x3F):
         {
-            m_ContextZ80.m_OpcodeCycle = 4;
             if (testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C))
             {
                 m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
@@ -455,12 +584,11 @@ void Z80::ExecuteOpcode(const BYTE& opcode)
             m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
         }break;
 
-        case 0x27: CPU_DAA(); break;
+        Z80_OP(0x27): CPU_DAA(); break;
 
-        case 0x37:
+        Z80_OP(0x37):
         {
             m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C); 
-            m_ContextZ80.m_OpcodeCycle = 4;
             m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
             m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N); 
         }
@@ -471,6 +599,7 @@ void Z80::ExecuteOpcode(const BYTE& opcode)
             char buffer[255];
             sprintf(buffer, "Unhandled opcode %x", opcode);
             LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+            DumpTrace();
             assert(false);
         }
         break;
@@ -479,308 +608,346 @@ void Z80::ExecuteOpcode(const BYTE& opcode)
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::ExecuteCBOpcode()
+template <class Bus>
+void Z80<Bus>::ExecuteCBOpcode()
 {
     IncreaseRReg();
 
-    BYTE opcode = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
-
-    LogInstInfo(opcode, "CB", false);
+    BYTE opcode = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
     m_ContextZ80.m_ProgramCounter++;
 
-
-
+    m_ContextZ80.m_OpcodeCycle = Z80CYCLES.CB.base[opcode];
 
  //   char buffer[255];
 //  sprintf(buffer, "Executing CB Opcode %x",opcode);
     //LogMessage::GetSingleton()->DoLogMessage(buffer,true);
 
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatchTable[256] =
+    {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+        &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+        &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+        &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+        &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+        &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+        &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+        &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_0xF4, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+        &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+    };
+    goto *dispatchTable[opcode];
+#endif
+
     switch(opcode)
     {
         // rotate left through carry
-        case 0x0 : CPU_RLC(m_ContextZ80.m_RegisterBC.hi,false); break;
-        case 0x1 : CPU_RLC(m_ContextZ80.m_RegisterBC.lo,false); break;
-        case 0x2 : CPU_RLC(m_ContextZ80.m_RegisterDE.hi,false); break;
-        case 0x3 : CPU_RLC(m_ContextZ80.m_RegisterDE.lo,false); break;
-        case 0x4 : CPU_RLC(m_ContextZ80.m_RegisterHL.hi,false); break;
-        case 0x5 : CPU_RLC(m_ContextZ80.m_RegisterHL.lo,false); break;
-        case 0x6 : CPU_RLC_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
-        case 0x7 : CPU_RLC(m_ContextZ80.m_RegisterAF.hi,false); break;
+        Z80_OP(0x00): CPU_RLC(m_ContextZ80.m_RegisterBC.hi,false); break;
+        Z80_OP(0x01): CPU_RLC(m_ContextZ80.m_RegisterBC.lo,false); break;
+        Z80_OP(0x02): CPU_RLC(m_ContextZ80.m_RegisterDE.hi,false); break;
+        Z80_OP(0x03): CPU_RLC(m_ContextZ80.m_RegisterDE.lo,false); break;
+        Z80_OP(0x04): CPU_RLC(m_ContextZ80.m_RegisterHL.hi,false); break;
+        Z80_OP(0x05): CPU_RLC(m_ContextZ80.m_RegisterHL.lo,false); break;
+        Z80_OP(0x06): CPU_RLC_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
+        Z80_OP(0x07): CPU_RLC(m_ContextZ80.m_RegisterAF.hi,false); break;
 
         // rotate right through carry
-        case 0x8 : CPU_RRC(m_ContextZ80.m_RegisterBC.hi,false); break;
-        case 0x9 : CPU_RRC(m_ContextZ80.m_RegisterBC.lo,false); break;
-        case 0xA : CPU_RRC(m_ContextZ80.m_RegisterDE.hi,false); break;
-        case 0xB : CPU_RRC(m_ContextZ80.m_RegisterDE.lo,false); break;
-        case 0xC : CPU_RRC(m_ContextZ80.m_RegisterHL.hi,false); break;
-        case 0xD : CPU_RRC(m_ContextZ80.m_RegisterHL.lo,false); break;
-        case 0xE : CPU_RRC_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
-        case 0xF : CPU_RRC(m_ContextZ80.m_RegisterAF.hi,false); break;
+        Z80_OP(0x08): CPU_RRC(m_ContextZ80.m_RegisterBC.hi,false); break;
+        Z80_OP(0x09): CPU_RRC(m_ContextZ80.m_RegisterBC.lo,false); break;
+        Z80_OP(0x0A): CPU_RRC(m_ContextZ80.m_RegisterDE.hi,false); break;
+        Z80_OP(0x0B): CPU_RRC(m_ContextZ80.m_RegisterDE.lo,false); break;
+        Z80_OP(0x0C): CPU_RRC(m_ContextZ80.m_RegisterHL.hi,false); break;
+        Z80_OP(0x0D): CPU_RRC(m_ContextZ80.m_RegisterHL.lo,false); break;
+        Z80_OP(0x0E): CPU_RRC_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
+        Z80_OP(0x0F): CPU_RRC(m_ContextZ80.m_RegisterAF.hi,false); break;
 
         // rotate left
-        case 0x10: CPU_RL(m_ContextZ80.m_RegisterBC.hi,false); break;
-        case 0x11: CPU_RL(m_ContextZ80.m_RegisterBC.lo,false); break;
-        case 0x12: CPU_RL(m_ContextZ80.m_RegisterDE.hi,false); break;
-        case 0x13: CPU_RL(m_ContextZ80.m_RegisterDE.lo,false); break;
-        case 0x14: CPU_RL(m_ContextZ80.m_RegisterHL.hi,false); break;
-        case 0x15: CPU_RL(m_ContextZ80.m_RegisterHL.lo,false); break;
-        case 0x16: CPU_RL_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
-        case 0x17: CPU_RL(m_ContextZ80.m_RegisterAF.hi,false); break;
+        Z80_OP(0x10): CPU_RL(m_ContextZ80.m_RegisterBC.hi,false); break;
+        Z80_OP(0x11): CPU_RL(m_ContextZ80.m_RegisterBC.lo,false); break;
+        Z80_OP(0x12): CPU_RL(m_ContextZ80.m_RegisterDE.hi,false); break;
+        Z80_OP(0x13): CPU_RL(m_ContextZ80.m_RegisterDE.lo,false); break;
+        Z80_OP(0x14): CPU_RL(m_ContextZ80.m_RegisterHL.hi,false); break;
+        Z80_OP(0x15): CPU_RL(m_ContextZ80.m_RegisterHL.lo,false); break;
+        Z80_OP(0x16): CPU_RL_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
+        Z80_OP(0x17): CPU_RL(m_ContextZ80.m_RegisterAF.hi,false); break;
 
         // rotate right
-        case 0x18: CPU_RR(m_ContextZ80.m_RegisterBC.hi,false); break;
-        case 0x19: CPU_RR(m_ContextZ80.m_RegisterBC.lo,false); break;
-        case 0x1A: CPU_RR(m_ContextZ80.m_RegisterDE.hi,false); break;
-        case 0x1B: CPU_RR(m_ContextZ80.m_RegisterDE.lo,false); break;
-        case 0x1C: CPU_RR(m_ContextZ80.m_RegisterHL.hi,false); break;
-        case 0x1D: CPU_RR(m_ContextZ80.m_RegisterHL.lo,false); break;
-        case 0x1E: CPU_RR_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
-        case 0x1F: CPU_RR(m_ContextZ80.m_RegisterAF.hi,false); break;
-
-        case 0x20 : CPU_SLA(m_ContextZ80.m_RegisterBC.hi);break;
-        case 0x21 : CPU_SLA(m_ContextZ80.m_RegisterBC.lo);break;
-        case 0x22 : CPU_SLA(m_ContextZ80.m_RegisterDE.hi);break;
-        case 0x23 : CPU_SLA(m_ContextZ80.m_RegisterDE.lo);break;
-        case 0x24 : CPU_SLA(m_ContextZ80.m_RegisterHL.hi);break;
-        case 0x25 : CPU_SLA(m_ContextZ80.m_RegisterHL.lo);break;
-        case 0x26 : CPU_SLA_MEMORY(m_ContextZ80.m_RegisterHL.reg);break;
-        case 0x27 : CPU_SLA(m_ContextZ80.m_RegisterAF.hi);break;
-
-        case 0x28 : CPU_SRA(m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x29 : CPU_SRA(m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x2A : CPU_SRA(m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x2B : CPU_SRA(m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x2C : CPU_SRA(m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x2D : CPU_SRA(m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x2E : CPU_SRA_MEMORY(m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x2F : CPU_SRA(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x18): CPU_RR(m_ContextZ80.m_RegisterBC.hi,false); break;
+        Z80_OP(0x19): CPU_RR(m_ContextZ80.m_RegisterBC.lo,false); break;
+        Z80_OP(0x1A): CPU_RR(m_ContextZ80.m_RegisterDE.hi,false); break;
+        Z80_OP(0x1B): CPU_RR(m_ContextZ80.m_RegisterDE.lo,false); break;
+        Z80_OP(0x1C): CPU_RR(m_ContextZ80.m_RegisterHL.hi,false); break;
+        Z80_OP(0x1D): CPU_RR(m_ContextZ80.m_RegisterHL.lo,false); break;
+        Z80_OP(0x1E): CPU_RR_MEMORY(m_ContextZ80.m_RegisterHL.reg,false); break;
+        Z80_OP(0x1F): CPU_RR(m_ContextZ80.m_RegisterAF.hi,false); break;
+
+        Z80_OP(0x20): CPU_SLA(m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x21): CPU_SLA(m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x22): CPU_SLA(m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x23): CPU_SLA(m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x24): CPU_SLA(m_ContextZ80.m_RegisterHL.hi);break;
+        Z80_OP(0x25): CPU_SLA(m_ContextZ80.m_RegisterHL.lo);break;
+        Z80_OP(0x26): CPU_SLA_MEMORY(m_ContextZ80.m_RegisterHL.reg);break;
+        Z80_OP(0x27): CPU_SLA(m_ContextZ80.m_RegisterAF.hi);break;
+
+        Z80_OP(0x28): CPU_SRA(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x29): CPU_SRA(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x2A): CPU_SRA(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x2B): CPU_SRA(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x2C): CPU_SRA(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x2D): CPU_SRA(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x2E): CPU_SRA_MEMORY(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x2F): CPU_SRA(m_ContextZ80.m_RegisterAF.hi); break;
 
         // shift left logical
-        case 0x30 : CPU_SLL(m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x31 : CPU_SLL(m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x32 : CPU_SLL(m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x33 : CPU_SLL(m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x34 : CPU_SLL(m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x35 : CPU_SLL(m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x36 : CPU_SLL_MEMORY(m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x37 : CPU_SLL(m_ContextZ80.m_RegisterAF.hi); break;
-
-
-        case 0x38 : CPU_SRL(m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x39 : CPU_SRL(m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x3A : CPU_SRL(m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x3B : CPU_SRL(m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x3C : CPU_SRL(m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x3D : CPU_SRL(m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x3E : CPU_SRL_MEMORY(m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x3F : CPU_SRL(m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0x30): CPU_SLL(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x31): CPU_SLL(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x32): CPU_SLL(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x33): CPU_SLL(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x34): CPU_SLL(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x35): CPU_SLL(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x36): CPU_SLL_MEMORY(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x37): CPU_SLL(m_ContextZ80.m_RegisterAF.hi); break;
+
+
+        Z80_OP(0x38): CPU_SRL(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x39): CPU_SRL(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x3A): CPU_SRL(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x3B): CPU_SRL(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x3C): CPU_SRL(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x3D): CPU_SRL(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x3E): CPU_SRL_MEMORY(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x3F): CPU_SRL(m_ContextZ80.m_RegisterAF.hi); break;
 
         // test bit
-        case 0x40 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 0 , 8); break;
-        case 0x41 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 0 , 8); break;
-        case 0x42 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 0 , 8); break;
-        case 0x43 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 0 , 8); break;
-        case 0x44 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 0 , 8); break;
-        case 0x45 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 0 , 8); break;
-        case 0x46 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 0 , 12); break;
-        case 0x47 : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 0 , 8); break;
-        case 0x48 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 1 , 8); break;
-        case 0x49 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 1 , 8); break;
-        case 0x4A : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 1 , 8); break;
-        case 0x4B : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 1 , 8); break;
-        case 0x4C : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 1 , 8); break;
-        case 0x4D : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 1 , 8); break;
-        case 0x4E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 1 , 12); break;
-        case 0x4F : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 1 , 8); break;
-        case 0x50 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 2 , 8); break;
-        case 0x51 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 2 , 8); break;
-        case 0x52 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 2 , 8); break;
-        case 0x53 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 2 , 8); break;
-        case 0x54 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 2 , 8); break;
-        case 0x55 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 2 , 8); break;
-        case 0x56 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 2 , 12); break;
-        case 0x57 : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 2 , 8); break;
-        case 0x58 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 3 , 8); break;
-        case 0x59 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 3 , 8); break;
-        case 0x5A : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 3 , 8); break;
-        case 0x5B : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 3 , 8); break;
-        case 0x5C : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 3 , 8); break;
-        case 0x5D : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 3 , 8); break;
-        case 0x5E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 3 , 12); break;
-        case 0x5F : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 3 , 8); break;
-        case 0x60 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 4 , 8); break;
-        case 0x61 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 4 , 8); break;
-        case 0x62 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 4 , 8); break;
-        case 0x63 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 4 , 8); break;
-        case 0x64 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 4 , 8); break;
-        case 0x65 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 4 , 8); break;
-        case 0x66 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 4 , 12); break;
-        case 0x67 : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 4 , 8); break;
-        case 0x68 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 5 , 8); break;
-        case 0x69 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 5 , 8); break;
-        case 0x6A : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 5 , 8); break;
-        case 0x6B : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 5 , 8); break;
-        case 0x6C : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 5 , 8); break;
-        case 0x6D : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 5 , 8); break;
-        case 0x6E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 5 , 12); break;
-        case 0x6F : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 5 , 8); break;
-        case 0x70 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 6 , 8); break;
-        case 0x71 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 6 , 8); break;
-        case 0x72 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 6 , 8); break;
-        case 0x73 : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 6 , 8); break;
-        case 0x74 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 6 , 8); break;
-        case 0x75 : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 6 , 8); break;
-        case 0x76 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 6 , 12); break;
-        case 0x77 : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 6 , 8); break;
-        case 0x78 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 7 , 8); break;
-        case 0x79 : CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 7 , 8); break;
-        case 0x7A : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 7 , 8); break;
-        case 0x7B : CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 7 , 8); break;
-        case 0x7C : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 7 , 8); break;
-        case 0x7D : CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 7 , 8); break;
-        case 0x7E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg), 7 , 12); break;
-        case 0x7F : CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 7 , 8); break;
+        Z80_OP(0x40): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ); break;
+        Z80_OP(0x41): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ); break;
+        Z80_OP(0x42): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ); break;
+        Z80_OP(0x43): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ); break;
+        Z80_OP(0x44): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ); break;
+        Z80_OP(0x45): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ); break;
+        Z80_OP(0x46): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 0 ); break;
+        Z80_OP(0x47): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ); break;
+        Z80_OP(0x48): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ); break;
+        Z80_OP(0x49): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ); break;
+        Z80_OP(0x4A): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ); break;
+        Z80_OP(0x4B): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ); break;
+        Z80_OP(0x4C): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ); break;
+        Z80_OP(0x4D): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ); break;
+        Z80_OP(0x4E): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 1 ); break;
+        Z80_OP(0x4F): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ); break;
+        Z80_OP(0x50): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ); break;
+        Z80_OP(0x51): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ); break;
+        Z80_OP(0x52): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ); break;
+        Z80_OP(0x53): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ); break;
+        Z80_OP(0x54): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ); break;
+        Z80_OP(0x55): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ); break;
+        Z80_OP(0x56): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 2 ); break;
+        Z80_OP(0x57): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ); break;
+        Z80_OP(0x58): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ); break;
+        Z80_OP(0x59): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ); break;
+        Z80_OP(0x5A): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ); break;
+        Z80_OP(0x5B): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ); break;
+        Z80_OP(0x5C): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ); break;
+        Z80_OP(0x5D): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ); break;
+        Z80_OP(0x5E): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 3 ); break;
+        Z80_OP(0x5F): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ); break;
+        Z80_OP(0x60): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ); break;
+        Z80_OP(0x61): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ); break;
+        Z80_OP(0x62): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ); break;
+        Z80_OP(0x63): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ); break;
+        Z80_OP(0x64): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ); break;
+        Z80_OP(0x65): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ); break;
+        Z80_OP(0x66): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 4 ); break;
+        Z80_OP(0x67): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ); break;
+        Z80_OP(0x68): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ); break;
+        Z80_OP(0x69): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ); break;
+        Z80_OP(0x6A): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ); break;
+        Z80_OP(0x6B): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ); break;
+        Z80_OP(0x6C): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ); break;
+        Z80_OP(0x6D): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ); break;
+        Z80_OP(0x6E): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 5 ); break;
+        Z80_OP(0x6F): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ); break;
+        Z80_OP(0x70): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ); break;
+        Z80_OP(0x71): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ); break;
+        Z80_OP(0x72): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ); break;
+        Z80_OP(0x73): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ); break;
+        Z80_OP(0x74): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ); break;
+        Z80_OP(0x75): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ); break;
+        Z80_OP(0x76): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 6 ); break;
+        Z80_OP(0x77): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ); break;
+        Z80_OP(0x78): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ); break;
+        Z80_OP(0x79): CPU_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ); break;
+        Z80_OP(0x7A): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ); break;
+        Z80_OP(0x7B): CPU_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ); break;
+        Z80_OP(0x7C): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ); break;
+        Z80_OP(0x7D): CPU_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ); break;
+        Z80_OP(0x7E): CPU_TEST_BIT(m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg), 7 ); break;
+        Z80_OP(0x7F): CPU_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ); break;
 
         // reset bit
-        case 0x80 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 0); break;
-        case 0x81 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 0); break;
-        case 0x82 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 0); break;
-        case 0x83 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 0); break;
-        case 0x84 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 0); break;
-        case 0x85 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 0); break;
-        case 0x86 : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 0); break;
-        case 0x87 : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 0); break;
-        case 0x88 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ); break;
-        case 0x89 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 1); break;
-        case 0x8A : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 1); break;
-        case 0x8B : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 1); break;
-        case 0x8C : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 1); break;
-        case 0x8D : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 1); break;
-        case 0x8E : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 1); break;
-        case 0x8F : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ); break;
-        case 0x90 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ); break;
-        case 0x91 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ); break;
-        case 0x92 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ); break;
-        case 0x93 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ); break;
-        case 0x94 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ); break;
-        case 0x95 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ); break;
-        case 0x96 : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 2); break;
-        case 0x97 : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ); break;
-        case 0x98 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ); break;
-        case 0x99 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ); break;
-        case 0x9A : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ); break;
-        case 0x9B : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ); break;
-        case 0x9C : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ); break;
-        case 0x9D : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ); break;
-        case 0x9E : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 3 ); break;
-        case 0x9F : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ); break;
-        case 0xA0 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ); break;
-        case 0xA1 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ); break;
-        case 0xA2 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ); break;
-        case 0xA3 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ); break;
-        case 0xA4 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ); break;
-        case 0xA5 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ); break;
-        case 0xA6 : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 4); break;
-        case 0xA7 : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 4); break;
-        case 0xA8 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 5); break;
-        case 0xA9 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 5); break;
-        case 0xAA : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 5); break;
-        case 0xAB : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 5); break;
-        case 0xAC : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 5); break;
-        case 0xAD : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 5); break;
-        case 0xAE : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 5); break;
-        case 0xAF : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ); break;
-        case 0xB0 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ); break;
-        case 0xB1 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ); break;
-        case 0xB2 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ); break;
-        case 0xB3 : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ); break;
-        case 0xB4 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ); break;
-        case 0xB5 : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ); break;
-        case 0xB6 : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 6); break;
-        case 0xB7 : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ); break;
-        case 0xB8 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ); break;
-        case 0xB9 : CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ); break;
-        case 0xBA : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ); break;
-        case 0xBB : CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ); break;
-        case 0xBC : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ); break;
-        case 0xBD : CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ); break;
-        case 0xBE : CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 7); break;
-        case 0xBF : CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 7); break;
+        Z80_OP(0x80): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 0); break;
+        Z80_OP(0x81): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 0); break;
+        Z80_OP(0x82): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 0); break;
+        Z80_OP(0x83): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 0); break;
+        Z80_OP(0x84): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 0); break;
+        Z80_OP(0x85): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 0); break;
+        Z80_OP(0x86): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 0); break;
+        Z80_OP(0x87): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 0); break;
+        Z80_OP(0x88): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ); break;
+        Z80_OP(0x89): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 1); break;
+        Z80_OP(0x8A): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 1); break;
+        Z80_OP(0x8B): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 1); break;
+        Z80_OP(0x8C): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 1); break;
+        Z80_OP(0x8D): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 1); break;
+        Z80_OP(0x8E): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 1); break;
+        Z80_OP(0x8F): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ); break;
+        Z80_OP(0x90): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ); break;
+        Z80_OP(0x91): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ); break;
+        Z80_OP(0x92): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ); break;
+        Z80_OP(0x93): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ); break;
+        Z80_OP(0x94): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ); break;
+        Z80_OP(0x95): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ); break;
+        Z80_OP(0x96): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 2); break;
+        Z80_OP(0x97): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ); break;
+        Z80_OP(0x98): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ); break;
+        Z80_OP(0x99): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ); break;
+        Z80_OP(0x9A): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ); break;
+        Z80_OP(0x9B): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ); break;
+        Z80_OP(0x9C): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ); break;
+        Z80_OP(0x9D): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ); break;
+        Z80_OP(0x9E): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 3 ); break;
+        Z80_OP(0x9F): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ); break;
+        Z80_OP(0xA0): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ); break;
+        Z80_OP(0xA1): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ); break;
+        Z80_OP(0xA2): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ); break;
+        Z80_OP(0xA3): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ); break;
+        Z80_OP(0xA4): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ); break;
+        Z80_OP(0xA5): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ); break;
+        Z80_OP(0xA6): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 4); break;
+        Z80_OP(0xA7): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 4); break;
+        Z80_OP(0xA8): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 5); break;
+        Z80_OP(0xA9): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 5); break;
+        Z80_OP(0xAA): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 5); break;
+        Z80_OP(0xAB): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 5); break;
+        Z80_OP(0xAC): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 5); break;
+        Z80_OP(0xAD): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 5); break;
+        Z80_OP(0xAE): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 5); break;
+        Z80_OP(0xAF): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ); break;
+        Z80_OP(0xB0): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ); break;
+        Z80_OP(0xB1): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ); break;
+        Z80_OP(0xB2): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ); break;
+        Z80_OP(0xB3): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ); break;
+        Z80_OP(0xB4): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ); break;
+        Z80_OP(0xB5): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ); break;
+        Z80_OP(0xB6): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 6); break;
+        Z80_OP(0xB7): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ); break;
+        Z80_OP(0xB8): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ); break;
+        Z80_OP(0xB9): CPU_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ); break;
+        Z80_OP(0xBA): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ); break;
+        Z80_OP(0xBB): CPU_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ); break;
+        Z80_OP(0xBC): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ); break;
+        Z80_OP(0xBD): CPU_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ); break;
+        Z80_OP(0xBE): CPU_RESET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 7); break;
+        Z80_OP(0xBF): CPU_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 7); break;
 
 
         // set bit
-        case 0xC0 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 0); break;
-        case 0xC1 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 0); break;
-        case 0xC2 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 0); break;
-        case 0xC3 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 0); break;
-        case 0xC4 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 0); break;
-        case 0xC5 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 0); break;
-        case 0xC6 : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 0); break;
-        case 0xC7 : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 0); break;
-        case 0xC8 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ); break;
-        case 0xC9 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 1); break;
-        case 0xCA : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 1); break;
-        case 0xCB : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 1); break;
-        case 0xCC : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 1); break;
-        case 0xCD : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 1); break;
-        case 0xCE : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 1); break;
-        case 0xCF : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ); break;
-        case 0xD0 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ); break;
-        case 0xD1 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ); break;
-        case 0xD2 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ); break;
-        case 0xD3 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ); break;
-        case 0xD4 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ); break;
-        case 0xD5 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ); break;
-        case 0xD6 : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 2); break;
-        case 0xD7 : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ); break;
-        case 0xD8 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ); break;
-        case 0xD9 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ); break;
-        case 0xDA : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ); break;
-        case 0xDB : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ); break;
-        case 0xDC : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ); break;
-        case 0xDD : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ); break;
-        case 0xDE : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 3 ); break;
-        case 0xDF : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ); break;
-        case 0xE0 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ); break;
-        case 0xE1 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ); break;
-        case 0xE2 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ); break;
-        case 0xE3 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ); break;
-        case 0xE4 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ); break;
-        case 0xE5 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ); break;
-        case 0xE6 : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 4); break;
-        case 0xE7 : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 4); break;
-        case 0xE8 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 5); break;
-        case 0xE9 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 5); break;
-        case 0xEA : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 5); break;
-        case 0xEB : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 5); break;
-        case 0xEC : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 5); break;
-        case 0xED : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 5); break;
-        case 0xEE : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 5); break;
-        case 0xEF : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ); break;
-        case 0xF0 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ); break;
-        case 0xF1 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ); break;
-        case 0xF2 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ); break;
-        case 0xF3 : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ); break;
-        case 0xF4 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ); break;
-        case 0xF5 : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ); break;
-        case 0xF6 : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 6); break;
-        case 0xF7 : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 6); break;
-        case 0xF8 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ); break;
-        case 0xF9 : CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ); break;
-        case 0xFA : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ); break;
-        case 0xFB : CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ); break;
-        case 0xFC : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ); break;
-        case 0xFD : CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ); break;
-        case 0xFE : CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 7); break;
-        case 0xFF : CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 7); break;
+        Z80_OP(0xC0): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 0); break;
+        Z80_OP(0xC1): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 0); break;
+        Z80_OP(0xC2): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 0); break;
+        Z80_OP(0xC3): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 0); break;
+        Z80_OP(0xC4): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 0); break;
+        Z80_OP(0xC5): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 0); break;
+        Z80_OP(0xC6): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 0); break;
+        Z80_OP(0xC7): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 0); break;
+        Z80_OP(0xC8): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ); break;
+        Z80_OP(0xC9): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 1); break;
+        Z80_OP(0xCA): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 1); break;
+        Z80_OP(0xCB): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 1); break;
+        Z80_OP(0xCC): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 1); break;
+        Z80_OP(0xCD): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 1); break;
+        Z80_OP(0xCE): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 1); break;
+        Z80_OP(0xCF): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ); break;
+        Z80_OP(0xD0): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ); break;
+        Z80_OP(0xD1): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ); break;
+        Z80_OP(0xD2): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ); break;
+        Z80_OP(0xD3): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ); break;
+        Z80_OP(0xD4): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ); break;
+        Z80_OP(0xD5): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ); break;
+        Z80_OP(0xD6): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 2); break;
+        Z80_OP(0xD7): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ); break;
+        Z80_OP(0xD8): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ); break;
+        Z80_OP(0xD9): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ); break;
+        Z80_OP(0xDA): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ); break;
+        Z80_OP(0xDB): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ); break;
+        Z80_OP(0xDC): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ); break;
+        Z80_OP(0xDD): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ); break;
+        Z80_OP(0xDE): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 3 ); break;
+        Z80_OP(0xDF): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ); break;
+        Z80_OP(0xE0): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ); break;
+        Z80_OP(0xE1): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ); break;
+        Z80_OP(0xE2): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ); break;
+        Z80_OP(0xE3): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ); break;
+        Z80_OP(0xE4): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ); break;
+        Z80_OP(0xE5): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ); break;
+        Z80_OP(0xE6): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 4); break;
+        Z80_OP(0xE7): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 4); break;
+        Z80_OP(0xE8): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 5); break;
+        Z80_OP(0xE9): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 5); break;
+        Z80_OP(0xEA): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 5); break;
+        Z80_OP(0xEB): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 5); break;
+        Z80_OP(0xEC): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 5); break;
+        Z80_OP(0xED): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 5); break;
+        Z80_OP(0xEE): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 5); break;
+        Z80_OP(0xEF): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ); break;
+        Z80_OP(0xF0): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ); break;
+        Z80_OP(0xF1): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ); break;
+        Z80_OP(0xF2): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ); break;
+        Z80_OP(0xF3): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ); break;
+        Z80_OP(0xF4): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ); break;
+        Z80_OP(0xF5): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ); break;
+        Z80_OP(0xF6): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 6); break;
+        Z80_OP(0xF7): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 6); break;
+        Z80_OP(0xF8): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ); break;
+        Z80_OP(0xF9): CPU_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ); break;
+        Z80_OP(0xFA): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ); break;
+        Z80_OP(0xFB): CPU_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ); break;
+        Z80_OP(0xFC): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ); break;
+        Z80_OP(0xFD): CPU_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ); break;
+        Z80_OP(0xFE): CPU_SET_BIT_MEMORY(m_ContextZ80.m_RegisterHL.reg, 7); break;
+        Z80_OP(0xFF): CPU_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 7); break;
 
         default:
         {
             char buffer[255];
             sprintf(buffer, "Unhandled CB opcode %x", opcode);
             LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+            DumpTrace();
             assert(false);
         }
         break;
@@ -789,102 +956,143 @@ void Z80::ExecuteCBOpcode()
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::ExecuteDDFDCBOpcode(bool isDD)
+template <class Bus>
+template <bool isDD>
+void Z80<Bus>::ExecuteDDFDCBOpcode()
 {
 
-    SIGNED_BYTE displacement = (SIGNED_BYTE)m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
-
-    LogInstInfo(displacement, "DDFDCB displacement", false);
+    SIGNED_BYTE displacement = (SIGNED_BYTE)m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
     m_ContextZ80.m_ProgramCounter++;
 
 
-    BYTE opcode = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
-
-    LogInstInfo(opcode, "DDFDCB opcode", false);
+    BYTE opcode = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
     m_ContextZ80.m_ProgramCounter++;
 
-    REGISTERZ80& reg = (isDD) ? m_ContextZ80.m_RegisterIX : m_ContextZ80.m_RegisterIY;
+    m_ContextZ80.m_OpcodeCycle = Z80CYCLES.DDFDCB.base[opcode];
+
+    //every DDFDCB opcode works on (IX+d) or (IY+d)
+    const REGISTERZ80& reg = (isDD) ? m_ContextZ80.m_RegisterIX : m_ContextZ80.m_RegisterIY;
+    const WORD address = reg.reg + displacement;
+
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatchTable[256] =
+    {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+        &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+        &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+        &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+        &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+        &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+        &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+        &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_0xF4, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+        &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+    };
+    goto *dispatchTable[opcode];
+#endif
 
     switch(opcode)
     {
-        case 0x0 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement); break;
-        case 0x1 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement); break;
-        case 0x2 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement); break;
-        case 0x3 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement); break;
-        case 0x4 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement); break;
-        case 0x5 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement); break;
-        case 0x6 : CPU_RLC_MEMORY(reg.reg + displacement,false); m_ContextZ80.m_OpcodeCycle =23; break;
-        case 0x7 : CPU_DDFD_RLC(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement); break;
+        Z80_OP(0x00): CPU_DDFD_RLC(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x01): CPU_DDFD_RLC(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x02): CPU_DDFD_RLC(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x03): CPU_DDFD_RLC(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x04): CPU_DDFD_RLC(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x05): CPU_DDFD_RLC(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x06): CPU_RLC_MEMORY(address,false); break;
+        Z80_OP(0x07): CPU_DDFD_RLC(m_ContextZ80.m_RegisterAF.hi, address); break;
 
         // rotate right through carry
-        case 0x8 : CPU_DDFD_RRC(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement); break;
-        case 0x9 : CPU_DDFD_RRC(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement); break;
-        case 0xA : CPU_DDFD_RRC(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement); break;
-        case 0xB : CPU_DDFD_RRC(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement); break;
-        case 0xC : CPU_DDFD_RRC(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement); break;
-        case 0xD : CPU_DDFD_RRC(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement); break;
-        case 0xE : CPU_RRC_MEMORY(reg.reg + displacement,false); m_ContextZ80.m_OpcodeCycle = 23; break;
-        case 0xF : CPU_DDFD_RRC(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement); break;
+        Z80_OP(0x08): CPU_DDFD_RRC(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x09): CPU_DDFD_RRC(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x0A): CPU_DDFD_RRC(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x0B): CPU_DDFD_RRC(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x0C): CPU_DDFD_RRC(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x0D): CPU_DDFD_RRC(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x0E): CPU_RRC_MEMORY(address,false); break;
+        Z80_OP(0x0F): CPU_DDFD_RRC(m_ContextZ80.m_RegisterAF.hi, address); break;
 
         // rotate left
-        case 0x10: CPU_DDFD_RL(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement); break;
-        case 0x11: CPU_DDFD_RL(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement); break;
-        case 0x12: CPU_DDFD_RL(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement); break;
-        case 0x13: CPU_DDFD_RL(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement); break;
-        case 0x14: CPU_DDFD_RL(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement); break;
-        case 0x15: CPU_DDFD_RL(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement); break;
-        case 0x16: CPU_RL_MEMORY(reg.reg+displacement,false); m_ContextZ80.m_OpcodeCycle=23; break;
-        case 0x17: CPU_DDFD_RL(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement); break;
+        Z80_OP(0x10): CPU_DDFD_RL(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x11): CPU_DDFD_RL(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x12): CPU_DDFD_RL(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x13): CPU_DDFD_RL(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x14): CPU_DDFD_RL(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x15): CPU_DDFD_RL(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x16): CPU_RL_MEMORY(address,false); break;
+        Z80_OP(0x17): CPU_DDFD_RL(m_ContextZ80.m_RegisterAF.hi, address); break;
 
         // rotate right
-        case 0x18: CPU_DDFD_RR(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement); break;
-        case 0x19: CPU_DDFD_RR(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement); break;
-        case 0x1A: CPU_DDFD_RR(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement); break;
-        case 0x1B: CPU_DDFD_RR(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement); break;
-        case 0x1C: CPU_DDFD_RR(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement); break;
-        case 0x1D: CPU_DDFD_RR(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement); break;
-        case 0x1E: CPU_RR_MEMORY(reg.reg + displacement,false); m_ContextZ80.m_OpcodeCycle=23;break;
-        case 0x1F: CPU_DDFD_RR(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement); break;
-
-        case 0x20 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement);break;
-        case 0x21 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement);break;
-        case 0x22 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement);break;
-        case 0x23 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement);break;
-        case 0x24 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement);break;
-        case 0x25 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement);break;
-        case 0x26 : CPU_SLA_MEMORY(reg.reg + displacement); m_ContextZ80.m_OpcodeCycle=23;break;
-        case 0x27 : CPU_DDFD_SLA(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement);break;
-
-        case 0x28 : CPU_DDFD_SRA(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement); break;
-        case 0x29 : CPU_DDFD_SRA(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement); break;
-        case 0x2A : CPU_DDFD_SRA(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement); break;
-        case 0x2B : CPU_DDFD_SRA(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement); break;
-        case 0x2C : CPU_DDFD_SRA(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement); break;
-        case 0x2D : CPU_DDFD_SRA(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement); break;
-        case 0x2E : CPU_SRA_MEMORY(reg.reg + displacement);m_ContextZ80.m_OpcodeCycle=23; break;
-        case 0x2F : CPU_DDFD_SRA(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement); break;
+        Z80_OP(0x18): CPU_DDFD_RR(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x19): CPU_DDFD_RR(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x1A): CPU_DDFD_RR(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x1B): CPU_DDFD_RR(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x1C): CPU_DDFD_RR(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x1D): CPU_DDFD_RR(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x1E): CPU_RR_MEMORY(address,false);break;
+        Z80_OP(0x1F): CPU_DDFD_RR(m_ContextZ80.m_RegisterAF.hi, address); break;
+
+        Z80_OP(0x20): CPU_DDFD_SLA(m_ContextZ80.m_RegisterBC.hi, address);break;
+        Z80_OP(0x21): CPU_DDFD_SLA(m_ContextZ80.m_RegisterBC.lo, address);break;
+        Z80_OP(0x22): CPU_DDFD_SLA(m_ContextZ80.m_RegisterDE.hi, address);break;
+        Z80_OP(0x23): CPU_DDFD_SLA(m_ContextZ80.m_RegisterDE.lo, address);break;
+        Z80_OP(0x24): CPU_DDFD_SLA(m_ContextZ80.m_RegisterHL.hi, address);break;
+        Z80_OP(0x25): CPU_DDFD_SLA(m_ContextZ80.m_RegisterHL.lo, address);break;
+        Z80_OP(0x26): CPU_SLA_MEMORY(address);break;
+        Z80_OP(0x27): CPU_DDFD_SLA(m_ContextZ80.m_RegisterAF.hi, address);break;
+
+        Z80_OP(0x28): CPU_DDFD_SRA(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x29): CPU_DDFD_SRA(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x2A): CPU_DDFD_SRA(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x2B): CPU_DDFD_SRA(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x2C): CPU_DDFD_SRA(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x2D): CPU_DDFD_SRA(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x2E): CPU_SRA_MEMORY(address); break;
+        Z80_OP(0x2F): CPU_DDFD_SRA(m_ContextZ80.m_RegisterAF.hi, address); break;
 
         // shift left logical
-        case 0x30 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterBC.hi, reg.reg,displacement); break;
-        case 0x31 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterBC.lo, reg.reg,displacement); break;
-        case 0x32 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterDE.hi, reg.reg,displacement); break;
-        case 0x33 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterDE.lo, reg.reg,displacement); break;
-        case 0x34 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterHL.hi, reg.reg,displacement); break;
-        case 0x35 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterHL.lo, reg.reg,displacement); break;
-        case 0x36 : CPU_SLL_MEMORY(reg.reg + displacement); m_ContextZ80.m_OpcodeCycle = 23; break;
-        case 0x37 : CPU_DDFD_SLL(m_ContextZ80.m_RegisterAF.hi, reg.reg,displacement); break;
-
-
-        case 0x38 : CPU_DDFD_SRL(m_ContextZ80.m_RegisterBC.hi, reg.reg, displacement); break;
-        case 0x39 : CPU_DDFD_SRL(m_ContextZ80.m_RegisterBC.lo, reg.reg, displacement); break;
-        case 0x3A : CPU_DDFD_SRL(m_ContextZ80.m_RegisterDE.hi, reg.reg, displacement); break;
-        case 0x3B : CPU_DDFD_SRL(m_ContextZ80.m_RegisterDE.lo, reg.reg, displacement); break;
-        case 0x3C : CPU_DDFD_SRL(m_ContextZ80.m_RegisterHL.hi, reg.reg, displacement); break;
-        case 0x3D : CPU_DDFD_SRL(m_ContextZ80.m_RegisterHL.lo, reg.reg, displacement); break;
-        case 0x3E : CPU_SRL_MEMORY(reg.reg + displacement); m_ContextZ80.m_OpcodeCycle=23; break;
-        case 0x3F : CPU_DDFD_SRL(m_ContextZ80.m_RegisterAF.hi, reg.reg, displacement); break;
+        Z80_OP(0x30): CPU_DDFD_SLL(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x31): CPU_DDFD_SLL(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x32): CPU_DDFD_SLL(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x33): CPU_DDFD_SLL(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x34): CPU_DDFD_SLL(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x35): CPU_DDFD_SLL(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x36): CPU_SLL_MEMORY(address); break;
+        Z80_OP(0x37): CPU_DDFD_SLL(m_ContextZ80.m_RegisterAF.hi, address); break;
+
+
+        Z80_OP(0x38): CPU_DDFD_SRL(m_ContextZ80.m_RegisterBC.hi, address); break;
+        Z80_OP(0x39): CPU_DDFD_SRL(m_ContextZ80.m_RegisterBC.lo, address); break;
+        Z80_OP(0x3A): CPU_DDFD_SRL(m_ContextZ80.m_RegisterDE.hi, address); break;
+        Z80_OP(0x3B): CPU_DDFD_SRL(m_ContextZ80.m_RegisterDE.lo, address); break;
+        Z80_OP(0x3C): CPU_DDFD_SRL(m_ContextZ80.m_RegisterHL.hi, address); break;
+        Z80_OP(0x3D): CPU_DDFD_SRL(m_ContextZ80.m_RegisterHL.lo, address); break;
+        Z80_OP(0x3E): CPU_SRL_MEMORY(address); break;
+        Z80_OP(0x3F): CPU_DDFD_SRL(m_ContextZ80.m_RegisterAF.hi, address); break;
 
 
         
@@ -893,203 +1101,203 @@ void Z80::ExecuteDDFDCBOpcode(bool isDD)
 
 
         // test bit
-        case 0x40 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ,   reg.reg, displacement); break;
-        case 0x41 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ,   reg.reg, displacement); break;
-        case 0x42 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ,   reg.reg, displacement); break;
-        case 0x43 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ,   reg.reg, displacement); break;
-        case 0x44 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ,   reg.reg, displacement); break;
-        case 0x45 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ,   reg.reg, displacement); break;
-        case 0x46 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 0 , 4); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x47 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ,   reg.reg, displacement); break;
-        case 0x48 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ,   reg.reg, displacement); break;
-        case 0x49 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ,   reg.reg, displacement); break;
-        case 0x4A : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ,   reg.reg, displacement); break;
-        case 0x4B : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ,   reg.reg, displacement); break;
-        case 0x4C : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ,   reg.reg, displacement); break;
-        case 0x4D : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ,   reg.reg, displacement); break;
-        case 0x4E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 1 , 4); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x4F : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ,   reg.reg, displacement); break;
-        case 0x50 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ,   reg.reg, displacement); break;
-        case 0x51 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ,   reg.reg, displacement); break;
-        case 0x52 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ,   reg.reg, displacement); break;
-        case 0x53 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ,   reg.reg, displacement); break;
-        case 0x54 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ,   reg.reg, displacement); break;
-        case 0x55 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ,   reg.reg, displacement); break;
-        case 0x56 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 2 , 4); m_ContextZ80.m_OpcodeCycle = 20;  break;
-        case 0x57 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ,   reg.reg, displacement); break;
-        case 0x58 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ,   reg.reg, displacement); break;
-        case 0x59 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ,   reg.reg, displacement); break;
-        case 0x5A : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ,   reg.reg, displacement); break;
-        case 0x5B : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ,   reg.reg, displacement); break;
-        case 0x5C : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ,   reg.reg, displacement); break;
-        case 0x5D : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ,   reg.reg, displacement); break;
-        case 0x5E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 3 , 4); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x5F : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ,   reg.reg, displacement); break;
-        case 0x60 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ,   reg.reg, displacement); break;
-        case 0x61 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ,   reg.reg, displacement); break;
-        case 0x62 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ,   reg.reg, displacement); break;
-        case 0x63 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ,   reg.reg, displacement); break;
-        case 0x64 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ,   reg.reg, displacement); break;
-        case 0x65 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ,   reg.reg, displacement); break;
-        case 0x66 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 4 , 4); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x67 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ,   reg.reg, displacement); break;
-        case 0x68 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ,   reg.reg, displacement); break;
-        case 0x69 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ,   reg.reg, displacement); break;
-        case 0x6A : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ,   reg.reg, displacement); break;
-        case 0x6B : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ,   reg.reg, displacement); break;
-        case 0x6C : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ,   reg.reg, displacement); break;
-        case 0x6D : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ,   reg.reg, displacement); break;
-        case 0x6E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 5 , 4); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x6F : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ,   reg.reg, displacement); break;
-        case 0x70 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ,   reg.reg, displacement); break;
-        case 0x71 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ,   reg.reg, displacement); break;
-        case 0x72 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ,   reg.reg, displacement); break;
-        case 0x73 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ,   reg.reg, displacement); break;
-        case 0x74 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ,   reg.reg, displacement); break;
-        case 0x75 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ,   reg.reg, displacement); break;
-        case 0x76 : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 6 , 4); m_ContextZ80.m_OpcodeCycle = 20;  break;
-        case 0x77 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ,   reg.reg, displacement); break;
-        case 0x78 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ,   reg.reg, displacement); break;
-        case 0x79 : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ,   reg.reg, displacement); break;
-        case 0x7A : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ,   reg.reg, displacement); break;
-        case 0x7B : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ,   reg.reg, displacement); break;
-        case 0x7C : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ,   reg.reg, displacement); break;
-        case 0x7D : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ,   reg.reg, displacement); break;
-        case 0x7E : CPU_TEST_BIT(m_ContextZ80.m_FuncPtrRead(reg.reg+displacement), 7 , 4); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x7F : CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ,   reg.reg, displacement); break;
+        Z80_OP(0x40): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ,   address); break;
+        Z80_OP(0x41): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ,   address); break;
+        Z80_OP(0x42): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ,   address); break;
+        Z80_OP(0x43): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ,   address); break;
+        Z80_OP(0x44): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ,   address); break;
+        Z80_OP(0x45): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ,   address); break;
+        Z80_OP(0x46): CPU_TEST_BIT(m_Bus.readMemory(address), 0 ); break;
+        Z80_OP(0x47): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ,   address); break;
+        Z80_OP(0x48): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 1 ,   address); break;
+        Z80_OP(0x49): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ,   address); break;
+        Z80_OP(0x4A): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ,   address); break;
+        Z80_OP(0x4B): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ,   address); break;
+        Z80_OP(0x4C): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ,   address); break;
+        Z80_OP(0x4D): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ,   address); break;
+        Z80_OP(0x4E): CPU_TEST_BIT(m_Bus.readMemory(address), 1 ); break;
+        Z80_OP(0x4F): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 1 ,   address); break;
+        Z80_OP(0x50): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 2 ,   address); break;
+        Z80_OP(0x51): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 2 ,   address); break;
+        Z80_OP(0x52): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 2 ,   address); break;
+        Z80_OP(0x53): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 2 ,   address); break;
+        Z80_OP(0x54): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 2 ,   address); break;
+        Z80_OP(0x55): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 2 ,   address); break;
+        Z80_OP(0x56): CPU_TEST_BIT(m_Bus.readMemory(address), 2 );  break;
+        Z80_OP(0x57): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 2 ,   address); break;
+        Z80_OP(0x58): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 3 ,   address); break;
+        Z80_OP(0x59): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 3 ,   address); break;
+        Z80_OP(0x5A): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 3 ,   address); break;
+        Z80_OP(0x5B): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 3 ,   address); break;
+        Z80_OP(0x5C): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 3 ,   address); break;
+        Z80_OP(0x5D): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 3 ,   address); break;
+        Z80_OP(0x5E): CPU_TEST_BIT(m_Bus.readMemory(address), 3 ); break;
+        Z80_OP(0x5F): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 3 ,   address); break;
+        Z80_OP(0x60): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 4 ,   address); break;
+        Z80_OP(0x61): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 4 ,   address); break;
+        Z80_OP(0x62): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 4 ,   address); break;
+        Z80_OP(0x63): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 4 ,   address); break;
+        Z80_OP(0x64): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 4 ,   address); break;
+        Z80_OP(0x65): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 4 ,   address); break;
+        Z80_OP(0x66): CPU_TEST_BIT(m_Bus.readMemory(address), 4 ); break;
+        Z80_OP(0x67): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ,   address); break;
+        Z80_OP(0x68): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ,   address); break;
+        Z80_OP(0x69): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ,   address); break;
+        Z80_OP(0x6A): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ,   address); break;
+        Z80_OP(0x6B): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ,   address); break;
+        Z80_OP(0x6C): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ,   address); break;
+        Z80_OP(0x6D): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ,   address); break;
+        Z80_OP(0x6E): CPU_TEST_BIT(m_Bus.readMemory(address), 5 ); break;
+        Z80_OP(0x6F): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 5 ,   address); break;
+        Z80_OP(0x70): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 6 ,   address); break;
+        Z80_OP(0x71): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 6 ,   address); break;
+        Z80_OP(0x72): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 6 ,   address); break;
+        Z80_OP(0x73): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 6 ,   address); break;
+        Z80_OP(0x74): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 6 ,   address); break;
+        Z80_OP(0x75): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 6 ,   address); break;
+        Z80_OP(0x76): CPU_TEST_BIT(m_Bus.readMemory(address), 6 );  break;
+        Z80_OP(0x77): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ,   address); break;
+        Z80_OP(0x78): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.hi, 7 ,   address); break;
+        Z80_OP(0x79): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterBC.lo, 7 ,   address); break;
+        Z80_OP(0x7A): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.hi, 7 ,   address); break;
+        Z80_OP(0x7B): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterDE.lo, 7 ,   address); break;
+        Z80_OP(0x7C): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.hi, 7 ,   address); break;
+        Z80_OP(0x7D): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterHL.lo, 7 ,   address); break;
+        Z80_OP(0x7E): CPU_TEST_BIT(m_Bus.readMemory(address), 7 ); break;
+        Z80_OP(0x7F): CPU_DDFD_TEST_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ,   address); break;
 
         // reset bit
-        case 0x80 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ,  reg.reg, displacement); break;
-        case 0x81 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ,  reg.reg, displacement); break;
-        case 0x82 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ,  reg.reg, displacement); break;
-        case 0x83 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ,  reg.reg, displacement); break;
-        case 0x84 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ,  reg.reg, displacement); break;
-        case 0x85 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ,  reg.reg, displacement); break;
-        case 0x86 : CPU_RESET_BIT_MEMORY(reg.reg + displacement, 0); m_ContextZ80.m_OpcodeCycle = 23;break;
-        case 0x87 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ,  reg.reg, displacement); break;
-        case 0x88 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 1  ,  reg.reg, displacement); break;
-        case 0x89 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ,  reg.reg, displacement); break;
-        case 0x8A : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ,  reg.reg, displacement); break;
-        case 0x8B : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ,  reg.reg, displacement); break;
-        case 0x8C : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ,  reg.reg, displacement); break;
-        case 0x8D : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ,  reg.reg, displacement); break;
-        case 0x8E : CPU_RESET_BIT_MEMORY(reg.reg + displacement, 1); m_ContextZ80.m_OpcodeCycle =23;break;
-        case 0x8F : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 1  ,  reg.reg, displacement); break;
-        case 0x90 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 2  ,  reg.reg, displacement); break;
-        case 0x91 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 2  ,  reg.reg, displacement); break;
-        case 0x92 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 2  ,  reg.reg, displacement); break;
-        case 0x93 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 2  ,  reg.reg, displacement); break;
-        case 0x94 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 2  ,  reg.reg, displacement); break;
-        case 0x95 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 2  ,  reg.reg, displacement); break;
-        case 0x96 : CPU_RESET_BIT_MEMORY(reg.reg+displacement, 2); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0x97 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 2  ,  reg.reg, displacement); break;
-        case 0x98 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 3  ,  reg.reg, displacement); break;
-        case 0x99 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 3  ,  reg.reg, displacement); break;
-        case 0x9A : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 3  ,  reg.reg, displacement); break;
-        case 0x9B : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 3  ,  reg.reg, displacement); break;
-        case 0x9C : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 3  ,  reg.reg, displacement); break;
-        case 0x9D : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 3  ,  reg.reg, displacement); break;
-        case 0x9E : CPU_RESET_BIT_MEMORY(reg.reg+displacement, 3 ); m_ContextZ80.m_OpcodeCycle = 23; break;
-        case 0x9F : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 3  ,  reg.reg, displacement); break;
-        case 0xA0 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 4  ,  reg.reg, displacement); break;
-        case 0xA1 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 4  ,  reg.reg, displacement); break;
-        case 0xA2 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 4  ,  reg.reg, displacement); break;
-        case 0xA3 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 4  ,  reg.reg, displacement); break;
-        case 0xA4 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 4  ,  reg.reg, displacement); break;
-        case 0xA5 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 4  ,  reg.reg, displacement); break;
-        case 0xA6 : CPU_RESET_BIT_MEMORY(reg.reg+displacement, 4); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xA7 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ,  reg.reg, displacement); break;
-        case 0xA8 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ,  reg.reg, displacement); break;
-        case 0xA9 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ,  reg.reg, displacement); break;
-        case 0xAA : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ,  reg.reg, displacement); break;
-        case 0xAB : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ,  reg.reg, displacement); break;
-        case 0xAC : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ,  reg.reg, displacement); break;
-        case 0xAD : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ,  reg.reg, displacement); break;
-        case 0xAE : CPU_RESET_BIT_MEMORY(reg.reg+displacement, 5); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xAF : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 5  ,  reg.reg, displacement); break;
-        case 0xB0 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 6  ,  reg.reg, displacement); break;
-        case 0xB1 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 6  ,  reg.reg, displacement); break;
-        case 0xB2 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 6  ,  reg.reg, displacement); break;
-        case 0xB3 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 6  ,  reg.reg, displacement); break;
-        case 0xB4 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 6  ,  reg.reg, displacement); break;
-        case 0xB5 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 6  ,  reg.reg, displacement); break;
-        case 0xB6 : CPU_RESET_BIT_MEMORY(reg.reg+displacement, 6); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xB7 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 6  ,  reg.reg, displacement); break;
-        case 0xB8 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 7  ,  reg.reg, displacement); break;
-        case 0xB9 : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 7  ,  reg.reg, displacement); break;
-        case 0xBA : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 7  ,  reg.reg, displacement); break;
-        case 0xBB : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 7  ,  reg.reg, displacement); break;
-        case 0xBC : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 7  ,  reg.reg, displacement); break;
-        case 0xBD : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 7  ,  reg.reg, displacement); break;
-        case 0xBE : CPU_RESET_BIT_MEMORY(reg.reg+displacement, 7); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xBF : CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ,  reg.reg, displacement); break;
+        Z80_OP(0x80): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ,  address); break;
+        Z80_OP(0x81): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ,  address); break;
+        Z80_OP(0x82): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ,  address); break;
+        Z80_OP(0x83): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ,  address); break;
+        Z80_OP(0x84): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ,  address); break;
+        Z80_OP(0x85): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ,  address); break;
+        Z80_OP(0x86): CPU_RESET_BIT_MEMORY(address, 0);break;
+        Z80_OP(0x87): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ,  address); break;
+        Z80_OP(0x88): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 1  ,  address); break;
+        Z80_OP(0x89): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ,  address); break;
+        Z80_OP(0x8A): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ,  address); break;
+        Z80_OP(0x8B): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ,  address); break;
+        Z80_OP(0x8C): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ,  address); break;
+        Z80_OP(0x8D): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ,  address); break;
+        Z80_OP(0x8E): CPU_RESET_BIT_MEMORY(address, 1);break;
+        Z80_OP(0x8F): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 1  ,  address); break;
+        Z80_OP(0x90): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 2  ,  address); break;
+        Z80_OP(0x91): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 2  ,  address); break;
+        Z80_OP(0x92): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 2  ,  address); break;
+        Z80_OP(0x93): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 2  ,  address); break;
+        Z80_OP(0x94): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 2  ,  address); break;
+        Z80_OP(0x95): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 2  ,  address); break;
+        Z80_OP(0x96): CPU_RESET_BIT_MEMORY(address, 2);  break;
+        Z80_OP(0x97): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 2  ,  address); break;
+        Z80_OP(0x98): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 3  ,  address); break;
+        Z80_OP(0x99): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 3  ,  address); break;
+        Z80_OP(0x9A): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 3  ,  address); break;
+        Z80_OP(0x9B): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 3  ,  address); break;
+        Z80_OP(0x9C): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 3  ,  address); break;
+        Z80_OP(0x9D): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 3  ,  address); break;
+        Z80_OP(0x9E): CPU_RESET_BIT_MEMORY(address, 3 ); break;
+        Z80_OP(0x9F): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 3  ,  address); break;
+        Z80_OP(0xA0): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 4  ,  address); break;
+        Z80_OP(0xA1): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 4  ,  address); break;
+        Z80_OP(0xA2): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 4  ,  address); break;
+        Z80_OP(0xA3): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 4  ,  address); break;
+        Z80_OP(0xA4): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 4  ,  address); break;
+        Z80_OP(0xA5): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 4  ,  address); break;
+        Z80_OP(0xA6): CPU_RESET_BIT_MEMORY(address, 4);  break;
+        Z80_OP(0xA7): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ,  address); break;
+        Z80_OP(0xA8): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ,  address); break;
+        Z80_OP(0xA9): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ,  address); break;
+        Z80_OP(0xAA): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ,  address); break;
+        Z80_OP(0xAB): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ,  address); break;
+        Z80_OP(0xAC): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ,  address); break;
+        Z80_OP(0xAD): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ,  address); break;
+        Z80_OP(0xAE): CPU_RESET_BIT_MEMORY(address, 5);  break;
+        Z80_OP(0xAF): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 5  ,  address); break;
+        Z80_OP(0xB0): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 6  ,  address); break;
+        Z80_OP(0xB1): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 6  ,  address); break;
+        Z80_OP(0xB2): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 6  ,  address); break;
+        Z80_OP(0xB3): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 6  ,  address); break;
+        Z80_OP(0xB4): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 6  ,  address); break;
+        Z80_OP(0xB5): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 6  ,  address); break;
+        Z80_OP(0xB6): CPU_RESET_BIT_MEMORY(address, 6);  break;
+        Z80_OP(0xB7): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 6  ,  address); break;
+        Z80_OP(0xB8): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.hi, 7  ,  address); break;
+        Z80_OP(0xB9): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterBC.lo, 7  ,  address); break;
+        Z80_OP(0xBA): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.hi, 7  ,  address); break;
+        Z80_OP(0xBB): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterDE.lo, 7  ,  address); break;
+        Z80_OP(0xBC): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.hi, 7  ,  address); break;
+        Z80_OP(0xBD): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterHL.lo, 7  ,  address); break;
+        Z80_OP(0xBE): CPU_RESET_BIT_MEMORY(address, 7);  break;
+        Z80_OP(0xBF): CPU_DDFD_RESET_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ,  address); break;
 
 
         // set bit
-        case 0xC0 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ,  reg.reg, displacement); break;
-        case 0xC1 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ,  reg.reg, displacement); break;
-        case 0xC2 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ,  reg.reg, displacement); break;
-        case 0xC3 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ,  reg.reg, displacement); break;
-        case 0xC4 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ,  reg.reg, displacement); break;
-        case 0xC5 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ,  reg.reg, displacement); break;
-        case 0xC6 : CPU_SET_BIT_MEMORY(reg.reg + displacement, 0); m_ContextZ80.m_OpcodeCycle = 23; break;
-        case 0xC7 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ,  reg.reg, displacement); break;
-        case 0xC8 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 1  ,  reg.reg, displacement); break;
-        case 0xC9 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ,  reg.reg, displacement); break;
-        case 0xCA : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ,  reg.reg, displacement); break;
-        case 0xCB : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ,  reg.reg, displacement); break;
-        case 0xCC : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ,  reg.reg, displacement); break;
-        case 0xCD : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ,  reg.reg, displacement); break;
-        case 0xCE : CPU_SET_BIT_MEMORY(reg.reg + displacement, 1); m_ContextZ80.m_OpcodeCycle = 23; break;
-        case 0xCF : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 1  ,  reg.reg, displacement); break;
-        case 0xD0 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 2  ,  reg.reg, displacement); break;
-        case 0xD1 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 2  ,  reg.reg, displacement); break;
-        case 0xD2 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 2  ,  reg.reg, displacement); break;
-        case 0xD3 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 2  ,  reg.reg, displacement); break;
-        case 0xD4 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 2  ,  reg.reg, displacement); break;
-        case 0xD5 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 2  ,  reg.reg, displacement); break;
-        case 0xD6 : CPU_SET_BIT_MEMORY(reg.reg+displacement, 2); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xD7 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 2  ,  reg.reg, displacement); break;
-        case 0xD8 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 3  ,  reg.reg, displacement); break;
-        case 0xD9 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 3  ,  reg.reg, displacement); break;
-        case 0xDA : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 3  ,  reg.reg, displacement); break;
-        case 0xDB : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 3  ,  reg.reg, displacement); break;
-        case 0xDC : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 3  ,  reg.reg, displacement); break;
-        case 0xDD : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 3  ,  reg.reg, displacement); break;
-        case 0xDE : CPU_SET_BIT_MEMORY(reg.reg+displacement, 3 ); m_ContextZ80.m_OpcodeCycle = 23; break;
-        case 0xDF : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 3  ,  reg.reg, displacement); break;
-        case 0xE0 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 4  ,  reg.reg, displacement); break;
-        case 0xE1 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 4  ,  reg.reg, displacement); break;
-        case 0xE2 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 4  ,  reg.reg, displacement); break;
-        case 0xE3 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 4  ,  reg.reg, displacement); break;
-        case 0xE4 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 4  ,  reg.reg, displacement); break;
-        case 0xE5 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 4  ,  reg.reg, displacement); break;
-        case 0xE6 : CPU_SET_BIT_MEMORY(reg.reg+displacement, 4); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xE7 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ,  reg.reg, displacement); break;
-        case 0xE8 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ,  reg.reg, displacement); break;
-        case 0xE9 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ,  reg.reg, displacement); break;
-        case 0xEA : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ,  reg.reg, displacement); break;
-        case 0xEB : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ,  reg.reg, displacement); break;
-        case 0xEC : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ,  reg.reg, displacement); break;
-        case 0xED : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ,  reg.reg, displacement); break;
-        case 0xEE : CPU_SET_BIT_MEMORY(reg.reg+displacement, 5); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xEF : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 5  ,  reg.reg, displacement); break;
-        case 0xF0 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 6  ,  reg.reg, displacement); break;
-        case 0xF1 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 6  ,  reg.reg, displacement); break;
-        case 0xF2 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 6  ,  reg.reg, displacement); break;
-        case 0xF3 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 6  ,  reg.reg, displacement); break;
-        case 0xF4 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 6  ,  reg.reg, displacement); break;
-        case 0xF5 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 6  ,  reg.reg, displacement); break;
-        case 0xF6 : CPU_SET_BIT_MEMORY(reg.reg+displacement, 6); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xF7 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ,  reg.reg, displacement); break;
-        case 0xF8 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 7  ,  reg.reg, displacement); break;
-        case 0xF9 : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 7  ,  reg.reg, displacement); break;
-        case 0xFA : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 7  ,  reg.reg, displacement); break;
-        case 0xFB : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 7  ,  reg.reg, displacement); break;
-        case 0xFC : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 7  ,  reg.reg, displacement); break;
-        case 0xFD : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 7  ,  reg.reg, displacement); break;
-        case 0xFE : CPU_SET_BIT_MEMORY(reg.reg+displacement, 7); m_ContextZ80.m_OpcodeCycle = 23;  break;
-        case 0xFF : CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ,  reg.reg, displacement); break;
+        Z80_OP(0xC0): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 0 ,  address); break;
+        Z80_OP(0xC1): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 0 ,  address); break;
+        Z80_OP(0xC2): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 0 ,  address); break;
+        Z80_OP(0xC3): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 0 ,  address); break;
+        Z80_OP(0xC4): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 0 ,  address); break;
+        Z80_OP(0xC5): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 0 ,  address); break;
+        Z80_OP(0xC6): CPU_SET_BIT_MEMORY(address, 0); break;
+        Z80_OP(0xC7): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 0 ,  address); break;
+        Z80_OP(0xC8): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 1  ,  address); break;
+        Z80_OP(0xC9): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 1 ,  address); break;
+        Z80_OP(0xCA): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 1 ,  address); break;
+        Z80_OP(0xCB): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 1 ,  address); break;
+        Z80_OP(0xCC): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 1 ,  address); break;
+        Z80_OP(0xCD): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 1 ,  address); break;
+        Z80_OP(0xCE): CPU_SET_BIT_MEMORY(address, 1); break;
+        Z80_OP(0xCF): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 1  ,  address); break;
+        Z80_OP(0xD0): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 2  ,  address); break;
+        Z80_OP(0xD1): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 2  ,  address); break;
+        Z80_OP(0xD2): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 2  ,  address); break;
+        Z80_OP(0xD3): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 2  ,  address); break;
+        Z80_OP(0xD4): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 2  ,  address); break;
+        Z80_OP(0xD5): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 2  ,  address); break;
+        Z80_OP(0xD6): CPU_SET_BIT_MEMORY(address, 2);  break;
+        Z80_OP(0xD7): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 2  ,  address); break;
+        Z80_OP(0xD8): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 3  ,  address); break;
+        Z80_OP(0xD9): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 3  ,  address); break;
+        Z80_OP(0xDA): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 3  ,  address); break;
+        Z80_OP(0xDB): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 3  ,  address); break;
+        Z80_OP(0xDC): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 3  ,  address); break;
+        Z80_OP(0xDD): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 3  ,  address); break;
+        Z80_OP(0xDE): CPU_SET_BIT_MEMORY(address, 3 ); break;
+        Z80_OP(0xDF): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 3  ,  address); break;
+        Z80_OP(0xE0): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 4  ,  address); break;
+        Z80_OP(0xE1): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 4  ,  address); break;
+        Z80_OP(0xE2): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 4  ,  address); break;
+        Z80_OP(0xE3): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 4  ,  address); break;
+        Z80_OP(0xE4): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 4  ,  address); break;
+        Z80_OP(0xE5): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 4  ,  address); break;
+        Z80_OP(0xE6): CPU_SET_BIT_MEMORY(address, 4);  break;
+        Z80_OP(0xE7): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 4 ,  address); break;
+        Z80_OP(0xE8): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 5 ,  address); break;
+        Z80_OP(0xE9): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 5 ,  address); break;
+        Z80_OP(0xEA): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 5 ,  address); break;
+        Z80_OP(0xEB): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 5 ,  address); break;
+        Z80_OP(0xEC): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 5 ,  address); break;
+        Z80_OP(0xED): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 5 ,  address); break;
+        Z80_OP(0xEE): CPU_SET_BIT_MEMORY(address, 5);  break;
+        Z80_OP(0xEF): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 5  ,  address); break;
+        Z80_OP(0xF0): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 6  ,  address); break;
+        Z80_OP(0xF1): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 6  ,  address); break;
+        Z80_OP(0xF2): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 6  ,  address); break;
+        Z80_OP(0xF3): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 6  ,  address); break;
+        Z80_OP(0xF4): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 6  ,  address); break;
+        Z80_OP(0xF5): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 6  ,  address); break;
+        Z80_OP(0xF6): CPU_SET_BIT_MEMORY(address, 6);  break;
+        Z80_OP(0xF7): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 6 ,  address); break;
+        Z80_OP(0xF8): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.hi, 7  ,  address); break;
+        Z80_OP(0xF9): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterBC.lo, 7  ,  address); break;
+        Z80_OP(0xFA): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.hi, 7  ,  address); break;
+        Z80_OP(0xFB): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterDE.lo, 7  ,  address); break;
+        Z80_OP(0xFC): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.hi, 7  ,  address); break;
+        Z80_OP(0xFD): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterHL.lo, 7  ,  address); break;
+        Z80_OP(0xFE): CPU_SET_BIT_MEMORY(address, 7);  break;
+        Z80_OP(0xFF): CPU_DDFD_SET_BIT(m_ContextZ80.m_RegisterAF.hi, 7 ,  address); break;
 
 
         default:
@@ -1097,6 +1305,7 @@ void Z80::ExecuteDDFDCBOpcode(bool isDD)
             char buffer[255];
             sprintf(buffer, "Unhandled DDFDCB opcode. Displacement %x opcode %x",displacement, opcode);
             LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+            DumpTrace();
             assert(false);
         }
         break;
@@ -1105,16 +1314,17 @@ void Z80::ExecuteDDFDCBOpcode(bool isDD)
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::ExecuteEDOpcode()
+template <class Bus>
+void Z80<Bus>::ExecuteEDOpcode()
 {
-    BYTE opcode = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+    BYTE opcode = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
     IncreaseRReg();
 
-    LogInstInfo(opcode, "ED", false);
-
     m_ContextZ80.m_ProgramCounter++;
 
+    m_ContextZ80.m_OpcodeCycle = Z80CYCLES.ED.base[opcode];
+
   //  char buffer[255];
 //  sprintf(buffer, "Executing ED Opcode %x",opcode);
 //  LogMessage::GetSingleton()->DoLogMessage(buffer,true);
@@ -1122,95 +1332,135 @@ void Z80::ExecuteEDOpcode()
 
 
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatchTable[256] =
+    {
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_default, &&op_0x4D, &&op_default, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_default, &&op_default, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_default, &&op_default, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_default, &&op_default, &&op_default, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_default, &&op_default, &&op_default, &&op_0x6F,
+        &&op_default, &&op_0x71, &&op_0x72, &&op_0x73, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default
+    };
+    goto *dispatchTable[opcode];
+#endif
+
     switch(opcode)
     {
-        case 0x49 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.lo);break;
-        case 0x41 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.hi);break;
-        case 0x51 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.hi);break;
-        case 0x59 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.lo);break;
-        case 0x61 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.hi);break;
-        case 0x71 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, 0); break; // UNOFFICIAL
-        case 0x69 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.lo);break;
-        case 0x79 : CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterAF.hi); break;
-        case 0xA3 : CPU_OUTI(); break;
-        case 0xB3 : CPU_OTIR(); break;
-
-        case 0x4A : CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.reg, 15, true);break;
-        case 0x5A : CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.reg, 15, true);break;
-        case 0x6A : CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.reg, 15, true);break;
-        case 0x7A : CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_StackPointer.reg, 15, true);break;
-
-
-        case 0x42 : CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.reg, 15, true); break;
-        case 0x52 : CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.reg, 15, true); break;
-        case 0x62 : CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.reg, 15, true); break;
-        case 0x72 : CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_StackPointer.reg, 15, true); break;
-
-        case 0xAB: CPU_OUTD(); break;
-        case 0xBB: CPU_OTDR(); break;
-        case 0xA0: CPU_LDI(); break;
-        case 0xB0: CPU_LDIR(); break;
-        case 0xA1: CPU_CPI();break;
-        case 0xB1: CPU_CPIR();break;
-        case 0xA9: CPU_CPD(); break;
-        case 0xB9: CPU_CPDR(); break;
-        case 0xA2: CPU_INI(); break;
-        case 0xB2: CPU_INIR(); break;
-        case 0xAA: CPU_IND(); break;
-        case 0xBA: CPU_INDR(); break;
-
-        case 0x43: CPU_LOAD_NNN(m_ContextZ80.m_RegisterBC.reg); break;
-        case 0x53: CPU_LOAD_NNN(m_ContextZ80.m_RegisterDE.reg); break;
-        case 0x63: CPU_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); break;
-        case 0x73: CPU_LOAD_NNN(m_ContextZ80.m_StackPointer.reg); break;
-
-        case 0x45: m_ContextZ80.m_ProgramCounter = PopWordOffStack(); m_ContextZ80.m_IFF1 = m_ContextZ80.m_IFF2; m_ContextZ80.m_NMIServicing = false;m_ContextZ80.m_OpcodeCycle = 4;break; // iff1 = iff2 is correct (look at sean youngs undocumented)
-
-        case 0x4b: CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterBC.reg); m_ContextZ80.m_OpcodeCycle = 20; break;
-        case 0x5b: CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterDE.reg); m_ContextZ80.m_OpcodeCycle = 20;break;
-        case 0x6b: CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); m_ContextZ80.m_OpcodeCycle = 20;break;
-        case 0x7b: CPU_REG_LOAD_NNN(m_ContextZ80.m_StackPointer.reg); m_ContextZ80.m_OpcodeCycle = 20;break;
-
-        case 0x40: CPU_IN(m_ContextZ80.m_RegisterBC.hi); break;
-        case 0x48: CPU_IN(m_ContextZ80.m_RegisterBC.lo); break;
-        case 0x50: CPU_IN(m_ContextZ80.m_RegisterDE.hi); break;
-        case 0x58: CPU_IN(m_ContextZ80.m_RegisterDE.lo); break;
-        case 0x60: CPU_IN(m_ContextZ80.m_RegisterHL.hi); break;
-        case 0x68: CPU_IN(m_ContextZ80.m_RegisterHL.lo); break;
-        case 0x78: CPU_IN(m_ContextZ80.m_RegisterAF.hi); break;
-
-        case 0xA8: CPU_LDD(); break;
-        case 0xB8: CPU_LDDR(); break;
-        case 0x44: CPU_NEG(); break;
-        case 0x67: CPU_RRD();m_ContextZ80.m_OpcodeCycle = 18; break;
-        case 0x6F: CPU_RLD();m_ContextZ80.m_OpcodeCycle = 18; break;
-
-        case 0x4D:
+        Z80_OP(0x49): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x41): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x51): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x59): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x61): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.hi);break;
+        Z80_OP(0x71): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, 0); break; // UNOFFICIAL
+        Z80_OP(0x69): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterHL.lo);break;
+        Z80_OP(0x79): CPU_OUT(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterAF.hi); break;
+        Z80_OP(0xA3): CPU_OUTI(); break;
+        Z80_OP(0xB3): CPU_OTIR(); break;
+
+        Z80_OP(0x4A): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.reg, true);break;
+        Z80_OP(0x5A): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.reg, true);break;
+        Z80_OP(0x6A): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.reg, true);break;
+        Z80_OP(0x7A): CPU_16BIT_ADD(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_StackPointer.reg, true);break;
+
+
+        Z80_OP(0x42): CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterBC.reg, true); break;
+        Z80_OP(0x52): CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterDE.reg, true); break;
+        Z80_OP(0x62): CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_RegisterHL.reg, true); break;
+        Z80_OP(0x72): CPU_16BIT_SUB(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_StackPointer.reg, true); break;
+
+        Z80_OP(0xAB): CPU_OUTD(); break;
+        Z80_OP(0xBB): CPU_OTDR(); break;
+        Z80_OP(0xA0): CPU_LDI(); break;
+        Z80_OP(0xB0): CPU_LDIR(); break;
+        Z80_OP(0xA1): CPU_CPI();break;
+        Z80_OP(0xB1): CPU_CPIR();break;
+        Z80_OP(0xA9): CPU_CPD(); break;
+        Z80_OP(0xB9): CPU_CPDR(); break;
+        Z80_OP(0xA2): CPU_INI(); break;
+        Z80_OP(0xB2): CPU_INIR(); break;
+        Z80_OP(0xAA): CPU_IND(); break;
+        Z80_OP(0xBA): CPU_INDR(); break;
+
+        Z80_OP(0x43): CPU_LOAD_NNN(m_ContextZ80.m_RegisterBC.reg); break;
+        Z80_OP(0x53): CPU_LOAD_NNN(m_ContextZ80.m_RegisterDE.reg); break;
+        Z80_OP(0x63): CPU_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg); break;
+        Z80_OP(0x73): CPU_LOAD_NNN(m_ContextZ80.m_StackPointer.reg); break;
+
+        Z80_OP(0x45): m_ContextZ80.m_ProgramCounter = PopWordOffStack(); m_ContextZ80.m_IFF1 = m_ContextZ80.m_IFF2; m_ContextZ80.m_NMIServicing = false;InteruptsEnabled();break; // iff1 = iff2 is correct (look at sean youngs undocumented)
+
+        Z80_OP(0x4B): CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterBC.reg); break;
+        Z80_OP(0x5B): CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterDE.reg);break;
+        Z80_OP(0x6B): CPU_REG_LOAD_NNN(m_ContextZ80.m_RegisterHL.reg);break;
+        Z80_OP(0x7B): CPU_REG_LOAD_NNN(m_ContextZ80.m_StackPointer.reg);break;
+
+        Z80_OP(0x40): CPU_IN(m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x48): CPU_IN(m_ContextZ80.m_RegisterBC.lo); break;
+        Z80_OP(0x50): CPU_IN(m_ContextZ80.m_RegisterDE.hi); break;
+        Z80_OP(0x58): CPU_IN(m_ContextZ80.m_RegisterDE.lo); break;
+        Z80_OP(0x60): CPU_IN(m_ContextZ80.m_RegisterHL.hi); break;
+        Z80_OP(0x68): CPU_IN(m_ContextZ80.m_RegisterHL.lo); break;
+        Z80_OP(0x78): CPU_IN(m_ContextZ80.m_RegisterAF.hi); break;
+
+        Z80_OP(0xA8): CPU_LDD(); break;
+        Z80_OP(0xB8): CPU_LDDR(); break;
+        Z80_OP(0x44): CPU_NEG(); break;
+        Z80_OP(0x67): CPU_RRD(); break;
+        Z80_OP(0x6F): CPU_RLD(); break;
+
+        Z80_OP(0x4D):
         {
             m_ContextZ80.m_ProgramCounter = PopWordOffStack();
             m_ContextZ80.m_IFF1 = m_ContextZ80.m_IFF2;// iff1 = iff2 is correct (look at sean youngs undocumented)
             m_ContextZ80.m_NMIServicing = false;
-            m_ContextZ80.m_OpcodeCycle = 14;
+            InteruptsEnabled();
         }
         break;
 
-        case 0x47: m_ContextZ80.m_RegisterI = m_ContextZ80.m_RegisterAF.hi; m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x4F: m_ContextZ80.m_RegisterR = m_ContextZ80.m_RegisterAF.hi; m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x57: CPU_LDA_I(); break; 
-        case 0x5F: CPU_LDA_R(); break;
+        Z80_OP(0x47): m_ContextZ80.m_RegisterI = m_ContextZ80.m_RegisterAF.hi; break;
+        Z80_OP(0x4F): m_ContextZ80.m_RegisterR = m_ContextZ80.m_RegisterAF.hi; break;
+        Z80_OP(0x57): CPU_LDA_I(); break; 
+        Z80_OP(0x5F): CPU_LDA_R(); break;
 
 
-        case 0x46: LogMessage::GetSingleton()->DoLogMessage("changing to interupt mode 0", true);assert(false);m_ContextZ80.m_InteruptMode = 0;m_ContextZ80.m_OpcodeCycle=8;break;
-        case 0x5E: LogMessage::GetSingleton()->DoLogMessage("changing to interupt mode 2", true);assert(false);m_ContextZ80.m_InteruptMode = 2;m_ContextZ80.m_OpcodeCycle=8;break;
+        Z80_OP(0x46): LogMessage::GetSingleton()->DoLogMessage("changing to interupt mode 0", true);assert(false);m_ContextZ80.m_InteruptMode = 0;break;
+        Z80_OP(0x5E): LogMessage::GetSingleton()->DoLogMessage("changing to interupt mode 2", true);assert(false);m_ContextZ80.m_InteruptMode = 2;break;
 
-        case 0x56: m_ContextZ80.m_InteruptMode = 1;m_ContextZ80.m_OpcodeCycle=8;break;
+        Z80_OP(0x56): m_ContextZ80.m_InteruptMode = 1;InteruptsEnabled();break;
 
         
-        default:
+        Z80_OP_DEFAULT:
         {
             char buffer[255];
             sprintf(buffer, "Unhandled ED opcode %x", opcode);
             LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+            DumpTrace();
             assert(false);
         }
         break;
@@ -1219,99 +1469,141 @@ void Z80::ExecuteEDOpcode()
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::ExecuteDDFDOpcode(bool isDD)
+template <class Bus>
+template <bool isDD>
+void Z80<Bus>::ExecuteDDFDOpcode()
 {
     IncreaseRReg();
-    BYTE opcode = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
-
-    LogInstInfo(opcode, "DDFD", false);
+    BYTE opcode = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
     m_ContextZ80.m_ProgramCounter++;
 
+    // DD CB is looked up again in ExecuteDDFDCBOpcode()
+    m_ContextZ80.m_OpcodeCycle = Z80CYCLES.DDFD.base[opcode];
+
     REGISTERZ80& reg = isDD?m_ContextZ80.m_RegisterIX:m_ContextZ80.m_RegisterIY;
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatchTable[256] =
+    {
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0x09, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0x19, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_default,
+        &&op_default, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x34, &&op_0x35, &&op_0x36, &&op_default,
+        &&op_default, &&op_0x39, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_default, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x84, &&op_0x85, &&op_0x86, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x94, &&op_0x95, &&op_0x96, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_0xCB, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0xE1, &&op_default, &&op_0xE3, &&op_default, &&op_0xE5, &&op_default, &&op_default,
+        &&op_default, &&op_0xE9, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0xF9, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default
+    };
+    goto *dispatchTable[opcode];
+#endif
+
     switch(opcode)
     {
-        case 0xE1: reg.reg = PopWordOffStack();  m_ContextZ80.m_OpcodeCycle=14;break;
-        case 0xE5: PushWordOntoStack(reg.reg);  m_ContextZ80.m_OpcodeCycle=15; break;
-        case 0x21: CPU_16BIT_LOAD(reg.reg);m_ContextZ80.m_OpcodeCycle=14;break;
-        case 0xCB: ExecuteDDFDCBOpcode(isDD); break;
-        case 0x2A: CPU_REG_LOAD_NNN(reg.reg); m_ContextZ80.m_OpcodeCycle=20;break;
-        case 0x26: CPU_8BIT_LOAD_IMMEDIATE(reg.hi); m_ContextZ80.m_OpcodeCycle=11;break;
-        case 0x2E: CPU_8BIT_LOAD_IMMEDIATE(reg.lo); m_ContextZ80.m_OpcodeCycle=11;break;
-        case 0x22: CPU_LOAD_NNN(reg.reg); m_ContextZ80.m_OpcodeCycle=20;break;
-
-        case 0x09: CPU_16BIT_ADD(reg.reg, m_ContextZ80.m_RegisterBC.reg, 15, false); break;
-        case 0x19: CPU_16BIT_ADD(reg.reg, m_ContextZ80.m_RegisterDE.reg, 15, false); break;
-        case 0x29: CPU_16BIT_ADD(reg.reg, reg.reg, 15, false); break;
-        case 0x39: CPU_16BIT_ADD(reg.reg, m_ContextZ80.m_StackPointer.reg, 15, false); break;
-
-        case 0x46: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterBC.hi, reg); break;
-        case 0x4E: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterBC.lo, reg); break;
-        case 0x56: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterDE.hi, reg); break;
-        case 0x5E: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterDE.lo, reg); break;
-        case 0x66: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterHL.hi, reg); break;
-        case 0x6E: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterHL.lo, reg); break;
-        case 0x7E: CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterAF.hi, reg); break;
-
-        case 0x70: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterBC.hi, reg); break;
-        case 0x71: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterBC.lo, reg); break;
-        case 0x72: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterDE.hi, reg); break;
-        case 0x73: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterDE.lo, reg); break;
-        case 0x74: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterHL.hi, reg); break;
-        case 0x75: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterHL.lo, reg); break;
-        case 0x77: CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterAF.hi, reg); break;
-
-        case 0x86: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19,false,false); break;
-        case 0x8E: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19,false,true); break;
-        case 0x34: CPU_8BIT_MEMORY_INC(GetIXIYAddress(reg.reg),23); break;
-        case 0x35: CPU_8BIT_MEMORY_DEC(GetIXIYAddress(reg.reg),23); break;
-        case 0x96: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi,m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19, false,false); break;
-        case 0x9E: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi,m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19, false,true); break;
-        case 0xA6: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi,m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19, false); break;
-        case 0xAE: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi,m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19, false); break;
-        case 0xB6: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi,m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19, false); break;
-        case 0xBE: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi,m_ContextZ80.m_FuncPtrRead(GetIXIYAddress(reg.reg)),19, false); break;
-
-        case 0x23: CPU_16BIT_INC(reg.reg, 10); break;
-        case 0x2B: CPU_16BIT_DEC(reg.reg, 10); break;
-        case 0x24: CPU_8BIT_INC(reg.hi , 10); break;
-        case 0x25: CPU_8BIT_DEC(reg.hi , 10); break;
-        case 0x2C: CPU_8BIT_INC(reg.lo , 10); break;
-        case 0x2D: CPU_8BIT_DEC(reg.lo , 10); break;
-
-
-        case 0x44: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x45: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x4C: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x4D: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x54: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x55: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x5C: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x5D: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x64: CPU_REG_LOAD(reg.hi, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x65: CPU_REG_LOAD(reg.hi, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x6C: CPU_REG_LOAD(reg.lo, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x6D: CPU_REG_LOAD(reg.lo, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x7C: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, reg.hi); m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x7D: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, reg.lo); m_ContextZ80.m_OpcodeCycle = 8;break;
-
-        case 0x84: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false,false); break;
-        case 0x85: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false,false); break;
-        case 0x8C: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false,true); break;
-        case 0x8D: CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false,true); break;
-        case 0x94: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false,false); break;
-        case 0x95: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false,false); break;
-        case 0x9C: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false,true); break;
-        case 0x9D: CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false,true); break;
-        case 0xA4: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false); break;
-        case 0xA5: CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false); break;
-        case 0xAC: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false); break;
-        case 0xAD: CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false); break;
-        case 0xB4: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false); break;
-        case 0xB5: CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false); break;
-        case 0xBC: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, reg.hi,8,false); break;
-        case 0xBD: CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, reg.lo,8,false); break;
+        Z80_OP(0xE1): reg.reg = PopWordOffStack();break;
+        Z80_OP(0xE5): PushWordOntoStack(reg.reg); break;
+        Z80_OP(0x21): CPU_16BIT_LOAD(reg.reg);break;
+        Z80_OP(0xCB): ExecuteDDFDCBOpcode<isDD>(); break;
+        Z80_OP(0x2A): CPU_REG_LOAD_NNN(reg.reg);break;
+        Z80_OP(0x26): CPU_8BIT_LOAD_IMMEDIATE(reg.hi);break;
+        Z80_OP(0x2E): CPU_8BIT_LOAD_IMMEDIATE(reg.lo);break;
+        Z80_OP(0x22): CPU_LOAD_NNN(reg.reg);break;
+
+        Z80_OP(0x09): CPU_16BIT_ADD(reg.reg, m_ContextZ80.m_RegisterBC.reg, false); break;
+        Z80_OP(0x19): CPU_16BIT_ADD(reg.reg, m_ContextZ80.m_RegisterDE.reg, false); break;
+        Z80_OP(0x29): CPU_16BIT_ADD(reg.reg, reg.reg, false); break;
+        Z80_OP(0x39): CPU_16BIT_ADD(reg.reg, m_ContextZ80.m_StackPointer.reg, false); break;
+
+        Z80_OP(0x46): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterBC.hi, reg); break;
+        Z80_OP(0x4E): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterBC.lo, reg); break;
+        Z80_OP(0x56): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterDE.hi, reg); break;
+        Z80_OP(0x5E): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterDE.lo, reg); break;
+        Z80_OP(0x66): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterHL.hi, reg); break;
+        Z80_OP(0x6E): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterHL.lo, reg); break;
+        Z80_OP(0x7E): CPU_8BIT_IXIY_LOAD(m_ContextZ80.m_RegisterAF.hi, reg); break;
+
+        Z80_OP(0x70): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterBC.hi, reg); break;
+        Z80_OP(0x71): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterBC.lo, reg); break;
+        Z80_OP(0x72): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterDE.hi, reg); break;
+        Z80_OP(0x73): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterDE.lo, reg); break;
+        Z80_OP(0x74): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterHL.hi, reg); break;
+        Z80_OP(0x75): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterHL.lo, reg); break;
+        Z80_OP(0x77): CPU_8BIT_MEM_IXIY_LOAD(m_ContextZ80.m_RegisterAF.hi, reg); break;
+
+        Z80_OP(0x86): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(GetIXIYAddress(reg.reg)),false,false); break;
+        Z80_OP(0x8E): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, m_Bus.readMemory(GetIXIYAddress(reg.reg)),false,true); break;
+        Z80_OP(0x34): CPU_8BIT_MEMORY_INC(GetIXIYAddress(reg.reg)); break;
+        Z80_OP(0x35): CPU_8BIT_MEMORY_DEC(GetIXIYAddress(reg.reg)); break;
+        Z80_OP(0x96): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi,m_Bus.readMemory(GetIXIYAddress(reg.reg)), false,false); break;
+        Z80_OP(0x9E): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi,m_Bus.readMemory(GetIXIYAddress(reg.reg)), false,true); break;
+        Z80_OP(0xA6): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi,m_Bus.readMemory(GetIXIYAddress(reg.reg)), false); break;
+        Z80_OP(0xAE): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi,m_Bus.readMemory(GetIXIYAddress(reg.reg)), false); break;
+        Z80_OP(0xB6): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi,m_Bus.readMemory(GetIXIYAddress(reg.reg)), false); break;
+        Z80_OP(0xBE): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi,m_Bus.readMemory(GetIXIYAddress(reg.reg)), false); break;
+
+        Z80_OP(0x23): CPU_16BIT_INC(reg.reg); break;
+        Z80_OP(0x2B): CPU_16BIT_DEC(reg.reg); break;
+        Z80_OP(0x24): CPU_8BIT_INC(reg.hi ); break;
+        Z80_OP(0x25): CPU_8BIT_DEC(reg.hi ); break;
+        Z80_OP(0x2C): CPU_8BIT_INC(reg.lo ); break;
+        Z80_OP(0x2D): CPU_8BIT_DEC(reg.lo ); break;
+
+
+        Z80_OP(0x44): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, reg.hi); break;
+        Z80_OP(0x45): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, reg.lo);break;
+        Z80_OP(0x4C): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, reg.hi); break;
+        Z80_OP(0x4D): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, reg.lo);break;
+        Z80_OP(0x54): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, reg.hi); break;
+        Z80_OP(0x55): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, reg.lo);break;
+        Z80_OP(0x5C): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, reg.hi); break;
+        Z80_OP(0x5D): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, reg.lo);break;
+        Z80_OP(0x64): CPU_REG_LOAD(reg.hi, reg.hi); break;
+        Z80_OP(0x65): CPU_REG_LOAD(reg.hi, reg.lo);break;
+        Z80_OP(0x6C): CPU_REG_LOAD(reg.lo, reg.hi); break;
+        Z80_OP(0x6D): CPU_REG_LOAD(reg.lo, reg.lo);break;
+        Z80_OP(0x7C): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, reg.hi); break;
+        Z80_OP(0x7D): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, reg.lo);break;
+
+        Z80_OP(0x84): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.hi,false,false); break;
+        Z80_OP(0x85): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.lo,false,false); break;
+        Z80_OP(0x8C): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.hi,false,true); break;
+        Z80_OP(0x8D): CPU_8BIT_ADD(m_ContextZ80.m_RegisterAF.hi, reg.lo,false,true); break;
+        Z80_OP(0x94): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.hi,false,false); break;
+        Z80_OP(0x95): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.lo,false,false); break;
+        Z80_OP(0x9C): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.hi,false,true); break;
+        Z80_OP(0x9D): CPU_8BIT_SUB(m_ContextZ80.m_RegisterAF.hi, reg.lo,false,true); break;
+        Z80_OP(0xA4): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, reg.hi,false); break;
+        Z80_OP(0xA5): CPU_8BIT_AND(m_ContextZ80.m_RegisterAF.hi, reg.lo,false); break;
+        Z80_OP(0xAC): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, reg.hi,false); break;
+        Z80_OP(0xAD): CPU_8BIT_XOR(m_ContextZ80.m_RegisterAF.hi, reg.lo,false); break;
+        Z80_OP(0xB4): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, reg.hi,false); break;
+        Z80_OP(0xB5): CPU_8BIT_OR(m_ContextZ80.m_RegisterAF.hi, reg.lo,false); break;
+        Z80_OP(0xBC): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, reg.hi,false); break;
+        Z80_OP(0xBD): CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi, reg.lo,false); break;
 
 
         // IF YOU HAVE TO DO A JUMP INSTURCTION LIKE THIS JP (IX) WHERE THE ORIGINAL INSTRUCTION WAS JP (HL) YOU DO NOT ADD THE
@@ -1320,41 +1612,41 @@ void Z80::ExecuteDDFDOpcode(bool isDD)
         // EX DE, HL IS UNAFFECTED
 
 
-        case 0x40: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8; break;
-        case 0x41: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x42: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x43: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x47: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x48: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x49: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x4A: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x4B: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x4F: CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x50: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x51: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x52: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x53: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x57: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x58: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x59: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x5A: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x5B: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x5F: CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x60: CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x61: CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x62: CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x63: CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x67: CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x68: CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x69: CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x6A: CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x6B: CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x6F: CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x78: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x79: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x7A: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x7B: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo);  m_ContextZ80.m_OpcodeCycle = 8;break;
-        case 0x7F: CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi);  m_ContextZ80.m_OpcodeCycle = 8;break;
+        Z80_OP(0x40): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.hi); break;
+        Z80_OP(0x41): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x42): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x43): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x47): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.hi, m_ContextZ80.m_RegisterAF.hi);break;
+        Z80_OP(0x48): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x49): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x4A): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x4B): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x4F): CPU_REG_LOAD(m_ContextZ80.m_RegisterBC.lo, m_ContextZ80.m_RegisterAF.hi);break;
+        Z80_OP(0x50): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x51): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x52): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x53): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x57): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.hi, m_ContextZ80.m_RegisterAF.hi);break;
+        Z80_OP(0x58): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x59): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x5A): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x5B): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x5F): CPU_REG_LOAD(m_ContextZ80.m_RegisterDE.lo, m_ContextZ80.m_RegisterAF.hi);break;
+        Z80_OP(0x60): CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x61): CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x62): CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x63): CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x67): CPU_REG_LOAD(reg.hi, m_ContextZ80.m_RegisterAF.hi);break;
+        Z80_OP(0x68): CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x69): CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x6A): CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x6B): CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x6F): CPU_REG_LOAD(reg.lo, m_ContextZ80.m_RegisterAF.hi);break;
+        Z80_OP(0x78): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.hi);break;
+        Z80_OP(0x79): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterBC.lo);break;
+        Z80_OP(0x7A): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.hi);break;
+        Z80_OP(0x7B): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterDE.lo);break;
+        Z80_OP(0x7F): CPU_REG_LOAD(m_ContextZ80.m_RegisterAF.hi, m_ContextZ80.m_RegisterAF.hi);break;
 
         //case 0xC1: m_ContextZ80.m_RegisterBC.reg = PopWordOffStack(); m_ContextZ80.m_OpcodeCycle = 4; break;
         //case 0xF4 : CPU_CALL(true, FLAG_S, false); m_ContextZ80.m_OpcodeCycle = 6;break;
@@ -1362,41 +1654,40 @@ void Z80::ExecuteDDFDOpcode(bool isDD)
         
         
 
-        case 0x36:
+        Z80_OP(0x36):
         {
-            m_ContextZ80.m_OpcodeCycle = 19;
             WORD address = GetIXIYAddress(reg.reg);
 
-            BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+            BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
             m_ContextZ80.m_ProgramCounter++;
-            m_ContextZ80.m_FuncPtrWrite(address, n);
+            m_Bus.writeMemory(address, n);
         } break;
 
 
-        case 0xE3:
+        Z80_OP(0xE3):
         {
-            BYTE nhi = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_StackPointer.reg+1);
-            BYTE nlo = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_StackPointer.reg);
+            BYTE nhi = m_Bus.readMemory(m_ContextZ80.m_StackPointer.reg+1);
+            BYTE nlo = m_Bus.readMemory(m_ContextZ80.m_StackPointer.reg);
             BYTE h = reg.hi;
             BYTE l = reg.lo;
             reg.hi = nhi;
             reg.lo = nlo;
-            m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_StackPointer.reg+1, h);
-            m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_StackPointer.reg, l);
-            m_ContextZ80.m_OpcodeCycle = 23;
+            m_Bus.writeMemory(m_ContextZ80.m_StackPointer.reg+1, h);
+            m_Bus.writeMemory(m_ContextZ80.m_StackPointer.reg, l);
         }
         break;
 
-        case 0xE9: m_ContextZ80.m_OpcodeCycle=8; m_ContextZ80.m_ProgramCounter = reg.reg; break;
+        Z80_OP(0xE9): m_ContextZ80.m_ProgramCounter = reg.reg; break;
 
-        case 0xF9: m_ContextZ80.m_OpcodeCycle=10; m_ContextZ80.m_StackPointer.reg = reg.reg; break;
+        Z80_OP(0xF9): m_ContextZ80.m_StackPointer.reg = reg.reg; break;
 
 
-        default:
+        Z80_OP_DEFAULT:
         {
             char buffer[255];
             sprintf(buffer, "Unhandled DD opcode %x", opcode);
             LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+            DumpTrace();
             assert(false);
         }
         break;
@@ -1407,3 +1698,15 @@ void Z80::ExecuteDDFDOpcode(bool isDD)
 
 //////////////////////////////////////////////////////////////////////////////////
 
+//////////////////////////////////////////////////////////////////////////////////
+
+// the rest of Z80<Z80Bus> is instantiated in Z80.cpp
+template void Z80<Z80Bus>::IncreaseRReg();
+template void Z80<Z80Bus>::SyncFlags();
+template void Z80<Z80Bus>::ExecuteOpcode(const BYTE&);
+template void Z80<Z80Bus>::ExecuteCBOpcode();
+template void Z80<Z80Bus>::ExecuteDDFDCBOpcode<true>();
+template void Z80<Z80Bus>::ExecuteDDFDCBOpcode<false>();
+template void Z80<Z80Bus>::ExecuteEDOpcode();
+template void Z80<Z80Bus>::ExecuteDDFDOpcode<true>();
+template void Z80<Z80Bus>::ExecuteDDFDOpcode<false>();
@@ -1278,18 +1278,18 @@ static const char* Z80MNEMONICSSTANDARD[] =
     "DD Instruction",
     "SBC A,n",
     "RST 18H",
-    "PO",
-    "HL",
+    "RET PO",
+    "POP HL",
     "JP PO,(nn)",
-    "SP),HL",
+    "EX (SP),HL",
     "CALL PO,(nn)",
-    "HL",
+    "PUSH HL",
     "AND n",
-    "20H",
-    "PE",
-    "HL)",
+    "RST 20H",
+    "RET PE",
+    "JP (HL)",
     "JP PE,(nn)",
-    "E,HL",
+    "EX DE,HL",
     "CALL PE,(nn)",
     "ED Instruction",
     "XOR n",
@@ -1308,11 +1308,6 @@ static const char* Z80MNEMONICSSTANDARD[] =
     "EI",
     "CALL M,(nn)",
     "FD Instruction",
-    "POP IY",
-    "EX (SP),IY",
-    "PUSH IY",
-    "JP (IY)",
-    "LD SP,IY",
     "CP n",
     "RST 38H"
 };
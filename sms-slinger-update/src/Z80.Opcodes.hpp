@@ -27,38 +27,40 @@
 
 #include "Config.hpp"
 #include "Z80.hpp"
+#include "Z80.FlagTables.hpp"
+#include "Z80.Cycles.hpp"
 
 
 // load immediate byte into reg
-void Z80::CPU_8BIT_LOAD_IMMEDIATE(BYTE& reg)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_LOAD_IMMEDIATE(BYTE& reg)
 {
-    m_ContextZ80.m_OpcodeCycle = 7;
-    BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+    BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
     m_ContextZ80.m_ProgramCounter++;
     reg = n;
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_REG_LOAD(BYTE& reg, BYTE load)
+template <class Bus>
+void Z80<Bus>::CPU_REG_LOAD(BYTE& reg, BYTE load)
 {
-    m_ContextZ80.m_OpcodeCycle = 4;
     reg = load;
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_REG_LOAD_ROM(BYTE& reg, WORD address)
+template <class Bus>
+void Z80<Bus>::CPU_REG_LOAD_ROM(BYTE& reg, WORD address)
 {
-    m_ContextZ80.m_OpcodeCycle = 7;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_16BIT_LOAD(WORD& reg)
+template <class Bus>
+void Z80<Bus>::CPU_16BIT_LOAD(WORD& reg)
 {
-    m_ContextZ80.m_OpcodeCycle = 10;
     WORD n = ReadWord();
     m_ContextZ80.m_ProgramCounter+=2;
     reg = n;
@@ -66,9 +68,9 @@ void Z80::CPU_16BIT_LOAD(WORD& reg)
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_ADD(BYTE& reg, BYTE toAdd, int cycles, bool useImmediate, bool addCarry)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_ADD(BYTE& reg, BYTE toAdd, bool useImmediate, bool addCarry)
 {
-    m_ContextZ80.m_OpcodeCycle = cycles;
     BYTE before = reg;
     unsigned int adding = 0; // must be unsigned int not byte. Because adding carry to 0xFF would cause overflow and the carry flag wouldnt get set
     BYTE nonMod = toAdd;
@@ -77,7 +79,7 @@ void Z80::CPU_8BIT_ADD(BYTE& reg, BYTE toAdd, int cycles, bool useImmediate, boo
     // are we adding immediate data or the second param?
     if (useImmediate)
     {
-        BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter++;
         adding = n;
         nonMod = n;
@@ -97,41 +99,20 @@ void Z80::CPU_8BIT_ADD(BYTE& reg, BYTE toAdd, int cycles, bool useImmediate, boo
     res = reg + adding;
     reg+=adding;
 
-    // set the flags
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    // correct
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    // correct
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    // correct
-    if(((nonMod ^ before ^ 0x80) & (nonMod ^ res) & 0x80))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
-    // correct
-    if ((before ^ res ^ nonMod) & 0x10)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    // correct
-    if ((before + adding) > 0xFF)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    // set the flags. the half carry is bit 4 of before ^ res ^ nonMod
+    // and the carry is bit 8 of the unmasked result
+#ifdef Z80_LAZY_FLAGS
+    SetLazyFlags(LazyFlags::Add, before, nonMod, res);
+#else
+    m_ContextZ80.m_RegisterAF.lo = Z80AddFlags(before, nonMod, res);
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_SUB(BYTE& reg, BYTE subtracting, int cycles, bool useImmediate, bool subCarry)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_SUB(BYTE& reg, BYTE subtracting, bool useImmediate, bool subCarry)
 {
-    m_ContextZ80.m_OpcodeCycle = cycles;
     BYTE before = reg;
     unsigned int toSubtract = 0;
     BYTE nonMod = subtracting;
@@ -139,7 +120,7 @@ void Z80::CPU_8BIT_SUB(BYTE& reg, BYTE subtracting, int cycles, bool useImmediat
 
     if (useImmediate)
     {
-        BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter++;
         toSubtract = n;
         nonMod = n;
@@ -158,54 +139,25 @@ void Z80::CPU_8BIT_SUB(BYTE& reg, BYTE subtracting, int cycles, bool useImmediat
     res = reg - toSubtract;
     reg -= toSubtract;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    // correct
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    // correct
-    m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    // correct
-    if (before < toSubtract)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    SIGNED_WORD htest = (before & 0xF);
-    htest -= (toSubtract & 0xF);
-
-    // correct
-    if((before ^ res ^ nonMod) & 0x10)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    // correct
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
     // v is calculated not p
-
-    if((nonMod ^ before) & (before ^ res) & 0x80)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
+#ifdef Z80_LAZY_FLAGS
+    SetLazyFlags(LazyFlags::Sub, before, nonMod, res);
+#else
+    m_ContextZ80.m_RegisterAF.lo = Z80SubFlags(before, nonMod, res);
+#endif
 }
 
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_AND(BYTE& reg, BYTE toAnd, int cycles, bool useImmediate)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_AND(BYTE& reg, BYTE toAnd, bool useImmediate)
 {
-    m_ContextZ80.m_OpcodeCycle=cycles;
     BYTE myand = 0;
 
     if (useImmediate)
     {
-        BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter++;
         myand = n;
     }
@@ -216,49 +168,23 @@ void Z80::CPU_8BIT_AND(BYTE& reg, BYTE toAnd, int cycles, bool useImmediate)
 
     reg &= myand;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    // correct
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    // correct
-    m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    // correct
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
-
-    // unsure
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
+#ifdef Z80_LAZY_FLAGS
+    SetLazyFlags(LazyFlags::And, 0, 0, reg);
+#else
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | (1 << FLAG_H);
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_OR(BYTE& reg, BYTE toOr, int cycles, bool useImmediate)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_OR(BYTE& reg, BYTE toOr, bool useImmediate)
 {
-    m_ContextZ80.m_OpcodeCycle=cycles;
     BYTE myor = 0;
 
     if (useImmediate)
     {
-        BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter++;
         myor = n;
     }
@@ -269,47 +195,23 @@ void Z80::CPU_8BIT_OR(BYTE& reg, BYTE toOr, int cycles, bool useImmediate)
 
     reg |= myor;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    // correct
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-
-    // correct
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
-
-    // unsure
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
+#ifdef Z80_LAZY_FLAGS
+    SetLazyFlags(LazyFlags::OrXor, 0, 0, reg);
+#else
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg];
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_XOR(BYTE& reg, BYTE toXOr, int cycles, bool useImmediate)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_XOR(BYTE& reg, BYTE toXOr, bool useImmediate)
 {
-    m_ContextZ80.m_OpcodeCycle=cycles;
     BYTE myxor = 0;
 
     if (useImmediate)
     {
-        BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter++;
         myxor = n;
     }
@@ -320,47 +222,24 @@ void Z80::CPU_8BIT_XOR(BYTE& reg, BYTE toXOr, int cycles, bool useImmediate)
 
     reg ^= myxor;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    // correct
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    // correct
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
-
-    // unsure
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
+#ifdef Z80_LAZY_FLAGS
+    SetLazyFlags(LazyFlags::OrXor, 0, 0, reg);
+#else
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg];
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
 // this does not affect any registers, hence why im not passing a reference
 
-void Z80::CPU_8BIT_COMPARE(BYTE reg, BYTE subtracting, int cycles, bool useImmediate)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_COMPARE(BYTE reg, BYTE subtracting, bool useImmediate)
 {
     // the CPI function uses this function and the CPI function is correct according to zexall.
     // if there are any problems with this function it must be to do with the flags that CPI sets itself like
     // the carry flag and the PV flag.
 
-    m_ContextZ80.m_OpcodeCycle= cycles;
     BYTE before = reg;
     BYTE toSubtract = 0;
     BYTE nonMod = subtracting;
@@ -368,7 +247,7 @@ void Z80::CPU_8BIT_COMPARE(BYTE reg, BYTE subtracting, int cycles, bool useImmed
 
     if (useImmediate)
     {
-        BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter++;
         toSubtract = n;
         nonMod = n;
@@ -381,245 +260,69 @@ void Z80::CPU_8BIT_COMPARE(BYTE reg, BYTE subtracting, int cycles, bool useImmed
     res = reg - toSubtract;
     reg -= toSubtract;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    // correct
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    // correct
-    m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    // correct
-    if (before < toSubtract)
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    }
-
-
-    SIGNED_WORD htest = (before & 0xF);
-    htest -= (toSubtract & 0xF);
-
-    // correct
-    if ((before ^ res ^ nonMod) & 0x10)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    // correct
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
     // v is calculated not p
-
-    if((nonMod ^ before) & (before ^ res) & 0x80)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+#ifdef Z80_LAZY_FLAGS
+    SetLazyFlags(LazyFlags::Sub, before, nonMod, res);
+#else
+    m_ContextZ80.m_RegisterAF.lo = Z80SubFlags(before, nonMod, res);
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_INC(BYTE& reg, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_INC(BYTE& reg)
 {
     // WHEN EDITING THIS FUNCTION DONT FORGET TO MAKE THE SAME CHANGES TO CPU_8BIT_MEMORY_INC
 
-    m_ContextZ80.m_OpcodeCycle= cycles;
-
-    BYTE before = reg;
-
     reg++;
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    if ((before & 0xF) == 0xF)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    // v is calculated not p
-    if (before == 127)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.Inc[reg];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_MEMORY_INC(WORD address, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_MEMORY_INC(WORD address)
 {
     // WHEN EDITING THIS FUNCTION DONT FORGET TO MAKE THE SAME CHANGES TO CPU_8BIT_INC
 
-    m_ContextZ80.m_OpcodeCycle= cycles;
-
-    BYTE before = m_ContextZ80.m_FuncPtrRead(address);
-    m_ContextZ80.m_FuncPtrWrite(address, (before+1));
-    BYTE now =  before+1;
-
-    if (now == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    if ((before & 0xF) == 0xF)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    if (testBit(now,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(now,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(now,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    // v is calculated not p
-    if (before == 127)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
+    BYTE now = m_Bus.readMemory(address) + 1;
+    m_Bus.writeMemory(address, now);
 
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.Inc[now];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_DEC(BYTE& reg, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_DEC(BYTE& reg)
 {
     // WHEN EDITING THIS FUNCTION DONT FORGET TO MAKE THE SAME CHANGES TO CPU_8BIT_MEMORY_DEC
 
-    m_ContextZ80.m_OpcodeCycle= cycles;
-
-    BYTE before = reg;
-
     reg--;
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    if ((before & 0x0F) == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    SIGNED_BYTE vtest = before;
-
-    // v is calculated not p
-    if (vtest == -128)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
-    m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-    //
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-
-
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.Dec[reg];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_MEMORY_DEC(WORD address, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_MEMORY_DEC(WORD address)
 {
     // WHEN EDITING THIS FUNCTION DONT FORGET TO MAKE THE SAME CHANGES TO CPU_8BIT_DEC
 
-    m_ContextZ80.m_OpcodeCycle= cycles;
-    BYTE before = m_ContextZ80.m_FuncPtrRead(address);
-    m_ContextZ80.m_FuncPtrWrite(address, (before-1));
-    BYTE now = before-1;
-
-    if (now == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    if ((before & 0x0F) == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    if (testBit(now,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(now,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(now,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
+    BYTE now = m_Bus.readMemory(address) - 1;
+    m_Bus.writeMemory(address, now);
 
-    SIGNED_BYTE vtest = before;
-
-    // v is calculated not p
-    if (vtest == -128)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.Dec[now];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_16BIT_ADD(WORD& reg, WORD myAdd, int cycles, bool addCarry)
+template <class Bus>
+void Z80<Bus>::CPU_16BIT_ADD(WORD& reg, WORD myAdd, bool addCarry)
 {
-    m_ContextZ80.m_OpcodeCycle= cycles;
     WORD before = reg;
     unsigned int toAdd = myAdd;
 
@@ -681,15 +384,13 @@ void Z80::CPU_16BIT_ADD(WORD& reg, WORD myAdd, int cycles, bool addCarry)
         else
             m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
     }
-
-
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_16BIT_SUB(WORD& reg, WORD mySub, int cycles, bool subCarry)
+template <class Bus>
+void Z80<Bus>::CPU_16BIT_SUB(WORD& reg, WORD mySub, bool subCarry)
 {
-    m_ContextZ80.m_OpcodeCycle= cycles;
     WORD before = reg;
     int c = testBit(m_ContextZ80.m_RegisterAF.lo,FLAG_C)?1:0;
     int res = reg - mySub - c;
@@ -718,26 +419,25 @@ void Z80::CPU_16BIT_SUB(WORD& reg, WORD mySub, int cycles, bool subCarry)
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_16BIT_INC(WORD& word, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_16BIT_INC(WORD& word)
 {
-    m_ContextZ80.m_OpcodeCycle= cycles;
     word++;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_16BIT_DEC(WORD& word, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_16BIT_DEC(WORD& word)
 {
-    m_ContextZ80.m_OpcodeCycle= cycles;
     word--;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_JUMP(bool useCondition, int flag, bool condition)
+template <class Bus>
+void Z80<Bus>::CPU_JUMP(bool useCondition, int flag, bool condition)
 {
-    m_ContextZ80.m_OpcodeCycle= 10;        
-
     if (!useCondition)
     {
         WORD nn = ReadWord();
@@ -759,25 +459,21 @@ void Z80::CPU_JUMP(bool useCondition, int flag, bool condition)
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_JUMP_IMMEDIATE(bool useCondition, int flag, bool condition)
+template <class Bus>
+void Z80<Bus>::CPU_JUMP_IMMEDIATE(bool useCondition, int flag, bool condition)
 {
-    m_ContextZ80.m_OpcodeCycle= 12;
-
     if (!useCondition)
     {
-        SIGNED_BYTE n = (SIGNED_BYTE)m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        SIGNED_BYTE n = (SIGNED_BYTE)m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
         m_ContextZ80.m_ProgramCounter += n;
     }
     else if (testBit(m_ContextZ80.m_RegisterAF.lo, flag) == condition)
     {
-        SIGNED_BYTE n = (SIGNED_BYTE)m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        SIGNED_BYTE n = (SIGNED_BYTE)m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
         m_ContextZ80.m_ProgramCounter += n;
-    }
-    else
-    {
-        m_ContextZ80.m_OpcodeCycle= 7;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::JumpRelative;
     }
 
     m_ContextZ80.m_ProgramCounter++;
@@ -785,11 +481,9 @@ void Z80::CPU_JUMP_IMMEDIATE(bool useCondition, int flag, bool condition)
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_CALL(bool useCondition, int flag, bool condition)
+template <class Bus>
+void Z80<Bus>::CPU_CALL(bool useCondition, int flag, bool condition)
 {
-    m_ContextZ80.m_OpcodeCycle= 17;
-
-
     if (!useCondition)
     {
         WORD nn = ReadWord();
@@ -805,19 +499,19 @@ void Z80::CPU_CALL(bool useCondition, int flag, bool condition)
         m_ContextZ80.m_ProgramCounter += 2;
         PushWordOntoStack(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter = nn;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Call;
     }
     else
     {
-        m_ContextZ80.m_OpcodeCycle= 10;
         m_ContextZ80.m_ProgramCounter += 2;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_RETURN(bool useCondition, int flag, bool condition)
+template <class Bus>
+void Z80<Bus>::CPU_RETURN(bool useCondition, int flag, bool condition)
 {
-    m_ContextZ80.m_OpcodeCycle = 11;
     if (!useCondition)
     {
         m_ContextZ80.m_ProgramCounter = PopWordOffStack();
@@ -827,898 +521,324 @@ void Z80::CPU_RETURN(bool useCondition, int flag, bool condition)
     if (testBit(m_ContextZ80.m_RegisterAF.lo, flag) == condition)
     {
         m_ContextZ80.m_ProgramCounter = PopWordOffStack();
-    }
-    else
-    {
-        m_ContextZ80.m_OpcodeCycle = 5;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Return;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_RESTARTS(BYTE n)
+template <class Bus>
+void Z80<Bus>::CPU_RESTARTS(BYTE n)
 {
     PushWordOntoStack(m_ContextZ80.m_ProgramCounter);
-    m_ContextZ80.m_OpcodeCycle = 11;
     m_ContextZ80.m_ProgramCounter = n;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
 // rotate right through carry
-void Z80::CPU_RR(BYTE& reg, bool isAReg)
+template <class Bus>
+void Z80<Bus>::CPU_RR(BYTE& reg, bool isAReg)
 {
-    // WHEN EDITING THIS ALSO EDIT CPU_RR_MEMORY
-    if (isAReg)
-        m_ContextZ80.m_OpcodeCycle = 4;
-    else
-        m_ContextZ80.m_OpcodeCycle = 8;
-
-    bool isCarrySet = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    bool isLSBSet = testBit(reg, 0);
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RR_MEMORY
+    BYTE carry = reg & 0x1;
 
-    reg >>= 1;
+    reg = (reg >> 1) | ((m_ContextZ80.m_RegisterAF.lo & (1 << FLAG_C)) << 7);
 
-    if (isLSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
     else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    if (isCarrySet)
-        reg = bitSet(reg, 7);
-
-    // when passing the A reg through these flags remain unchanged
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
 // rotate right through carry
-void Z80::CPU_RR_MEMORY(WORD address, bool isAReg)
+template <class Bus>
+void Z80<Bus>::CPU_RR_MEMORY(WORD address, bool isAReg)
 {
-    // WHEN EDITING THIS ALSO EDIT CPU_RR
-    m_ContextZ80.m_OpcodeCycle = 15;
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RR
 
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
+    BYTE reg = m_Bus.readMemory(address);
 
-    bool isCarrySet = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    bool isLSBSet = testBit(reg, 0);
+    BYTE carry = reg & 0x1;
 
-    reg >>= 1;
+    reg = (reg >> 1) | ((m_ContextZ80.m_RegisterAF.lo & (1 << FLAG_C)) << 7);
 
-    if (isLSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
     else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    if (isCarrySet)
-        reg = bitSet(reg, 7);
-
-    // when passing the A reg through these flags remain unchanged
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
 // rotate left
-void Z80::CPU_RLC(BYTE& reg, bool isAReg)
+template <class Bus>
+void Z80<Bus>::CPU_RLC(BYTE& reg, bool isAReg)
 {
-    //WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RLC_MEMORY
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RLC_MEMORY
+    BYTE carry = reg >> 7;
 
-    if (isAReg)
-        m_ContextZ80.m_OpcodeCycle = 4;
-    else
-        m_ContextZ80.m_OpcodeCycle = 8;
-
-    bool isMSBSet = testBit(reg, 7);
+    reg = (reg << 1) | carry;
 
-    reg <<= 1;
-
-    if (isMSBSet)
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-        reg = bitSet(reg,0);
-    }
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
     else
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    }
-
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
 // rotate left
-void Z80::CPU_RLC_MEMORY(WORD address, bool isAReg)
+template <class Bus>
+void Z80<Bus>::CPU_RLC_MEMORY(WORD address, bool isAReg)
 {
-    //WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RLC
-
-    m_ContextZ80.m_OpcodeCycle = 15;
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RLC
 
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
+    BYTE reg = m_Bus.readMemory(address);
 
-    bool isMSBSet = testBit(reg, 7);
+    BYTE carry = reg >> 7;
 
-    reg <<= 1;
+    reg = (reg << 1) | carry;
 
-    if (isMSBSet)
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-        reg = bitSet(reg,0);
-    }
-    else
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    }
-
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-
-}
-
-//////////////////////////////////////////////////////////////////////////////////
-
-// rotate right
-void Z80::CPU_RRC(BYTE& reg, bool isAReg)
-{
-    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RRC_MEMORY
+    // when passing the A reg through S, Z and PV remain unchanged
     if (isAReg)
-        m_ContextZ80.m_OpcodeCycle = 4;
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
     else
-        m_ContextZ80.m_OpcodeCycle = 8;
-
-    bool isLSBSet = testBit(reg, 0);
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 
-    reg >>= 1;
-
-    if (isLSBSet)
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-        reg = bitSet(reg,7);
-    }
-    else
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    }
-
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
 // rotate right
-void Z80::CPU_RRC_MEMORY(WORD address, bool isAReg)
+template <class Bus>
+void Z80<Bus>::CPU_RRC(BYTE& reg, bool isAReg)
 {
     // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RRC_MEMORY
+    BYTE carry = reg & 0x1;
 
-    m_ContextZ80.m_OpcodeCycle = 15;
-
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
-
-    bool isLSBSet = testBit(reg, 0);
-
-    reg >>= 1;
-
-    if (isLSBSet)
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-        reg = bitSet(reg,7);
-    }
-    else
-    {
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    }
-
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-}
-
-//////////////////////////////////////////////////////////////////////////////////
-
-void Z80::CPU_RL(BYTE& reg, bool isAReg)
-{
-    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RL_MEMORY
-    if (isAReg)
-        m_ContextZ80.m_OpcodeCycle = 4;
-    else
-        m_ContextZ80.m_OpcodeCycle = 8;
-
-    bool isCarrySet = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    bool isMSBSet = testBit(reg, 7);
-
-    reg <<= 1;
-
-    if (isMSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    if (isCarrySet)
-        reg = bitSet(reg, 0);
-
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-}
-
-//////////////////////////////////////////////////////////////////////////////////
-
-// rotate left through carry flag
-void Z80::CPU_RL_MEMORY(WORD address, bool isAReg)
-{
-    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RL_MEMORY
-    m_ContextZ80.m_OpcodeCycle = 15;
-
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
-
-    bool isCarrySet = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    bool isMSBSet = testBit(reg, 7);
-
-    reg <<= 1;
-
-    if (isMSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    if (isCarrySet)
-        reg = bitSet(reg, 0);
-
-    if (!isAReg)
-    {
-        if (reg == 0)
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-        if (testBit(reg,7))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-        int pcount = 0;
-        for (int i = 0; i < 8; i++)
-        {
-            if (testBit(reg,i))
-                pcount++;
-        }
-
-        if ((pcount == 0) || ((pcount % 2) == 0))
-            m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        else
-            m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    }
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-}
-
-//////////////////////////////////////////////////////////////////////////////////
-
-// shift left arithmetically (basically bit 0 gets set to 0) (bit 7 goes into carry)
-void Z80::CPU_SLA(BYTE& reg)
-{
-    // WHEN EDITING THIS ALSO EDIT CPU_SLA_MEMORY
-
-    m_ContextZ80.m_OpcodeCycle = 8;
-
-    bool isMSBSet = testBit(reg, 7);
-
-    reg <<= 1;
-
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    if (isMSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
-
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
-}
-
-//////////////////////////////////////////////////////////////////////////////////
-
-void Z80::CPU_SLA_MEMORY(WORD address)
-{
-    // WHEN EDITING THIS ALSO EDIT CPU_SLA
-
-    m_ContextZ80.m_OpcodeCycle = 15;
-
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
-
-    bool isMSBSet = testBit(reg, 7);
-
-    reg <<= 1;
-
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    if (isMSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
-
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    reg = (reg >> 1) | (carry << 7);
 
-    m_ContextZ80.m_FuncPtrWrite(address,reg);
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
+    else
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 }
+
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_SRA(BYTE& reg)
+// rotate right
+template <class Bus>
+void Z80<Bus>::CPU_RRC_MEMORY(WORD address, bool isAReg)
 {
-    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRA_MEMORY
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RRC
 
-    m_ContextZ80.m_OpcodeCycle = 8;
+    BYTE reg = m_Bus.readMemory(address);
 
-    bool isLSBSet = testBit(reg,0);
-    bool isMSBSet = testBit(reg,7);
-
-    m_ContextZ80.m_RegisterAF.lo = 0;
+    BYTE carry = reg & 0x1;
 
-    reg >>= 1;
+    reg = (reg >> 1) | (carry << 7);
 
-    if (isMSBSet)
-        reg = bitSet(reg,7);
-    if (isLSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
+    else
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
+    m_Bus.writeMemory(address, reg);
+}
 
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
+//////////////////////////////////////////////////////////////////////////////////
 
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
+template <class Bus>
+void Z80<Bus>::CPU_RL(BYTE& reg, bool isAReg)
+{
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RL_MEMORY
+    BYTE carry = reg >> 7;
 
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
+    reg = (reg << 1) | (m_ContextZ80.m_RegisterAF.lo & (1 << FLAG_C));
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
+    else
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-// shift right. LSB into carry. bit 7 doesn't change
-void Z80::CPU_SRA_MEMORY(WORD address)
+// rotate left through carry flag
+template <class Bus>
+void Z80<Bus>::CPU_RL_MEMORY(WORD address, bool isAReg)
 {
-    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRA
-
-    m_ContextZ80.m_OpcodeCycle = 15;
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_RL
 
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
+    BYTE reg = m_Bus.readMemory(address);
 
-    bool isLSBSet = testBit(reg,0);
-    bool isMSBSet = testBit(reg,7);
+    BYTE carry = reg >> 7;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
+    reg = (reg << 1) | (m_ContextZ80.m_RegisterAF.lo & (1 << FLAG_C));
 
-    reg >>= 1;
+    // when passing the A reg through S, Z and PV remain unchanged
+    if (isAReg)
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~((1 << FLAG_H) | (1 << FLAG_N) | (1 << FLAG_C))) | carry;
+    else
+        m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~(Z80FLAGS_SZHVN | (1 << FLAG_C))) | Z80FLAGTABLES.SZP[reg] | carry;
 
-    if (isMSBSet)
-        reg = bitSet(reg,7);
-    if (isLSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    m_Bus.writeMemory(address, reg);
+}
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
+//////////////////////////////////////////////////////////////////////////////////
 
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
+// shift left arithmetically (basically bit 0 gets set to 0) (bit 7 goes into carry)
+template <class Bus>
+void Z80<Bus>::CPU_SLA(BYTE& reg)
+{
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SLA_MEMORY
 
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
 
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
+    BYTE carry = reg >> 7;
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    reg <<= 1;
 
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_SRL(BYTE& reg)
+template <class Bus>
+void Z80<Bus>::CPU_SLA_MEMORY(WORD address)
 {
-    //WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRL_MEMORY
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SLA
 
-    m_ContextZ80.m_OpcodeCycle = 8;
 
-    bool isLSBSet = testBit(reg,0);
+    BYTE reg = m_Bus.readMemory(address);
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
+    BYTE carry = reg >> 7;
 
-    reg >>= 1;
+    reg <<= 1;
 
-    if (isLSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
+    m_Bus.writeMemory(address, reg);
+}
+//////////////////////////////////////////////////////////////////////////////////
 
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
+template <class Bus>
+void Z80<Bus>::CPU_SRA(BYTE& reg)
+{
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRA_MEMORY
 
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
 
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
+    BYTE carry = reg & 0x1;
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    reg = (reg >> 1) | (reg & 0x80);
 
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-// shift right. bit 0 into carry
-void Z80::CPU_SRL_MEMORY(WORD address)
+// shift right. LSB into carry. bit 7 doesn't change
+template <class Bus>
+void Z80<Bus>::CPU_SRA_MEMORY(WORD address)
 {
-    //WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRL_MEMORY
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRA
 
-    m_ContextZ80.m_OpcodeCycle = 15;
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
 
-    bool isLSBSet = testBit(reg,0);
+    BYTE reg = m_Bus.readMemory(address);
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
+    BYTE carry = reg & 0x1;
 
-    reg >>= 1;
+    reg = (reg >> 1) | (reg & 0x80);
 
-    if (isLSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
+    m_Bus.writeMemory(address, reg);
+}
 
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
+//////////////////////////////////////////////////////////////////////////////////
 
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
+template <class Bus>
+void Z80<Bus>::CPU_SRL(BYTE& reg)
+{
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRL_MEMORY
 
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    BYTE carry = reg & 0x1;
 
-    m_ContextZ80.m_FuncPtrWrite(address,reg);
+    reg >>= 1;
 
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_SLL(BYTE& reg)
+// shift right. bit 0 into carry
+template <class Bus>
+void Z80<Bus>::CPU_SRL_MEMORY(WORD address)
 {
-    //WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SLL_MEMORY
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SRL
 
-    m_ContextZ80.m_OpcodeCycle = 8;
 
-    bool isMSBSet = testBit(reg,7);
+    BYTE reg = m_Bus.readMemory(address);
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
+    BYTE carry = reg & 0x1;
 
-    reg <<= 1;
+    reg >>= 1;
 
-    reg = bitSet(reg,0); // apparently lsb is 1
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 
-    if (isMSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    m_Bus.writeMemory(address, reg);
+}
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
+//////////////////////////////////////////////////////////////////////////////////
 
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
+template <class Bus>
+void Z80<Bus>::CPU_SLL(BYTE& reg)
+{
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SLL_MEMORY
 
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
 
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
+    BYTE carry = reg >> 7;
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    reg = (reg << 1) | 0x1; // apparently lsb is 1
 
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_SLL_MEMORY(WORD address)
+template <class Bus>
+void Z80<Bus>::CPU_SLL_MEMORY(WORD address)
 {
-    //WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SLL
-
-    m_ContextZ80.m_OpcodeCycle = 15;
-    BYTE reg = m_ContextZ80.m_FuncPtrRead(address);
-
-
-    bool isMSBSet = testBit(reg,7);
-
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
-    reg <<= 1;
-
-    reg = bitSet(reg,0); // apparently lsb is 1
-
-    if (isMSBSet)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
+    // WHEN EDITING THIS FUNCTION ALSO EDIT CPU_SLL
 
-    if (reg == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
 
-    if (testBit(reg,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
+    BYTE reg = m_Bus.readMemory(address);
 
-    //  if (TestBit(reg,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
-    //
-    //  if (TestBit(reg,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
+    BYTE carry = reg >> 7;
 
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(reg,i))
-            pcount++;
-    }
+    reg = (reg << 1) | 0x1; // apparently lsb is 1
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZP[reg] | carry;
 
-    m_ContextZ80.m_FuncPtrWrite(address,reg);
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_TEST_BIT(BYTE reg, int bit, int cycles)
+template <class Bus>
+void Z80<Bus>::CPU_TEST_BIT(BYTE reg, int bit)
 {
     bool isSet = false;
     if (testBit(reg, bit))
@@ -1750,237 +870,226 @@ void Z80::CPU_TEST_BIT(BYTE reg, int bit, int cycles)
     //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
     //  else
     //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
-
-    m_ContextZ80.m_OpcodeCycle = cycles;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_SET_BIT(BYTE& reg, int bit)
+template <class Bus>
+void Z80<Bus>::CPU_SET_BIT(BYTE& reg, int bit)
 {
     // WHEN EDITING THIS ALSO EDIT CPU_SET_BIT_MEMORY
     reg = bitSet(reg, bit);
-    m_ContextZ80.m_OpcodeCycle = 8;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_SET_BIT_MEMORY(WORD address, int bit)
+template <class Bus>
+void Z80<Bus>::CPU_SET_BIT_MEMORY(WORD address, int bit)
 {
     // WHEN EDITING THIS ALSO EDIT CPU_SET_BIT
-    BYTE mem = m_ContextZ80.m_FuncPtrRead(address);
+    BYTE mem = m_Bus.readMemory(address);
     mem = bitSet(mem, bit);
-    m_ContextZ80.m_FuncPtrWrite(address, mem);
-    m_ContextZ80.m_OpcodeCycle = 15;
+    m_Bus.writeMemory(address, mem);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_RESET_BIT(BYTE& reg, int bit)
+template <class Bus>
+void Z80<Bus>::CPU_RESET_BIT(BYTE& reg, int bit)
 {
     // WHEN EDITING THIS ALSO EDIT CPU_RESET_BIT_MEMORY
     reg = bitReset(reg, bit);
-    m_ContextZ80.m_OpcodeCycle = 8;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_RESET_BIT_MEMORY(WORD address, int bit)
+template <class Bus>
+void Z80<Bus>::CPU_RESET_BIT_MEMORY(WORD address, int bit)
 {
     // WHEN EDITING THIS ALSO EDIT CPU_RESET_BIT
-    BYTE mem = m_ContextZ80.m_FuncPtrRead(address);
+    BYTE mem = m_Bus.readMemory(address);
     mem = bitReset(mem, bit);
-    m_ContextZ80.m_FuncPtrWrite(address, mem);
-    m_ContextZ80.m_OpcodeCycle = 15;
+    m_Bus.writeMemory(address, mem);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_IN(BYTE& data)
+template <class Bus>
+void Z80<Bus>::CPU_IN(BYTE& data)
 {
-    m_ContextZ80.m_OpcodeCycle = 12;
-    data = m_ContextZ80.m_FuncPtrIORead(m_ContextZ80.m_RegisterBC.lo);
-
-    if (testBit(data,7))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo,FLAG_S);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_S);
-
-    if (data == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo,FLAG_Z);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_Z);
-
-    //  if (TestBit(data,5))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo,FLAG_B5);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_B5);
-    //
-    //  if (TestBit(data,3))
-    //      m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo,FLAG_B3);
-    //  else
-    //      m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_B3);
-
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_H);
-    m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_N);
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(data,i))
-            pcount++;
-    }
-
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-    else
-        m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
+    data = m_Bus.readIOMemory(m_ContextZ80.m_RegisterBC.lo);
 
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.SZP[data];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_OUT(const BYTE& address, const BYTE& data)
+template <class Bus>
+void Z80<Bus>::CPU_OUT(const BYTE& address, const BYTE& data)
 {
-    m_ContextZ80.m_OpcodeCycle = 12;
-    m_ContextZ80.m_FuncPtrIOWrite(address, data);
+    m_Bus.writeIOMemory(address, data);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_IN_IMMEDIATE(BYTE& data)
+template <class Bus>
+void Z80<Bus>::CPU_IN_IMMEDIATE(BYTE& data)
 {
-    m_ContextZ80.m_OpcodeCycle = 11;
-    BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+    BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
     m_ContextZ80.m_ProgramCounter++;
-    data = m_ContextZ80.m_FuncPtrIORead(n);
+    data = m_Bus.readIOMemory(n);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_OUT_IMMEDIATE(const BYTE& data)
+template <class Bus>
+void Z80<Bus>::CPU_OUT_IMMEDIATE(const BYTE& data)
 {
-    m_ContextZ80.m_OpcodeCycle = 11;
-    BYTE n = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+    BYTE n = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
     m_ContextZ80.m_ProgramCounter++;
-    m_ContextZ80.m_FuncPtrIOWrite(n, data);
+    m_Bus.writeIOMemory(n, data);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_OUTI()
+template <class Bus>
+void Z80<Bus>::CPU_OUTI()
 {
-    BYTE hldata = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
-    m_ContextZ80.m_FuncPtrIOWrite(m_ContextZ80.m_RegisterBC.lo, hldata);
+    BYTE hldata = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
+    m_Bus.writeIOMemory(m_ContextZ80.m_RegisterBC.lo, hldata);
 
     // increment hl
-    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg,0);
+    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg);
 
     // decrement b, and will set the appropriate flags
-    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi,0);
-
-
-    m_ContextZ80.m_OpcodeCycle = 16;
+    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_INI()
+template <class Bus>
+void Z80<Bus>::CPU_INI()
 {
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_FuncPtrIORead(m_ContextZ80.m_RegisterBC.lo));
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_Bus.readIOMemory(m_ContextZ80.m_RegisterBC.lo));
 
     // increment hl
-    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg,0);
+    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg);
 
     // decrement b, and will set the appropriate flags
-    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi,0);
-
-
-    m_ContextZ80.m_OpcodeCycle = 16;
+    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_INIR()
+template <class Bus>
+void Z80<Bus>::CPU_INIR()
 {
     CPU_INI();
     // keep calling this function until b == 0
     if (m_ContextZ80.m_RegisterBC.hi != 0)
     {
-        m_ContextZ80.m_OpcodeCycle = 21;
         m_ContextZ80.m_ProgramCounter-=2;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
-    else
-    {
-        m_ContextZ80.m_OpcodeCycle = 16;
-    }
-
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_IND()
+template <class Bus>
+void Z80<Bus>::CPU_IND()
 {
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, m_ContextZ80.m_FuncPtrIORead(m_ContextZ80.m_RegisterBC.lo));
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, m_Bus.readIOMemory(m_ContextZ80.m_RegisterBC.lo));
 
     // increment hl
-    CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg,0);
+    CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg);
 
     // decrement b, and will set the appropriate flags
-    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi,0);
-
-
-    m_ContextZ80.m_OpcodeCycle = 16;
+    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_INDR()
+template <class Bus>
+void Z80<Bus>::CPU_INDR()
 {
     CPU_IND();
     // keep calling this function until b == 0
     if (m_ContextZ80.m_RegisterBC.hi != 0)
     {
-        m_ContextZ80.m_OpcodeCycle = 21;
         m_ContextZ80.m_ProgramCounter-=2;
-    }
-    else
-    {
-        m_ContextZ80.m_OpcodeCycle = 16;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_OUTD()
+template <class Bus>
+void Z80<Bus>::CPU_OUTD()
 {
-    BYTE hldata = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
-    m_ContextZ80.m_FuncPtrIOWrite(m_ContextZ80.m_RegisterBC.lo, hldata);
+    BYTE hldata = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
+    m_Bus.writeIOMemory(m_ContextZ80.m_RegisterBC.lo, hldata);
 
     // increment hl
-    CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg,0);
+    CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg);
 
     // decrement b, and will set the appropriate flags
-    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi,0);
+    CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
+// The rest of an OTIR/OTDR to a port which takes a stream of data, ie the
+// vdp data port or the psg, is gathered up and handed to the bus in one go.
+// Only as many iterations as CPU_REPEAT_BLOCK allows are run this way.
+
+template <class Bus>
+void Z80<Bus>::CPU_OUT_BLOCK(BYTE opcode, bool increment)
+{
+    BYTE port = m_ContextZ80.m_RegisterBC.lo;
+    if ((m_ContextZ80.m_RegisterBC.hi == 0) || !m_Bus.isBlockIOPort(port))
+    {
+        return;
+    }
 
+    BYTE block[256];
+    int limit = m_Bus.getBlockRepeatLimit(Z80CYCLES.ED.taken[opcode]);
+    int repeats = 0;
+    while ((m_ContextZ80.m_RegisterBC.hi != 0) && CPU_REPEAT_BLOCK(opcode, repeats, limit))
+    {
+        block[repeats - 1] = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
+        if (increment)
+        {
+            CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg);
+        }
+        else
+        {
+            CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg);
+        }
+        CPU_8BIT_DEC(m_ContextZ80.m_RegisterBC.hi);
+    }
 
-    m_ContextZ80.m_OpcodeCycle = 16;
+    if (repeats != 0)
+    {
+        m_Bus.writeIOBlock(port, block, repeats, Z80CYCLES.ED.taken[opcode]);
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_OTDR()
+template <class Bus>
+void Z80<Bus>::CPU_OTDR()
 {
     CPU_OUTD();
+    CPU_OUT_BLOCK(0xBB, false);
+
     // keep calling this function until b == 0
     if (m_ContextZ80.m_RegisterBC.hi != 0)
     {
         m_ContextZ80.m_ProgramCounter-=2;
-        m_ContextZ80.m_OpcodeCycle = 21;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
     else
     {
-        m_ContextZ80.m_OpcodeCycle = 16;
         m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
         m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
     }
@@ -1989,20 +1098,22 @@ void Z80::CPU_OTDR()
 //////////////////////////////////////////////////////////////////////////////////
 
 
-void Z80::CPU_OTIR()
+template <class Bus>
+void Z80<Bus>::CPU_OTIR()
 {
     CPU_OUTI();
+    CPU_OUT_BLOCK(0xB3, true);
+
     // keep calling this function until b == 0
     if (m_ContextZ80.m_RegisterBC.hi != 0)
     {
         m_ContextZ80.m_ProgramCounter-=2;
-        m_ContextZ80.m_OpcodeCycle = 21;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
     else
     {
         m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
         m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-        m_ContextZ80.m_OpcodeCycle = 16;
         //   m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B5);
         //    m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
 
@@ -2011,16 +1122,16 @@ void Z80::CPU_OTIR()
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DJNZ()
+template <class Bus>
+void Z80<Bus>::CPU_DJNZ()
 {
     m_ContextZ80.m_RegisterBC.hi--; // dont think this affects flags
-    m_ContextZ80.m_OpcodeCycle = 8;
 
     if (m_ContextZ80.m_RegisterBC.hi!=0)
     {
-        SIGNED_BYTE n = (SIGNED_BYTE)m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+        SIGNED_BYTE n = (SIGNED_BYTE)m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
         m_ContextZ80.m_ProgramCounter += n;
-        m_ContextZ80.m_OpcodeCycle = 13;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::JumpRelative;
     }
 
     m_ContextZ80.m_ProgramCounter++;   
@@ -2028,13 +1139,14 @@ void Z80::CPU_DJNZ()
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LDI()
+template <class Bus>
+void Z80<Bus>::CPU_LDI()
 {
-    BYTE hldata =  m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterDE.reg,hldata);
-    CPU_16BIT_INC(m_ContextZ80.m_RegisterDE.reg,0);
-    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg,0);
-    CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg,0);
+    BYTE hldata =  m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterDE.reg,hldata);
+    CPU_16BIT_INC(m_ContextZ80.m_RegisterDE.reg);
+    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg);
+    CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg);
 
     m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
     m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
@@ -2055,33 +1167,70 @@ void Z80::CPU_LDI()
     //          m_ContextZ80.m_RegisterAF.lo = BitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
     //      else
     //          m_ContextZ80.m_RegisterAF.lo = BitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_B3);
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
+// Called between iterations of LDIR, LDDR, CPIR and CPDR. Rather than rewinding
+// the PC and going back round the main loop for every byte the next iteration
+// is run straight away, for as long as the bus says nothing would have happened
+// in between. The iterations run here are handed back to addBlockCycles().
+
+template <class Bus>
+bool Z80<Bus>::CPU_REPEAT_BLOCK(BYTE opcode, int& repeats, int limit)
+{
+    // stop if the block op has overwritten itself, the main loop would
+    // fetch whatever is there now
+    WORD pc = m_ContextZ80.m_ProgramCounterStart;
+    if ((repeats == limit)
+        || (m_Bus.readMemory(pc) != 0xED)
+        || (m_Bus.readMemory(pc + 1) != opcode))
+    {
+        return false;
+    }
 
-    m_ContextZ80.m_OpcodeCycle = 16;
+    // the prefix and the opcode are both fetched again every iteration
+    IncreaseRReg();
+    IncreaseRReg();
+    repeats++;
+    return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LDIR()
+template <class Bus>
+void Z80<Bus>::CPU_LDIR()
 {
     CPU_LDI();
+
+    int limit = (m_ContextZ80.m_RegisterBC.reg != 0) ? m_Bus.getBlockRepeatLimit(Z80CYCLES.ED.taken[0xB0]) : 0;
+    int repeats = 0;
+    while ((m_ContextZ80.m_RegisterBC.reg != 0) && CPU_REPEAT_BLOCK(0xB0, repeats, limit))
+    {
+        CPU_LDI();
+    }
+    if (repeats != 0)
+    {
+        m_Bus.addBlockCycles(Z80CYCLES.ED.taken[0xB0], repeats);
+    }
+
     // keep calling this function until bc == 0
     if (m_ContextZ80.m_RegisterBC.reg != 0)
     {
         m_ContextZ80.m_ProgramCounter-=2;
-        m_ContextZ80.m_OpcodeCycle = 21;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
     else
     {
-        m_ContextZ80.m_OpcodeCycle = 16;
         m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_EXCHANGE(WORD& reg1, WORD& reg2)
+template <class Bus>
+void Z80<Bus>::CPU_EXCHANGE(WORD& reg1, WORD& reg2)
 {
-    m_ContextZ80.m_OpcodeCycle = 4;
     WORD temp = reg1;
     reg1 = reg2;
     reg2 = temp;
@@ -2089,32 +1238,33 @@ void Z80::CPU_EXCHANGE(WORD& reg1, WORD& reg2)
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LOAD_NNN(WORD reg)
+template <class Bus>
+void Z80<Bus>::CPU_LOAD_NNN(WORD reg)
 {
     WORD nn = ReadWord();
     m_ContextZ80.m_ProgramCounter+=2;
-    m_ContextZ80.m_OpcodeCycle = 16;
-    m_ContextZ80.m_FuncPtrWrite(nn, reg&0xFF);
-    m_ContextZ80.m_FuncPtrWrite(nn+1, reg>>8);
+    m_Bus.writeMemory(nn, reg&0xFF);
+    m_Bus.writeMemory(nn+1, reg>>8);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_REG_LOAD_NNN(WORD& reg)
+template <class Bus>
+void Z80<Bus>::CPU_REG_LOAD_NNN(WORD& reg)
 {
     WORD nn = ReadWord();
     m_ContextZ80.m_ProgramCounter+=2;
-    m_ContextZ80.m_OpcodeCycle = 16;
-    reg = m_ContextZ80.m_FuncPtrRead(nn+1) << 8;
-    reg |= m_ContextZ80.m_FuncPtrRead(nn);
+    reg = m_Bus.readMemory(nn+1) << 8;
+    reg |= m_Bus.readMemory(nn);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LDD()
+template <class Bus>
+void Z80<Bus>::CPU_LDD()
 {
-    BYTE hlData = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterDE.reg, hlData);
+    BYTE hlData = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterDE.reg, hlData);
 
     m_ContextZ80.m_RegisterDE.reg--;
     m_ContextZ80.m_RegisterHL.reg--;
@@ -2138,202 +1288,169 @@ void Z80::CPU_LDD()
 
     m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
     m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_N);
-
-
-    m_ContextZ80.m_OpcodeCycle = 16;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LDDR()
+template <class Bus>
+void Z80<Bus>::CPU_LDDR()
 {
     CPU_LDD();
+
+    int limit = (m_ContextZ80.m_RegisterBC.reg != 0) ? m_Bus.getBlockRepeatLimit(Z80CYCLES.ED.taken[0xB8]) : 0;
+    int repeats = 0;
+    while ((m_ContextZ80.m_RegisterBC.reg != 0) && CPU_REPEAT_BLOCK(0xB8, repeats, limit))
+    {
+        CPU_LDD();
+    }
+    if (repeats != 0)
+    {
+        m_Bus.addBlockCycles(Z80CYCLES.ED.taken[0xB8], repeats);
+    }
+
     // keep calling this function until bc == 0
     if (m_ContextZ80.m_RegisterBC.reg != 0)
     {
-        m_ContextZ80.m_OpcodeCycle = 21;
         m_ContextZ80.m_ProgramCounter-=2;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
     else
     {
         m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-        m_ContextZ80.m_OpcodeCycle = 16;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_RLC(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_RLC(BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_RLC(reg,false);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_RRC(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_RRC(BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_RRC(reg,false);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
-
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_RL(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_RL(BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_RL(reg,false);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
-
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_RR(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_RR(BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_RR(reg,false);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
-
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_SLA (BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_SLA (BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_SLA(reg);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
-
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_SRA (BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_SRA (BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_SRA(reg);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_SRL (BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_SRL (BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_SRL(reg);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
-
+    m_Bus.writeMemory(address, reg);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_SLL (BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_SLL (BYTE& reg, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_SLL(reg);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
+    m_Bus.writeMemory(address, reg);
 }
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_NEG()
+template <class Bus>
+void Z80<Bus>::CPU_NEG()
 {
     BYTE before = m_ContextZ80.m_RegisterAF.hi;
 
-    m_ContextZ80.m_RegisterAF.lo = 0;
-
     m_ContextZ80.m_RegisterAF.hi = 0 - m_ContextZ80.m_RegisterAF.hi;
 
-    m_ContextZ80.m_OpcodeCycle = 8;
-
-    BYTE a = m_ContextZ80.m_RegisterAF.hi;
-
-    // correct
-    m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_N); 
-
-    // correct
-    if (a == 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_Z);
-
-    // correct
-    if (a > 127)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_S);
-
-    SIGNED_WORD htest = 0;
-    htest -= (before & 0xF);
-
-    // correct
-    if (htest < 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_H);
-
-    // correct
-    if (before == 128)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_PV);
-
-    // correct
-    if (before != 0)
-        m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
 
+    m_ContextZ80.m_RegisterAF.lo = Z80FLAGTABLES.SZ[m_ContextZ80.m_RegisterAF.hi] | (1 << FLAG_N)
+        | ((before & 0xF) ? (1 << FLAG_H) : 0)
+        | ((before == 128) ? (1 << FLAG_PV) : 0)
+        | ((before != 0) ? (1 << FLAG_C) : 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_RESET_BIT(BYTE& reg, int bit, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_RESET_BIT(BYTE& reg, int bit, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_RESET_BIT(reg,bit);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_SET_BIT(BYTE& reg, int bit, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_SET_BIT(BYTE& reg, int bit, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
+    reg = m_Bus.readMemory(address);
     CPU_SET_BIT(reg,bit);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 23;
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DDFD_TEST_BIT(BYTE reg, int bit, WORD& ixiyreg, SIGNED_BYTE& displacement)
+template <class Bus>
+void Z80<Bus>::CPU_DDFD_TEST_BIT(BYTE reg, int bit, WORD address)
 {
-    WORD address = ixiyreg + displacement;
-    reg = m_ContextZ80.m_FuncPtrRead(address);
-    CPU_TEST_BIT(reg,bit,0);
-    m_ContextZ80.m_FuncPtrWrite(address, reg);
-    m_ContextZ80.m_OpcodeCycle = 20;
+    reg = m_Bus.readMemory(address);
+    CPU_TEST_BIT(reg,bit);
+    m_Bus.writeMemory(address, reg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_RLD()
+template <class Bus>
+void Z80<Bus>::CPU_RLD()
 {
-    m_ContextZ80.m_OpcodeCycle = 2;
-    BYTE hldata = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
+    BYTE hldata = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
     BYTE nibbleloA = m_ContextZ80.m_RegisterAF.hi & 0xF;
     BYTE nibbleloHL = hldata & 0xF;
     BYTE nibblehiHL = hldata >> 4;
@@ -2343,44 +1460,17 @@ void Z80::CPU_RLD()
     hldata = nibbleloHL << 4;
     hldata |= nibbleloA;
 
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, hldata);
-
-
-    BYTE a = m_ContextZ80.m_RegisterAF.hi;
-    BYTE& f = m_ContextZ80.m_RegisterAF.lo;
-
-    if (testBit(a,7))
-        f = bitSet(f, FLAG_S);
-    else
-        f = bitReset(f,FLAG_S);
-
-    if (a==0)
-        f = bitSet(f, FLAG_Z);
-    else
-        f = bitReset(f,FLAG_Z);
-
-    f = bitReset(f,FLAG_H);
-    f = bitReset(f, FLAG_N);
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(a,i))
-            pcount++;
-    }
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, hldata);
 
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        f = bitSet(f, FLAG_PV);
-    else
-        f = bitReset(f, FLAG_PV);
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.SZP[m_ContextZ80.m_RegisterAF.hi];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_RRD()
+template <class Bus>
+void Z80<Bus>::CPU_RRD()
 {
-    m_ContextZ80.m_OpcodeCycle = 2;
-    BYTE hldata = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
+    BYTE hldata = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
     BYTE nibbleloA = m_ContextZ80.m_RegisterAF.hi & 0xF;
     BYTE nibbleloHL = hldata & 0xF;
     BYTE nibblehiHL = hldata >> 4;
@@ -2390,49 +1480,25 @@ void Z80::CPU_RRD()
     hldata = nibbleloA << 4;
     hldata |= nibblehiHL;
 
+    m_Bus.writeMemory(m_ContextZ80.m_RegisterHL.reg, hldata);
 
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_RegisterHL.reg, hldata);
-
-    BYTE a = m_ContextZ80.m_RegisterAF.hi;
-    BYTE& f = m_ContextZ80.m_RegisterAF.lo;
-
-    if (testBit(a,7))
-        f = bitSet(f, FLAG_S);
-    else
-        f = bitReset(f,FLAG_S);
-
-    if (a==0)
-        f = bitSet(f, FLAG_Z);
-    else
-        f = bitReset(f,FLAG_Z);
-
-    f = bitReset(f,FLAG_H);
-    f = bitReset(f, FLAG_N);
-
-    int pcount = 0;
-    for (int i = 0; i < 8; i++)
-    {
-        if (testBit(a,i))
-            pcount++;
-    }
-
-    if ((pcount == 0) || ((pcount % 2) == 0))
-        f = bitSet(f, FLAG_PV);
-    else
-        f = bitReset(f, FLAG_PV);
-
+    m_ContextZ80.m_RegisterAF.lo = (m_ContextZ80.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.SZP[m_ContextZ80.m_RegisterAF.hi];
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-BYTE Z80::CPU_CPI()
+template <class Bus>
+BYTE Z80<Bus>::CPU_CPI()
 {
     bool carry = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    BYTE res =  m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
+    BYTE res =  m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
 
-    CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi,res,0,false);
-    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg, 0);
-    CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg,0);
+    CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi,res,false);
+#ifdef Z80_LAZY_FLAGS
+    SyncFlags(); // PV and C are patched below
+#endif
+    CPU_16BIT_INC(m_ContextZ80.m_RegisterHL.reg);
+    CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg);
 
     if (m_ContextZ80.m_RegisterBC.reg == 0)
         m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_PV);
@@ -2444,37 +1510,51 @@ BYTE Z80::CPU_CPI()
     else
         m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo,FLAG_C);
 
-    m_ContextZ80.m_OpcodeCycle = 16;
     return res;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_CPIR()
+template <class Bus>
+void Z80<Bus>::CPU_CPIR()
 {
     BYTE hladdress = CPU_CPI();
+
+    bool repeat = (m_ContextZ80.m_RegisterBC.reg != 0) && (hladdress != m_ContextZ80.m_RegisterAF.hi);
+    int limit = repeat ? m_Bus.getBlockRepeatLimit(Z80CYCLES.ED.taken[0xB1]) : 0;
+    int repeats = 0;
+    while (repeat && CPU_REPEAT_BLOCK(0xB1, repeats, limit))
+    {
+        hladdress = CPU_CPI();
+        repeat = (m_ContextZ80.m_RegisterBC.reg != 0) && (hladdress != m_ContextZ80.m_RegisterAF.hi);
+    }
+    if (repeats != 0)
+    {
+        m_Bus.addBlockCycles(Z80CYCLES.ED.taken[0xB1], repeats);
+    }
+
     // keep calling this function until b == 0
     if ((m_ContextZ80.m_RegisterBC.reg != 0) && (hladdress != m_ContextZ80.m_RegisterAF.hi))
     {
-        m_ContextZ80.m_OpcodeCycle = 21;
         m_ContextZ80.m_ProgramCounter-=2;
-    }
-    else
-    {
-        m_ContextZ80.m_OpcodeCycle = 16;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-BYTE Z80::CPU_CPD()
+template <class Bus>
+BYTE Z80<Bus>::CPU_CPD()
 {
     bool carry = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
-    BYTE res = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_RegisterHL.reg);
+    BYTE res = m_Bus.readMemory(m_ContextZ80.m_RegisterHL.reg);
 
-    CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi,res ,0,false);
-    CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg, 0);
-    CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg,0);
+    CPU_8BIT_COMPARE(m_ContextZ80.m_RegisterAF.hi,res ,false);
+#ifdef Z80_LAZY_FLAGS
+    SyncFlags(); // PV and C are patched below
+#endif
+    CPU_16BIT_DEC(m_ContextZ80.m_RegisterHL.reg);
+    CPU_16BIT_DEC(m_ContextZ80.m_RegisterBC.reg);
 
     if (m_ContextZ80.m_RegisterBC.reg == 0)
         m_ContextZ80.m_RegisterAF.lo = bitReset(m_ContextZ80.m_RegisterAF.lo,FLAG_PV);
@@ -2486,50 +1566,60 @@ BYTE Z80::CPU_CPD()
     else
         m_ContextZ80.m_RegisterAF.lo = bitSet(m_ContextZ80.m_RegisterAF.lo,FLAG_C);
 
-    m_ContextZ80.m_OpcodeCycle = 16;
     return res;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_CPDR()
+template <class Bus>
+void Z80<Bus>::CPU_CPDR()
 {
     BYTE hladdress = CPU_CPD();
+
+    bool repeat = (m_ContextZ80.m_RegisterBC.reg != 0) && (hladdress != m_ContextZ80.m_RegisterAF.hi);
+    int limit = repeat ? m_Bus.getBlockRepeatLimit(Z80CYCLES.ED.taken[0xB9]) : 0;
+    int repeats = 0;
+    while (repeat && CPU_REPEAT_BLOCK(0xB9, repeats, limit))
+    {
+        hladdress = CPU_CPD();
+        repeat = (m_ContextZ80.m_RegisterBC.reg != 0) && (hladdress != m_ContextZ80.m_RegisterAF.hi);
+    }
+    if (repeats != 0)
+    {
+        m_Bus.addBlockCycles(Z80CYCLES.ED.taken[0xB9], repeats);
+    }
+
     // keep calling this function until bc == 0
     // or a == hladdress
     if ((m_ContextZ80.m_RegisterBC.reg != 0) && (hladdress != m_ContextZ80.m_RegisterAF.hi))
     {
-        m_ContextZ80.m_OpcodeCycle = 21;
         m_ContextZ80.m_ProgramCounter-=2;
-    }
-    else
-    {
-        m_ContextZ80.m_OpcodeCycle = 16;
+        m_ContextZ80.m_OpcodeCycle += Z80TakenCycles::Repeat;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_IXIY_LOAD(BYTE& store , const REGISTERZ80& reg)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_IXIY_LOAD(BYTE& store , const REGISTERZ80& reg)
 {
 
     CPU_REG_LOAD_ROM(store, GetIXIYAddress(reg.reg)) ;
-    m_ContextZ80.m_OpcodeCycle = 11;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_8BIT_MEM_IXIY_LOAD(BYTE store , const REGISTERZ80& reg)
+template <class Bus>
+void Z80<Bus>::CPU_8BIT_MEM_IXIY_LOAD(BYTE store , const REGISTERZ80& reg)
 {
-    m_ContextZ80.m_FuncPtrWrite(GetIXIYAddress(reg.reg), store);
-    m_ContextZ80.m_OpcodeCycle=19;
+    m_Bus.writeMemory(GetIXIYAddress(reg.reg), store);
 }
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_DAA()
+template <class Bus>
+void Z80<Bus>::CPU_DAA()
 {
-    m_ContextZ80.m_OpcodeCycle = 4;
 
     int i = m_ContextZ80.m_RegisterAF.hi;
     bool cSet = testBit(m_ContextZ80.m_RegisterAF.lo, FLAG_C);
@@ -2543,16 +1633,15 @@ void Z80::CPU_DAA()
     if (nSet) 
         i |= 0x400;
 
-    m_ContextZ80.m_RegisterAF.reg = m_DAATable[i];
-
+    m_ContextZ80.m_RegisterAF.reg = Z80FLAGTABLES.DAA[i];
 }
 
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LDA_I()
+template <class Bus>
+void Z80<Bus>::CPU_LDA_I()
 {
-    m_ContextZ80.m_OpcodeCycle = 9;
     m_ContextZ80.m_RegisterAF.hi = m_ContextZ80.m_RegisterI;
 
     if (m_ContextZ80.m_RegisterAF.hi == 0)
@@ -2576,9 +1665,9 @@ void Z80::CPU_LDA_I()
 
 //////////////////////////////////////////////////////////////////////////////////
 
-void Z80::CPU_LDA_R()
+template <class Bus>
+void Z80<Bus>::CPU_LDA_R()
 {
-    m_ContextZ80.m_OpcodeCycle = 9;
     m_ContextZ80.m_RegisterAF.hi = m_ContextZ80.m_RegisterR;
 
     if (m_ContextZ80.m_RegisterAF.hi == 0)
@@ -0,0 +1,432 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Z80.Profiler.hpp"
+#include "Z80.Mnemonics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    const char* TablePrefix[] = { "", "CB", "ED", "DD", "FD", "DDCB", "FDCB" };
+
+    template <std::size_t N>
+    constexpr std::size_t tableSize(const char* (&)[N]) { return N; }
+
+    //Z80MNEMONICSDE only lists the opcodes which exist, in order
+    const char* getEDMnemonic(BYTE opcode)
+    {
+        if (opcode >= 0x40 && opcode <= 0x76)
+        {
+            return Z80MNEMONICSDE[opcode - 0x40];
+        }
+        if (opcode >= 0x78 && opcode <= 0x7E)
+        {
+            return Z80MNEMONICSDE[opcode - 0x41];
+        }
+        if (opcode >= 0xA0 && opcode <= 0xBB && (opcode & 0x4) == 0)
+        {
+            return Z80MNEMONICSDE[62 + ((opcode >> 3) & 0x3) * 4 + (opcode & 0x3)];
+        }
+        return nullptr;
+    }
+
+    //DD and FD opcodes are the standard ones with HL swapped for the
+    //index register, and H and L for its two halves
+    std::string getIndexMnemonic(BYTE opcode, const std::string& index)
+    {
+        std::string name = Z80MNEMONICSSTANDARD[opcode];
+        if (opcode == 0xE9)
+        {
+            return "JP (" + index + ")";
+        }
+
+        auto pos = name.find("(HL)");
+        if (pos != std::string::npos)
+        {
+            return name.replace(pos, 4, "(" + index + "+d)");
+        }
+
+        pos = name.find("HL");
+        if (pos != std::string::npos)
+        {
+            return name.replace(pos, 2, index);
+        }
+
+        pos = name.find(' ');
+        while (pos != std::string::npos && pos + 1 < name.size())
+        {
+            char reg = name[pos + 1];
+            bool single = (pos + 2 == name.size()) || (name[pos + 2] == ',');
+            if (single && (reg == 'H' || reg == 'L'))
+            {
+                name.replace(pos + 1, 1, index + reg);
+            }
+            pos = name.find(',', pos + 1);
+        }
+        return name;
+    }
+
+    std::string toHex(unsigned value, int digits)
+    {
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "$%0*X", digits, value);
+        return buffer;
+    }
+
+    //where the operands start after the prefix and opcode
+    int getOperandStart(int table)
+    {
+        return (table == Z80Profiler::Table::Standard) ? 1 : 2;
+    }
+
+    //getLength() for every opcode in each table, as it's too slow to
+    //call for each instruction run. 0 where there's no instruction
+    using LengthTable = std::array<std::array<BYTE, 256>, Z80Profiler::Table::Count>;
+    const LengthTable& getLengths()
+    {
+        static const LengthTable lengths = []()
+        {
+            const BYTE prefixes[][3] = { {}, { 0xCB }, { 0xED }, { 0xDD }, { 0xFD }, { 0xDD, 0xCB }, { 0xFD, 0xCB } };
+
+            LengthTable table = {};
+            for (int t = 0; t < Z80Profiler::Table::Count; ++t)
+            {
+                for (int opcode = 0; opcode < 256; ++opcode)
+                {
+                    BYTE bytes[4] = { prefixes[t][0], prefixes[t][1], 0, 0 };
+                    switch (t)
+                    {
+                    case Z80Profiler::Table::Standard: bytes[0] = static_cast<BYTE>(opcode); break;
+                    case Z80Profiler::Table::DDCB:
+                    case Z80Profiler::Table::FDCB: bytes[3] = static_cast<BYTE>(opcode); break;
+                    default: bytes[1] = static_cast<BYTE>(opcode); break;
+                    }
+                    table[t][opcode] = static_cast<BYTE>(Z80Profiler::getLength(bytes));
+                }
+            }
+            return table;
+        }();
+        return lengths;
+    }
+
+    std::string getBankName(int bank)
+    {
+        char buffer[12];
+        if (bank < 0)
+        {
+            return "RAM";
+        }
+        std::snprintf(buffer, sizeof(buffer), "%02X", bank);
+        return buffer;
+    }
+}
+
+void Z80Profiler::reset()
+{
+    m_opcodes = {};
+    m_addresses.clear();
+    m_totalCycles = 0;
+    m_coverage.clear();
+    m_reads.clear();
+}
+
+void Z80Profiler::addCode(int table, BYTE opcode, const int* offsets)
+{
+    //a prefix which isn't followed by an instruction runs as a NOP
+    int length = std::max<int>(1, getLengths()[table][opcode]);
+    //only DDCB d op has an operand between its opcode bytes
+    bool indexedBits = (table == Table::DDCB || table == Table::FDCB);
+    for (int i = 0; i < length; ++i)
+    {
+        bool operand = indexedBits ? (i == 2) : (i >= getOperandStart(table));
+        addCoverage(offsets[i], operand ? Coverage::Operand : Coverage::Opcode);
+    }
+
+    //the opcode and operand fetches are in here as well
+    for (int offset : m_reads)
+    {
+        if (std::find(offsets, offsets + length, offset) == offsets + length)
+        {
+            addCoverage(offset, Coverage::Data);
+        }
+    }
+    m_reads.clear();
+}
+
+int Z80Profiler::getTable(const BYTE* bytes, BYTE& opcode)
+{
+    switch (bytes[0])
+    {
+    case 0xCB:
+        opcode = bytes[1];
+        return Table::CB;
+    case 0xED:
+        opcode = bytes[1];
+        return Table::ED;
+    case 0xDD:
+    case 0xFD:
+        if (bytes[1] == 0xCB)
+        {
+            // DDCB d op
+            opcode = bytes[3];
+            return (bytes[0] == 0xDD) ? Table::DDCB : Table::FDCB;
+        }
+        opcode = bytes[1];
+        return (bytes[0] == 0xDD) ? Table::DD : Table::FD;
+    default:
+        opcode = bytes[0];
+        return Table::Standard;
+    }
+}
+
+int Z80Profiler::getLength(const BYTE* bytes)
+{
+    BYTE opcode = 0;
+    int table = getTable(bytes, opcode);
+    std::string text = getMnemonic(table, opcode);
+
+    //a prefix followed by another prefix isn't an instruction
+    bool prefixed = (table == Table::DD || table == Table::FD)
+        && (opcode == 0xDD || opcode == 0xED || opcode == 0xFD);
+    if (text == "?" || prefixed)
+    {
+        return 0;
+    }
+
+    //DDCB d op, the only instruction with its operand before the opcode
+    if (table == Table::DDCB || table == Table::FDCB)
+    {
+        return 4;
+    }
+
+    //the same operands which disassemble() fills in
+    int length = getOperandStart(table);
+    if (text.find("+d") != std::string::npos)
+    {
+        ++length;
+    }
+
+    if (text.find("PC+e") != std::string::npos)
+    {
+        ++length;
+    }
+    else if (text.find("nn") != std::string::npos)
+    {
+        length += 2;
+    }
+    else if (text.find('n') != std::string::npos)
+    {
+        ++length;
+    }
+    return length;
+}
+
+std::string Z80Profiler::disassemble(const BYTE* bytes, WORD pc)
+{
+    BYTE opcode = 0;
+    int table = getTable(bytes, opcode);
+    std::string text = getMnemonic(table, opcode);
+
+    int operand = getOperandStart(table);
+
+    auto pos = text.find("+d");
+    if (pos != std::string::npos)
+    {
+        auto displacement = static_cast<SIGNED_BYTE>(bytes[operand++]);
+        text.replace(pos, 2, (displacement < 0 ? "-" : "+") + toHex(std::abs(displacement), 2));
+    }
+
+    if ((pos = text.find("PC+e")) != std::string::npos)
+    {
+        auto offset = static_cast<SIGNED_BYTE>(bytes[operand]);
+        text.replace(pos, 4, toHex(static_cast<WORD>(pc + 2 + offset), 4));
+    }
+    else if ((pos = text.find("nn")) != std::string::npos)
+    {
+        text.replace(pos, 2, toHex(bytes[operand] | (bytes[operand + 1] << 8), 4));
+    }
+    else
+    {
+        //only a lower case n is an operand, ie not the N of NZ
+        for (pos = 0; pos < text.size(); ++pos)
+        {
+            if (text[pos] == 'n')
+            {
+                text.replace(pos, 1, toHex(bytes[operand], 2));
+                break;
+            }
+        }
+    }
+    return text;
+}
+
+bool Z80Profiler::writeReport(const std::string& path, std::size_t maxLines) const
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    auto percent = [&](unsigned long long cycles)
+    {
+        return m_totalCycles ? (100.0 * static_cast<double>(cycles)) / static_cast<double>(m_totalCycles) : 0.0;
+    };
+
+    std::vector<std::pair<int, Entry>> opcodes;
+    for (int table = 0; table < Table::Count; ++table)
+    {
+        for (int opcode = 0; opcode < 256; ++opcode)
+        {
+            if (m_opcodes[table][opcode].count != 0)
+            {
+                opcodes.emplace_back((table << 8) | opcode, m_opcodes[table][opcode]);
+            }
+        }
+    }
+
+    std::vector<std::pair<std::uint32_t, Entry>> addresses(m_addresses.begin(), m_addresses.end());
+
+    auto byCycles = [](const auto& a, const auto& b) { return a.second.cycles > b.second.cycles; };
+    std::sort(opcodes.begin(), opcodes.end(), byCycles);
+    std::sort(addresses.begin(), addresses.end(), byCycles);
+
+    std::fprintf(file, "%llu cycles, %zu opcodes, %zu addresses\n\n", m_totalCycles, opcodes.size(), addresses.size());
+
+    std::fprintf(file, "%-6s %-4s %-22s %14s %14s %7s\n", "table", "op", "mnemonic", "count", "cycles", "%");
+    for (std::size_t i = 0; i < std::min(maxLines, opcodes.size()); ++i)
+    {
+        int table = opcodes[i].first >> 8;
+        BYTE opcode = opcodes[i].first & 0xFF;
+        const Entry& entry = opcodes[i].second;
+        std::fprintf(file, "%-6s %02X   %-22s %14llu %14llu %6.2f%%\n", TablePrefix[table], opcode,
+            getMnemonic(table, opcode).c_str(), entry.count, entry.cycles, percent(entry.cycles));
+    }
+
+    std::fprintf(file, "\n%-4s %-4s %14s %14s %7s\n", "bank", "pc", "count", "cycles", "%");
+    for (std::size_t i = 0; i < std::min(maxLines, addresses.size()); ++i)
+    {
+        int bank = static_cast<int>(addresses[i].first >> 16) - 1;
+        WORD address = addresses[i].first & 0xFFFF;
+        const Entry& entry = addresses[i].second;
+        std::fprintf(file, "%-4s %04X %14llu %14llu %6.2f%%\n", getBankName(bank).c_str(), address,
+            entry.count, entry.cycles, percent(entry.cycles));
+    }
+
+    std::fprintf(file, "\n%-4s %8s %8s %8s\n", "bank", "opcode", "operand", "data");
+    for (std::size_t start = 0; start < m_coverage.size(); start += BANK_SIZE)
+    {
+        int counts[3] = {};
+        for (std::size_t i = start; i < start + BANK_SIZE; ++i)
+        {
+            counts[0] += (m_coverage[i] & Coverage::Opcode) ? 1 : 0;
+            counts[1] += (m_coverage[i] & Coverage::Operand) ? 1 : 0;
+            counts[2] += (m_coverage[i] & Coverage::Data) ? 1 : 0;
+        }
+        if (counts[0] + counts[1] + counts[2] != 0)
+        {
+            std::fprintf(file, "%-4s %8d %8d %8d\n", getBankName(static_cast<int>(start / BANK_SIZE)).c_str(),
+                counts[0], counts[1], counts[2]);
+        }
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+bool Z80Profiler::writeCSV(const std::string& path) const
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    std::fprintf(file, "kind,table,opcode,mnemonic,bank,pc,count,cycles\n");
+    for (int table = 0; table < Table::Count; ++table)
+    {
+        for (int opcode = 0; opcode < 256; ++opcode)
+        {
+            const Entry& entry = m_opcodes[table][opcode];
+            if (entry.count != 0)
+            {
+                std::fprintf(file, "opcode,%s,%02X,\"%s\",,,%llu,%llu\n", TablePrefix[table], opcode,
+                    getMnemonic(table, static_cast<BYTE>(opcode)).c_str(), entry.count, entry.cycles);
+            }
+        }
+    }
+
+    for (const auto& [key, entry] : m_addresses)
+    {
+        int bank = static_cast<int>(key >> 16) - 1;
+        std::fprintf(file, "address,,,,%s,%04X,%llu,%llu\n", getBankName(bank).c_str(), key & 0xFFFF, entry.count, entry.cycles);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+bool Z80Profiler::writeCoverage(const std::string& path) const
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    bool written = std::fwrite(m_coverage.data(), 1, m_coverage.size(), file) == m_coverage.size();
+    std::fclose(file);
+    return written;
+}
+
+std::string Z80Profiler::getMnemonic(int table, BYTE opcode)
+{
+    //the DDCB/FDCB opcodes make up the last 256 entries of Z80MNEMONICSFD
+    const std::size_t indexedBits = tableSize(Z80MNEMONICSFD) - 256;
+    const char* name = nullptr;
+
+    switch (table)
+    {
+    case Table::Standard: return Z80MNEMONICSSTANDARD[opcode];
+    case Table::CB: return Z80MNEMONICSCB[opcode];
+    case Table::ED: name = getEDMnemonic(opcode); break;
+    case Table::DD: return getIndexMnemonic(opcode, "IX");
+    case Table::FD: return getIndexMnemonic(opcode, "IY");
+    case Table::DDCB:
+    {
+        std::string ix = Z80MNEMONICSFD[indexedBits + opcode];
+        ix.replace(ix.find("IY"), 2, "IX");
+        return ix;
+    }
+    case Table::FDCB: return Z80MNEMONICSFD[indexedBits + opcode];
+    default: break;
+    }
+    return name ? name : "?";
+}
@@ -0,0 +1,165 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Counts how often each opcode and each address in the emulated program
+// is run, and the cycles spent there. Only built with Z80_PROFILER defined,
+// and even then it does nothing until enabled, see Z80::GetProfiler().
+// Instructions the emulator skips over without running, such as idle loops
+// and the repeats of a block instruction, aren't counted - so a loop which
+// shows up hot here is one which isn't being skipped.
+//
+// It also keeps a map of which rom bytes have been run as opcodes, fetched
+// as their operands or read as data, by their offset in the rom so that
+// each 16KB bank is kept apart whatever it was paged to. Skipped loops make
+// no difference there, as each byte only has to be seen once.
+class Z80Profiler final
+{
+public:
+    struct Table final
+    {
+        enum
+        {
+            Standard, CB, ED, DD, FD, DDCB, FDCB,
+
+            Count
+        };
+    };
+
+    // the bits kept for each byte of the rom
+    struct Coverage final
+    {
+        enum
+        {
+            Opcode = 0x1,
+            Operand = 0x2,
+            Data = 0x4
+        };
+    };
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+    void reset();
+
+    // bank is the 16KB rom bank the address is paged to, or -1 for ram
+    void addInstruction(int table, BYTE opcode, int bank, WORD address, int cycles);
+
+    // called by the bus for each read the cpu makes, with the offset in the
+    // rom it was read from or -1 for ram. They're held until addCode()
+    void addRead(int offset);
+    // the instruction which has just run, with the rom offsets of the 4
+    // bytes from its address. Its own bytes are marked as code, and anything
+    // else it read from rom as data
+    void addCode(int table, BYTE opcode, const int* offsets);
+    // the coverage of a byte of the rom, 0 if it hasn't been touched
+    BYTE getCoverage(int offset) const;
+
+    // the busiest opcodes and addresses by cycles, most first
+    bool writeReport(const std::string& path, std::size_t maxLines = 50) const;
+    // everything, one row per opcode and per address
+    bool writeCSV(const std::string& path) const;
+    // the Coverage bits of each byte of the rom, up to the end of the
+    // last bank with anything in it
+    bool writeCoverage(const std::string& path) const;
+
+    static std::string getMnemonic(int table, BYTE opcode);
+    // works out the table of the instruction starting at bytes, which
+    // must hold at least 4, and the opcode it is looked up by there
+    static int getTable(const BYTE* bytes, BYTE& opcode);
+    // the length in bytes of the instruction starting at bytes, which must
+    // hold at least 4, or 0 if it isn't one the mnemonic tables know
+    static int getLength(const BYTE* bytes);
+    // the mnemonic with its n, nn, d and e operands filled in from the
+    // bytes, which must hold at least 4. pc is used for relative jumps
+    static std::string disassemble(const BYTE* bytes, WORD pc);
+
+private:
+    struct Entry final
+    {
+        unsigned long long count = 0;
+        unsigned long long cycles = 0;
+    };
+
+    std::array<std::array<Entry, 256>, Table::Count> m_opcodes = {};
+    std::unordered_map<std::uint32_t, Entry> m_addresses;
+    unsigned long long m_totalCycles = 0;
+    bool m_enabled = false;
+
+    // indexed by rom offset, and grown a bank at a time
+    static constexpr int BANK_SIZE = 0x4000;
+    std::vector<BYTE> m_coverage;
+    std::vector<int> m_reads;
+
+    void addCoverage(int offset, BYTE coverage);
+};
+
+inline void Z80Profiler::addInstruction(int table, BYTE opcode, int bank, WORD address, int cycles)
+{
+    Entry& op = m_opcodes[table][opcode];
+    op.count++;
+    op.cycles += cycles;
+
+    Entry& addr = m_addresses[(static_cast<std::uint32_t>(bank + 1) << 16) | address];
+    addr.count++;
+    addr.cycles += cycles;
+
+    m_totalCycles += cycles;
+}
+
+inline void Z80Profiler::addRead(int offset)
+{
+    if (offset >= 0)
+    {
+        m_reads.push_back(offset);
+    }
+}
+
+inline void Z80Profiler::addCoverage(int offset, BYTE coverage)
+{
+    if (offset < 0)
+    {
+        return;
+    }
+
+    if (offset >= static_cast<int>(m_coverage.size()))
+    {
+        m_coverage.resize((offset / BANK_SIZE + 1) * BANK_SIZE);
+    }
+    m_coverage[offset] |= coverage;
+}
+
+inline BYTE Z80Profiler::getCoverage(int offset) const
+{
+    return (offset >= 0) && (offset < static_cast<int>(m_coverage.size())) ? m_coverage[offset] : 0;
+}
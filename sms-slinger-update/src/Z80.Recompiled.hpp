@@ -0,0 +1,182 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+#include "Z80.hpp"
+#include "Z80.FlagTables.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// The interface between the Z80 and a rom compiled ahead of time by
+// sms-recompile, see tools/Recompiler.cpp. The recompiler turns runs of
+// simple instructions it finds in the rom into C++ functions which are
+// built into a shared library for that one rom. With Z80_RECOMPILED defined
+// the emulator loads it along with the rom, and whenever the pc lands on the
+// start of a block in the same bank that it was compiled from, the block
+// runs in place of the interpreter. The instruction which ended the block is
+// then interpreted as normal, so branches, IO and anything which the
+// recompiler can't prove is exact never leave the interpreter.
+//
+// Only the rom is ever compiled, so a block can't change once built. The
+// library is checked against the rom by its checksum and against this file
+// by Z80RECOMPILED_VERSION, which must be bumped whenever anything here or
+// CONTEXTZ80 changes.
+
+constexpr unsigned Z80RECOMPILED_VERSION = 1;
+
+// the name of the Z80RecompiledRom which the library exports
+#define Z80RECOMPILED_SYMBOL "sms_recompiled_rom"
+
+#ifdef _WIN32
+#define Z80RECOMPILED_EXPORT extern "C" __declspec(dllexport)
+#else
+#define Z80RECOMPILED_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+// a block goes through these to reach memory, exactly as the interpreter
+// would through its bus
+struct Z80RecompiledBus
+{
+    void*   bus;
+    BYTE    (*readMemory)(void* bus, WORD address);
+    void    (*writeMemory)(void* bus, WORD address, BYTE data);
+};
+
+// runs a block from its first instruction, returning how many of its
+// instructions ran. A block stops early rather than making a write which
+// might page memory, leaving that instruction to the interpreter.
+using Z80RecompiledFunction = int (*)(CONTEXTZ80& context, const Z80RecompiledBus& bus);
+
+struct Z80RecompiledBlock
+{
+    WORD                    address;
+    BYTE                    bank;       // the 16KB rom bank, see Emulator::getBank()
+    BYTE                    count;      // of instructions
+    int                     cycles;     // of all of them
+    const BYTE*             opcodeCycles; // of each of them, for Emulator::addCycles()
+    Z80RecompiledFunction   run;
+};
+
+struct Z80RecompiledRom
+{
+    unsigned                    version;
+    std::uint32_t               checksum;   // of the cartridge memory, see Z80RecompiledChecksum()
+    std::size_t                 count;
+    const Z80RecompiledBlock*   blocks;     // ordered by address, then bank
+};
+
+// FNV-1a of the whole of the cartridge memory as loaded, so a rom with or
+// without a header gives the same checksum
+inline std::uint32_t Z80RecompiledChecksum(const BYTE* data, std::size_t size)
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// The generated code is made of calls to these. Each one is the same as the
+// interpreter's handler for the instruction without lazy flags, and the Z80
+// syncs any lazy flags before running a block.
+
+inline int Z80RecompiledExit(CONTEXTZ80& context, WORD pc, int count)
+{
+    // R counts every instruction, which only moves its lower 7 bits
+    context.m_ProgramCounter = pc;
+    context.m_RegisterR = (context.m_RegisterR & 0x80) | ((context.m_RegisterR + count) & 0x7F);
+    return count;
+}
+
+// false for anything the Emulator does more than store, ie the paging
+// registers at the top of ram and anything below it, such as cartridge ram
+// or the Codemasters paging registers
+inline bool Z80RecompiledCanWrite(WORD address)
+{
+    return (address >= 0xC000) && (address < 0xFFFC);
+}
+
+inline void Z80RecompiledAdd(CONTEXTZ80& context, BYTE value, int carry)
+{
+    BYTE before = context.m_RegisterAF.hi;
+    int res = before + value + carry;
+    context.m_RegisterAF.hi = static_cast<BYTE>(res);
+    context.m_RegisterAF.lo = Z80AddFlags(before, value, res);
+}
+
+inline void Z80RecompiledSub(CONTEXTZ80& context, BYTE value, int carry)
+{
+    BYTE before = context.m_RegisterAF.hi;
+    int res = before - value - carry;
+    context.m_RegisterAF.hi = static_cast<BYTE>(res);
+    context.m_RegisterAF.lo = Z80SubFlags(before, value, res);
+}
+
+inline void Z80RecompiledCompare(CONTEXTZ80& context, BYTE value)
+{
+    BYTE before = context.m_RegisterAF.hi;
+    context.m_RegisterAF.lo = Z80SubFlags(before, value, before - value);
+}
+
+inline void Z80RecompiledAnd(CONTEXTZ80& context, BYTE value)
+{
+    context.m_RegisterAF.hi &= value;
+    context.m_RegisterAF.lo = Z80FLAGTABLES.SZP[context.m_RegisterAF.hi] | (1 << FLAG_H);
+}
+
+inline void Z80RecompiledOr(CONTEXTZ80& context, BYTE value)
+{
+    context.m_RegisterAF.hi |= value;
+    context.m_RegisterAF.lo = Z80FLAGTABLES.SZP[context.m_RegisterAF.hi];
+}
+
+inline void Z80RecompiledXor(CONTEXTZ80& context, BYTE value)
+{
+    context.m_RegisterAF.hi ^= value;
+    context.m_RegisterAF.lo = Z80FLAGTABLES.SZP[context.m_RegisterAF.hi];
+}
+
+inline void Z80RecompiledInc(CONTEXTZ80& context, BYTE& reg)
+{
+    reg++;
+    context.m_RegisterAF.lo = (context.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.Inc[reg];
+}
+
+inline void Z80RecompiledDec(CONTEXTZ80& context, BYTE& reg)
+{
+    reg--;
+    context.m_RegisterAF.lo = (context.m_RegisterAF.lo & ~Z80FLAGS_SZHVN) | Z80FLAGTABLES.Dec[reg];
+}
+
+inline int Z80RecompiledCarry(const CONTEXTZ80& context)
+{
+    return context.m_RegisterAF.lo & (1 << FLAG_C);
+}
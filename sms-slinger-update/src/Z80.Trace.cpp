@@ -0,0 +1,101 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Z80.Trace.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    //file header, followed by the records
+    const char TraceMagic[8] = { 'S', 'M', 'S', 'T', 'R', 'A', 'C', 'E' };
+    constexpr std::uint32_t TraceVersion = 2;
+}
+
+void Z80Trace::reset()
+{
+    m_next = 0;
+    m_dumped = false;
+}
+
+bool Z80Trace::write(const std::string& path) const
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    std::uint32_t header[2] = { TraceVersion, static_cast<std::uint32_t>(getCount()) };
+    std::fwrite(TraceMagic, sizeof(TraceMagic), 1, file);
+    std::fwrite(header, sizeof(header), 1, file);
+
+    //once the ring has wrapped the oldest record is the next one to be written
+    std::size_t first = (m_next > Size) ? static_cast<std::size_t>(m_next & (Size - 1)) : 0;
+    std::size_t count = getCount();
+    std::size_t tail = std::min(count, Size - first);
+    std::fwrite(&m_records[first], sizeof(TraceRecord), tail, file);
+    std::fwrite(&m_records[0], sizeof(TraceRecord), count - tail, file);
+
+    bool ok = (std::ferror(file) == 0);
+    std::fclose(file);
+    return ok;
+}
+
+bool Z80Trace::dump(const std::string& path)
+{
+    if (m_dumped)
+    {
+        return false;
+    }
+    m_dumped = true;
+    return write(path);
+}
+
+bool Z80Trace::read(const std::string& path, std::vector<TraceRecord>& records)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    char magic[sizeof(TraceMagic)] = {};
+    std::uint32_t header[2] = {};
+    bool ok = (std::fread(magic, sizeof(magic), 1, file) == 1)
+        && (std::fread(header, sizeof(header), 1, file) == 1)
+        && (std::memcmp(magic, TraceMagic, sizeof(magic)) == 0)
+        && (header[0] == TraceVersion);
+
+    if (ok)
+    {
+        records.resize(header[1]);
+        ok = (std::fread(records.data(), sizeof(TraceRecord), records.size(), file) == records.size());
+    }
+
+    std::fclose(file);
+    return ok;
+}
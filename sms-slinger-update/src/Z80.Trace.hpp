@@ -0,0 +1,88 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One instruction as things stood once it had run. It is kept to 24 bytes
+// with no padding so the ring can be written out as it is in memory and
+// read back by tools/TraceDecoder.cpp on the same kind of machine.
+struct TraceRecord final
+{
+    std::uint64_t cycle = 0; // the bus clock at the end of the instruction
+    WORD pc = 0; // where the instruction started
+    WORD af = 0;
+    WORD bc = 0;
+    WORD de = 0;
+    WORD hl = 0;
+    WORD sp = 0;
+    BYTE bytes[4] = {}; // the opcode and what follows, which may be more than it used
+};
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord is written to disk as is");
+
+// The last Z80Trace::Size instructions the cpu ran, kept while built with
+// Z80_TRACE defined. Nothing is formatted while running, a record is filled
+// in place so it is cheap enough to leave on, see Z80::TraceInstruction().
+// Records are stamped with the bus clock, so they line up with everything
+// else on it including the time skipped over while halted or idle.
+class Z80Trace final
+{
+public:
+    static constexpr std::size_t Size = 0x4000; // a power of 2
+
+    Z80Trace() : m_records(Size) {}
+
+    void reset();
+
+    // the next slot in the ring, which overwrites the oldest once full
+    TraceRecord& addRecord(std::uint64_t clock);
+    std::size_t getCount() const { return static_cast<std::size_t>(std::min<std::uint64_t>(m_next, Size)); }
+
+    // oldest first. dump() only writes the first time it's called after a
+    // reset, so a fault which keeps happening leaves the trace of the first
+    bool write(const std::string& path) const;
+    bool dump(const std::string& path);
+
+    static bool read(const std::string& path, std::vector<TraceRecord>& records);
+
+private:
+    std::vector<TraceRecord> m_records;
+    std::uint64_t m_next = 0;
+    bool m_dumped = false;
+};
+
+inline TraceRecord& Z80Trace::addRecord(std::uint64_t clock)
+{
+    TraceRecord& record = m_records[m_next & (Size - 1)];
+    record.cycle = clock;
+    ++m_next;
+    return record;
+}
@@ -0,0 +1,883 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Config.hpp"
+#include "Z80.Wide.hpp"
+#include "Z80.Cycles.hpp"
+#include "Z80.FlagTables.hpp"
+#include "Z80.Bus.hpp"
+
+#ifdef Z80_WIDE
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    // the 8 bit registers as opcodes encode them
+    struct Reg final
+    {
+        enum
+        {
+            B, C, D, E, H, L, Memory, A
+        };
+    };
+
+    // length in bytes of each opcode the wide core runs, or 0 for the rest
+    constexpr int WideLength(int opcode)
+    {
+        if ((opcode >= 0x40) && (opcode < 0xC0))
+        {
+            // LD r,r' and the ALU ops on a register, but not HALT
+            return (opcode == 0x76) ? 0 : 1;
+        }
+
+        switch (opcode & 0xC7)
+        {
+        case 0x04: // INC r
+        case 0x05: // DEC r
+            return 1;
+        case 0x06: // LD r,n
+        case 0xC6: // ALU A,n
+            return 2;
+        case 0xC2: // JP cc,nn
+            return 3;
+        }
+
+        switch (opcode)
+        {
+        case 0x00: // NOP
+        case 0x02: case 0x12: case 0x0A: case 0x1A: // LD (BC),A etc
+        case 0x03: case 0x13: case 0x23: // INC rr
+        case 0x0B: case 0x1B: case 0x2B: // DEC rr
+        case 0xEB: // EX DE,HL
+            return 1;
+        case 0x10: case 0x18: // DJNZ and JR
+        case 0x20: case 0x28: case 0x30: case 0x38: // JR cc
+            return 2;
+        case 0x01: case 0x11: case 0x21: // LD rr,nn
+        case 0x32: case 0x3A: // LD (nn),A and LD A,(nn)
+        case 0xC3: // JP nn
+            return 3;
+        }
+        return 0;
+    }
+
+    // The flags are worked out with arithmetic rather than Z80FLAGTABLES, as
+    // a table lookup for each lane would stop the compiler vectorising the loop
+    constexpr BYTE WideSZ(BYTE res)
+    {
+        return (res & (1 << FLAG_S)) | ((res == 0) ? (1 << FLAG_Z) : 0);
+    }
+
+    constexpr BYTE WideSZP(BYTE res)
+    {
+        BYTE parity = res ^ (res >> 4);
+        parity ^= parity >> 2;
+        parity ^= parity >> 1;
+        return WideSZ(res) | ((~parity & 1) << FLAG_PV);
+    }
+
+    constexpr BYTE WideIncFlags(BYTE res)
+    {
+        return WideSZ(res)
+            | (((res & 0xF) == 0) ? (1 << FLAG_H) : 0)
+            | ((res == 0x80) ? (1 << FLAG_PV) : 0);
+    }
+
+    constexpr BYTE WideDecFlags(BYTE res)
+    {
+        return WideSZ(res) | (1 << FLAG_N)
+            | (((res & 0xF) == 0xF) ? (1 << FLAG_H) : 0)
+            | ((res == 0x7F) ? (1 << FLAG_PV) : 0);
+    }
+
+    // as Z80AddFlags() and Z80SubFlags()
+    constexpr BYTE WideAddFlags(BYTE before, BYTE operand, int res)
+    {
+        return WideSZ(static_cast<BYTE>(res))
+            | ((before ^ res ^ operand) & (1 << FLAG_H))
+            | ((((operand ^ before ^ 0x80) & (operand ^ res)) >> 5) & (1 << FLAG_PV))
+            | ((res >> 8) & (1 << FLAG_C));
+    }
+
+    constexpr BYTE WideSubFlags(BYTE before, BYTE operand, int res)
+    {
+        return WideSZ(static_cast<BYTE>(res)) | (1 << FLAG_N)
+            | ((res >> 8) & (1 << FLAG_C))
+            | ((before ^ res ^ operand) & (1 << FLAG_H))
+            | ((((operand ^ before) & (before ^ res)) >> 5) & (1 << FLAG_PV));
+    }
+
+    constexpr bool WideFlagsMatchTables()
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            BYTE res = static_cast<BYTE>(i);
+            if ((WideSZ(res) != Z80FLAGTABLES.SZ[i])
+                || (WideSZP(res) != Z80FLAGTABLES.SZP[i])
+                || (WideIncFlags(res) != Z80FLAGTABLES.Inc[i])
+                || (WideDecFlags(res) != Z80FLAGTABLES.Dec[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(WideFlagsMatchTables(), "the wide flags have to match Z80FLAGTABLES");
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+bool Z80Wide<Bus>::AddLane(Z80<Bus>& cpu, Bus& bus, int cycleBudget)
+{
+    if (m_LaneCount == MAX_LANES)
+    {
+        return false;
+    }
+
+    m_Lanes[m_LaneCount++] = { &cpu, &bus, cycleBudget };
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Run()
+{
+    m_GroupCount = 0;
+    m_LogCount = 0;
+    m_EIPending = false;
+
+    for (int lane = 0; lane < m_LaneCount; ++lane)
+    {
+        // Z80::Run() always runs one instruction, so a lane which has no
+        // cycles to spare is left to it along with anything it has to see
+        const Lane& l = m_Lanes[lane];
+        int remaining = std::min(l.budget, l.bus->getQuietCycles());
+        if ((remaining > 0) && CanRunWide(*l.cpu))
+        {
+            Gather(lane);
+            m_Remaining[lane] = remaining;
+            m_Group[m_GroupCount++] = lane;
+        }
+        else
+        {
+            l.cpu->Run(l.budget);
+        }
+    }
+    m_LaneCount = 0;
+
+    Regroup();
+    while (m_GroupCount > 1)
+    {
+        if (!StepWide())
+        {
+            StepEach();
+        }
+        Regroup();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+bool Z80Wide<Bus>::CanRunWide(Z80<Bus>& cpu) const
+{
+    // an EI only takes effect after the next instruction, which
+    // Z80::ExecuteNextOpcode() has to run to see to it
+    const CONTEXTZ80* context = cpu.GetContext();
+    bool wide = !context->m_Halted && !context->m_EIPending;
+
+#ifdef Z80_PROFILER
+    wide = wide && !cpu.GetProfiler().isEnabled();
+#endif
+#ifdef Z80_DEBUGGER
+    wide = wide && !cpu.GetDebugger().isActive();
+#endif
+#ifdef Z80_TRACE
+    // the trace has to see every instruction
+    wide = false;
+#endif
+    return wide;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Gather(int lane)
+{
+    Z80<Bus>& cpu = *m_Lanes[lane].cpu;
+    cpu.SyncFlags();
+
+    const CONTEXTZ80& context = *cpu.GetContext();
+    m_Registers[Reg::B][lane] = context.m_RegisterBC.hi;
+    m_Registers[Reg::C][lane] = context.m_RegisterBC.lo;
+    m_Registers[Reg::D][lane] = context.m_RegisterDE.hi;
+    m_Registers[Reg::E][lane] = context.m_RegisterDE.lo;
+    m_Registers[Reg::H][lane] = context.m_RegisterHL.hi;
+    m_Registers[Reg::L][lane] = context.m_RegisterHL.lo;
+    m_Registers[Reg::A][lane] = context.m_RegisterAF.hi;
+    m_Flags[lane] = context.m_RegisterAF.lo;
+    m_RegisterR[lane] = context.m_RegisterR;
+    m_ProgramCounter[lane] = context.m_ProgramCounter;
+    m_ProgramCounterStart[lane] = context.m_ProgramCounterStart;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Scatter(int lane)
+{
+    CONTEXTZ80& context = *m_Lanes[lane].cpu->GetContext();
+    context.m_RegisterBC.hi = m_Registers[Reg::B][lane];
+    context.m_RegisterBC.lo = m_Registers[Reg::C][lane];
+    context.m_RegisterDE.hi = m_Registers[Reg::D][lane];
+    context.m_RegisterDE.lo = m_Registers[Reg::E][lane];
+    context.m_RegisterHL.hi = m_Registers[Reg::H][lane];
+    context.m_RegisterHL.lo = m_Registers[Reg::L][lane];
+    context.m_RegisterAF.hi = m_Registers[Reg::A][lane];
+    context.m_RegisterAF.lo = m_Flags[lane];
+    context.m_RegisterR = m_RegisterR[lane];
+    context.m_ProgramCounter = m_ProgramCounter[lane];
+    context.m_ProgramCounterStart = m_ProgramCounterStart[lane];
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Flush(int lane)
+{
+    if (m_LogCount != 0)
+    {
+        BYTE cycles[LOG_SIZE];
+        for (int i = 0; i < m_LogCount; ++i)
+        {
+            cycles[i] = m_Log[i][lane];
+        }
+        m_Lanes[lane].bus->addCycles(cycles, m_LogCount);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::FlushGroup()
+{
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        Flush(m_Group[g]);
+    }
+    m_LogCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Peel(int lane)
+{
+    // the lane leaves the group, and if it still has cycles to run
+    // its own Z80 runs them
+    Flush(lane);
+    Scatter(lane);
+
+    if (m_Remaining[lane] > 0)
+    {
+        m_Lanes[lane].cpu->Run(m_Remaining[lane]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Regroup()
+{
+    // nearly always every lane carries on at the same pc
+    bool together = true;
+    const WORD first = m_ProgramCounter[m_Group[0]];
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        together = together && (m_Remaining[lane] > 0) && (m_ProgramCounter[lane] == first);
+    }
+    if (together && (m_GroupCount > 1))
+    {
+        return;
+    }
+
+    // lanes which have reached the end of their Run() are done
+    int count = 0;
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        if (m_Remaining[lane] > 0)
+        {
+            m_Group[count++] = lane;
+        }
+        else
+        {
+            Peel(lane);
+        }
+    }
+    m_GroupCount = count;
+
+    // after a branch the group carries on with whichever pc most of the
+    // lanes went to, and the rest are peeled off
+    if (count > 1)
+    {
+        WORD pc = m_ProgramCounter[m_Group[0]];
+        int most = 0;
+        for (int g = 0; g < count; ++g)
+        {
+            WORD next = m_ProgramCounter[m_Group[g]];
+            if ((g != 0) && (next == pc))
+            {
+                continue;
+            }
+
+            int lanes = 0;
+            for (int other = 0; other < count; ++other)
+            {
+                lanes += (m_ProgramCounter[m_Group[other]] == next) ? 1 : 0;
+            }
+            if (lanes > most)
+            {
+                most = lanes;
+                pc = next;
+            }
+            if (lanes == count)
+            {
+                break;
+            }
+        }
+
+        m_GroupCount = 0;
+        for (int g = 0; g < count; ++g)
+        {
+            int lane = m_Group[g];
+            if (m_ProgramCounter[lane] == pc)
+            {
+                m_Group[m_GroupCount++] = lane;
+            }
+            else
+            {
+                Peel(lane);
+            }
+        }
+    }
+
+    // a group of one is no use to anyone
+    if (m_GroupCount == 1)
+    {
+        Peel(m_Group[0]);
+        m_GroupCount = 0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+bool Z80Wide<Bus>::CheckCode(WORD pc, const BYTE* code, int length)
+{
+    // each lane can have another bank paged in, or something else in ram
+    int count = 1;
+    for (int g = 1; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        Bus& bus = *m_Lanes[lane].bus;
+
+        bool same = true;
+        for (int i = 0; i < length; ++i)
+        {
+            same = same && (bus.readMemory(static_cast<WORD>(pc + i)) == code[i]);
+        }
+
+        if (same)
+        {
+            m_Group[count++] = lane;
+        }
+        else
+        {
+            Peel(lane);
+        }
+    }
+    m_GroupCount = count;
+
+    return count > 1;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+bool Z80Wide<Bus>::StepWide()
+{
+    // runs the instruction at the group's pc for every lane at once, unless
+    // it's one which only the lanes' own Z80s can run
+    if (m_EIPending)
+    {
+        return false;
+    }
+
+    const WORD pc = m_ProgramCounter[m_Group[0]];
+    Bus& bus = *m_Lanes[m_Group[0]].bus;
+
+    BYTE code[3] = {};
+    code[0] = bus.readMemory(pc);
+    const int length = WideLength(code[0]);
+    if (length == 0)
+    {
+        return false;
+    }
+
+    for (int i = 1; i < length; ++i)
+    {
+        code[i] = bus.readMemory(static_cast<WORD>(pc + i));
+    }
+
+    // the lanes which were peeled off here are picked up by Regroup()
+    if (!CheckCode(pc, code, length))
+    {
+        return true;
+    }
+
+    const BYTE opcode = code[0];
+    const BYTE n = code[1];
+    const WORD nn = static_cast<WORD>(code[1] | (code[2] << 8));
+
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        m_ProgramCounterStart[i] = pc;
+        m_ProgramCounter[i] = static_cast<WORD>(pc + length);
+        m_RegisterR[i] = (m_RegisterR[i] & 0x80) | ((m_RegisterR[i] + 1) & 0x7F);
+    }
+
+    alignas(32) LaneBytes taken = {};
+
+    if ((opcode >= 0x40) && (opcode < 0x80))
+    {
+        // LD r,r'
+        int dst = (opcode >> 3) & 7;
+        int src = opcode & 7;
+        if (src == Reg::Memory)
+        {
+            ReadMemory(Reg::H, Reg::L);
+        }
+        Load(dst, src);
+        if (dst == Reg::Memory)
+        {
+            WriteMemory(Reg::H, Reg::L);
+        }
+    }
+    else if ((opcode >= 0x80) && (opcode < 0xC0))
+    {
+        // ADD, ADC, SUB, SBC, AND, XOR, OR and CP on a register
+        int src = opcode & 7;
+        if (src == Reg::Memory)
+        {
+            ReadMemory(Reg::H, Reg::L);
+        }
+        ALU((opcode >> 3) & 7, m_Registers[src]);
+    }
+    else if (((opcode & 0xC7) >= 0x04) && ((opcode & 0xC7) <= 0x06))
+    {
+        // INC r, DEC r and LD r,n
+        int reg = (opcode >> 3) & 7;
+        if ((reg == Reg::Memory) && ((opcode & 0xC7) != 0x06))
+        {
+            ReadMemory(Reg::H, Reg::L);
+        }
+
+        switch (opcode & 0xC7)
+        {
+        case 0x04: Inc(reg); break;
+        case 0x05: Dec(reg); break;
+        default: LoadImmediate(reg, n); break;
+        }
+
+        if (reg == Reg::Memory)
+        {
+            WriteMemory(Reg::H, Reg::L);
+        }
+    }
+    else if ((opcode & 0xC7) == 0xC6)
+    {
+        // the ALU ops on n, which goes through the memory slot
+        LoadImmediate(Reg::Memory, n);
+        ALU((opcode >> 3) & 7, m_Registers[Reg::Memory]);
+    }
+    else if ((opcode & 0xC7) == 0xC2)
+    {
+        // JP cc,nn
+        Condition(taken, (opcode >> 3) & 7);
+        Branch(taken, nn);
+    }
+    else
+    {
+        // the pairs are BC, DE and HL for opcodes 0x0_, 0x1_ and 0x2_
+        const int high = (opcode >> 4) * 2;
+        const int low = high + 1;
+
+        switch (opcode)
+        {
+        case 0x00:
+            break;
+        case 0x01: case 0x11: case 0x21:
+            LoadImmediate(high, code[2]);
+            LoadImmediate(low, code[1]);
+            break;
+        case 0x03: case 0x13: case 0x23:
+            Inc16(high, low);
+            break;
+        case 0x0B: case 0x1B: case 0x2B:
+            Dec16(high, low);
+            break;
+        case 0x02: case 0x12:
+            Load(Reg::Memory, Reg::A);
+            WriteMemory(high, low);
+            break;
+        case 0x0A: case 0x1A:
+            ReadMemory(high, low);
+            Load(Reg::A, Reg::Memory);
+            break;
+        case 0x32:
+            Load(Reg::Memory, Reg::A);
+            WriteMemory(nn);
+            break;
+        case 0x3A:
+            ReadMemory(nn);
+            Load(Reg::A, Reg::Memory);
+            break;
+        case 0xEB:
+            std::swap(m_Registers[Reg::D], m_Registers[Reg::H]);
+            std::swap(m_Registers[Reg::E], m_Registers[Reg::L]);
+            break;
+        case 0x10:
+            // DJNZ
+            for (int i = 0; i < MAX_LANES; ++i)
+            {
+                m_Registers[Reg::B][i]--;
+                taken[i] = (m_Registers[Reg::B][i] != 0) ? 0xFF : 0;
+            }
+            Branch(taken, static_cast<WORD>(pc + 2 + static_cast<SIGNED_BYTE>(n)));
+            break;
+        case 0x18:
+            taken.fill(0xFF);
+            Branch(taken, static_cast<WORD>(pc + 2 + static_cast<SIGNED_BYTE>(n)));
+            break;
+        case 0x20: case 0x28: case 0x30: case 0x38:
+            // JR cc only has the first four conditions
+            Condition(taken, (opcode >> 3) & 3);
+            Branch(taken, static_cast<WORD>(pc + 2 + static_cast<SIGNED_BYTE>(n)));
+            break;
+        case 0xC3:
+            taken.fill(0xFF);
+            Branch(taken, nn);
+            break;
+        }
+    }
+
+    AddCycles(taken, opcode);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::StepEach()
+{
+    // the group stays together through an instruction which the wide core
+    // doesn't run by having each lane's own Z80 run it. Anything it does
+    // may look at the clock, so every lane is brought up to date first
+    FlushGroup();
+    m_EIPending = false;
+
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        const Lane& l = m_Lanes[lane];
+        Scatter(lane);
+
+        // the same checks as Z80::Run() makes after each instruction
+        int cycles = l.cpu->ExecuteNextOpcode();
+        bool carryOn = l.bus->addInstructionCycles(cycles);
+        const CONTEXTZ80* context = l.cpu->GetContext();
+        if (carryOn && !context->m_Halted)
+        {
+            m_Remaining[lane] = std::min(m_Remaining[lane] - cycles, l.bus->getQuietCycles());
+        }
+        else
+        {
+            m_Remaining[lane] = 0;
+        }
+        m_EIPending = m_EIPending || context->m_EIPending;
+
+        Gather(lane);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::AddCycles(const LaneBytes& taken, BYTE opcode)
+{
+    // a conditional op costs more in the lanes where it was taken
+    const BYTE base = Z80CYCLES.Main.base[opcode];
+    const BYTE extra = Z80CYCLES.Main.taken[opcode] - base;
+
+    LaneBytes& log = m_Log[m_LogCount];
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        log[i] = base + (taken[i] & extra);
+        m_Remaining[i] -= log[i];
+    }
+    m_LockstepCount += m_GroupCount;
+
+    if (++m_LogCount == LOG_SIZE)
+    {
+        FlushGroup();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Condition(LaneBytes& taken, int condition) const
+{
+    // NZ, Z, NC, C, PO, PE, P and M
+    constexpr int flags[] = { FLAG_Z, FLAG_C, FLAG_PV, FLAG_S };
+    const int flag = flags[condition >> 1];
+    const BYTE set = condition & 1;
+
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        taken[i] = (((m_Flags[i] >> flag) & 1) == set) ? 0xFF : 0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Branch(const LaneBytes& taken, WORD target)
+{
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        m_ProgramCounter[i] = taken[i] ? target : m_ProgramCounter[i];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::ReadMemory(int high, int low)
+{
+    // memory is reached through each lane's own bus
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        WORD address = static_cast<WORD>((m_Registers[high][lane] << 8) | m_Registers[low][lane]);
+        m_Registers[Reg::Memory][lane] = m_Lanes[lane].bus->readMemory(address);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::ReadMemory(WORD address)
+{
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        m_Registers[Reg::Memory][lane] = m_Lanes[lane].bus->readMemory(address);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::WriteMemory(int high, int low)
+{
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        WORD address = static_cast<WORD>((m_Registers[high][lane] << 8) | m_Registers[low][lane]);
+        m_Lanes[lane].bus->writeMemory(address, m_Registers[Reg::Memory][lane]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::WriteMemory(WORD address)
+{
+    for (int g = 0; g < m_GroupCount; ++g)
+    {
+        int lane = m_Group[g];
+        m_Lanes[lane].bus->writeMemory(address, m_Registers[Reg::Memory][lane]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Load(int dst, int src)
+{
+    m_Registers[dst] = m_Registers[src];
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::LoadImmediate(int dst, BYTE value)
+{
+    m_Registers[dst].fill(value);
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Inc(int reg)
+{
+    LaneBytes& r = m_Registers[reg];
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        r[i]++;
+        m_Flags[i] = (m_Flags[i] & ~Z80FLAGS_SZHVN) | WideIncFlags(r[i]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Dec(int reg)
+{
+    LaneBytes& r = m_Registers[reg];
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        r[i]--;
+        m_Flags[i] = (m_Flags[i] & ~Z80FLAGS_SZHVN) | WideDecFlags(r[i]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Inc16(int high, int low)
+{
+    LaneBytes& hi = m_Registers[high];
+    LaneBytes& lo = m_Registers[low];
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        WORD value = static_cast<WORD>(((hi[i] << 8) | lo[i]) + 1);
+        hi[i] = value >> 8;
+        lo[i] = value & 0xFF;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::Dec16(int high, int low)
+{
+    LaneBytes& hi = m_Registers[high];
+    LaneBytes& lo = m_Registers[low];
+    for (int i = 0; i < MAX_LANES; ++i)
+    {
+        WORD value = static_cast<WORD>(((hi[i] << 8) | lo[i]) - 1);
+        hi[i] = value >> 8;
+        lo[i] = value & 0xFF;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+void Z80Wide<Bus>::ALU(int operation, const LaneBytes& value)
+{
+    // the same results as CPU_8BIT_ADD() and the rest with eager flags
+    LaneBytes& a = m_Registers[Reg::A];
+
+    switch (operation)
+    {
+    case 0: // ADD
+    case 1: // ADC
+    {
+        const BYTE carryMask = (operation == 1) ? (1 << FLAG_C) : 0;
+        for (int i = 0; i < MAX_LANES; ++i)
+        {
+            BYTE before = a[i];
+            BYTE operand = value[i];
+            int res = before + operand + (m_Flags[i] & carryMask);
+            m_Flags[i] = WideAddFlags(before, operand, res);
+            a[i] = static_cast<BYTE>(res);
+        }
+    }
+        break;
+    case 2: // SUB
+    case 3: // SBC
+    case 7: // CP
+    {
+        const BYTE carryMask = (operation == 3) ? (1 << FLAG_C) : 0;
+        const bool keep = (operation == 7);
+        for (int i = 0; i < MAX_LANES; ++i)
+        {
+            BYTE before = a[i];
+            BYTE operand = value[i];
+            int res = before - operand - (m_Flags[i] & carryMask);
+            m_Flags[i] = WideSubFlags(before, operand, res);
+            a[i] = keep ? before : static_cast<BYTE>(res);
+        }
+    }
+        break;
+    case 4: // AND
+        for (int i = 0; i < MAX_LANES; ++i)
+        {
+            a[i] &= value[i];
+            m_Flags[i] = WideSZP(a[i]) | (1 << FLAG_H);
+        }
+        break;
+    case 5: // XOR
+        for (int i = 0; i < MAX_LANES; ++i)
+        {
+            a[i] ^= value[i];
+            m_Flags[i] = WideSZP(a[i]);
+        }
+        break;
+    case 6: // OR
+        for (int i = 0; i < MAX_LANES; ++i)
+        {
+            a[i] |= value[i];
+            m_Flags[i] = WideSZP(a[i]);
+        }
+        break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template class Z80Wide<Z80Bus>;
+
+#endif //Z80_WIDE
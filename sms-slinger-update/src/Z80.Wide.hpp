@@ -0,0 +1,131 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Config.hpp"
+#include "Z80.hpp"
+
+#include <array>
+
+// An experimental interpreter which runs many copies of the same rom at once,
+// such as a batch of bots playing one game with different inputs. Only built
+// with Z80_WIDE defined. Each lane is a Z80 with a bus of its own, and while
+// lanes are at the same pc with the same code there, the instruction is
+// decoded once and run for all of them. The main registers of every lane are
+// held side by side, so an op such as ADD A,B is a loop over each register's
+// lanes rather than one dispatch per lane.
+//
+// Only the simple loads, ALU ops and jumps are run this way. Anything else is
+// run by each lane's own Z80 in turn, after which the lanes carry on together
+// if they're still at the same pc. A lane which ends up somewhere else, or
+// finds different code at the pc, is peeled off to finish its Run() alone.
+// Every lane is left exactly as Z80::Run() would have left it.
+//
+// The lane loops are plain C++ over 32 byte arrays, which the compiler turns
+// into single AVX2 ops when it's allowed to use them. The SMS_WIDE_AVX2 cmake
+// option (on by default) passes -mavx2 or /arch:AVX2 for that.
+//
+// The bus must provide getQuietCycles() and addCycles(), see Z80.hpp.
+template <class Bus>
+class Z80Wide final
+{
+public:
+    static constexpr int MAX_LANES = 32;
+
+    // adds a lane to the next Run(), which runs it as cpu.Run(cycleBudget)
+    // would. Returns false if there are already MAX_LANES
+    bool            AddLane(Z80<Bus>& cpu, Bus& bus, int cycleBudget);
+
+    // runs every lane added since the last call
+    void            Run();
+
+    // the instructions which ran in lockstep, counted once for each lane
+    unsigned long long GetLockstepCount() const { return m_LockstepCount; }
+
+private:
+    using LaneBytes = std::array<BYTE, MAX_LANES>;
+    using LaneWords = std::array<WORD, MAX_LANES>;
+
+    struct Lane final
+    {
+        Z80<Bus>*   cpu = nullptr;
+        Bus*        bus = nullptr;
+        int         budget = 0;
+    };
+
+    std::array<Lane, MAX_LANES> m_Lanes = {};
+    int             m_LaneCount = 0;
+
+    // the lanes running in lockstep, which are always at the same pc
+    std::array<int, MAX_LANES> m_Group = {};
+    int             m_GroupCount = 0;
+    bool            m_EIPending = false;
+
+    // the registers of every lane. The 8 bit registers are in the order
+    // opcodes encode them in, with slot 6 holding whatever an op reads
+    // from or writes to memory. Lanes outside the group hold nothing useful
+    alignas(32) LaneBytes m_Registers[8] = {};
+    alignas(32) LaneBytes m_Flags = {};
+    alignas(32) LaneBytes m_RegisterR = {};
+    alignas(32) LaneWords m_ProgramCounter = {};
+    alignas(32) LaneWords m_ProgramCounterStart = {};
+    // the cycles each lane can run before Z80::Run() would have returned
+    alignas(32) std::array<int, MAX_LANES> m_Remaining = {};
+
+    // the cycles of each instruction run in lockstep, which are only
+    // passed on to the buses before anything else could look at the clock
+    static constexpr int LOG_SIZE = 64;
+    alignas(32) LaneBytes m_Log[LOG_SIZE] = {};
+    int             m_LogCount = 0;
+
+    unsigned long long m_LockstepCount = 0;
+
+    bool            CanRunWide(Z80<Bus>& cpu) const;
+    void            Gather(int lane);
+    void            Scatter(int lane);
+    void            Flush(int lane);
+    void            FlushGroup();
+    void            Peel(int lane);
+    void            Regroup();
+    bool            CheckCode(WORD pc, const BYTE* code, int length);
+    bool            StepWide();
+    void            StepEach();
+
+    void            AddCycles(const LaneBytes& taken, BYTE opcode);
+    void            Condition(LaneBytes& taken, int condition) const;
+    void            Branch(const LaneBytes& taken, WORD target);
+    void            ReadMemory(int high, int low);
+    void            ReadMemory(WORD address);
+    void            WriteMemory(int high, int low);
+    void            WriteMemory(WORD address);
+    void            Load(int dst, int src);
+    void            LoadImmediate(int dst, BYTE value);
+    void            Inc(int reg);
+    void            Dec(int reg);
+    void            Inc16(int high, int low);
+    void            Dec16(int high, int low);
+    void            ALU(int operation, const LaneBytes& value);
+};
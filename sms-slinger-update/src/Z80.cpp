@@ -26,27 +26,32 @@
 #include "Config.hpp"
 #include "Z80.hpp"
 #include "LogMessages.hpp"
-#include "Z80.Mnemonics.hpp"
+#include "Z80.Bus.hpp"
+
+#ifdef Z80_RECOMPILED
+#include "Z80.Recompiled.hpp"
+#endif
 
-#include <cassert>
 #include <cstdio>
-#include <cstring>
 
 
 ///////////////////////////////////////////////////////////////////////
 
-Z80::Z80()
+template <class Bus>
+Z80<Bus>::Z80(Bus& bus)
+    : m_Bus(bus)
 {
-    std::memset(&m_DAATable,0,sizeof(m_DAATable));
-    std::memset(&m_ZSPTable,0,sizeof(m_ZSPTable));
-    InitDAATable();
+#ifdef Z80_BLOCK_CACHE
+    FlushCodeCache();
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-WORD Z80::GetIXIYAddress(WORD ixiy)
+template <class Bus>
+WORD Z80<Bus>::GetIXIYAddress(WORD ixiy)
 {
-    SIGNED_BYTE offset = (SIGNED_BYTE)m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+    SIGNED_BYTE offset = (SIGNED_BYTE)m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
     m_ContextZ80.m_ProgramCounter++;
 
     return ixiy+offset;
@@ -54,45 +59,60 @@ WORD Z80::GetIXIYAddress(WORD ixiy)
 
 ///////////////////////////////////////////////////////////////////////
 
-WORD Z80::ReadWord() const
+template <class Bus>
+WORD Z80<Bus>::ReadWord() const
 {
-    WORD res = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter+1);
+    WORD res = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter+1);
     res = res << 8;
-    res |= m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+    res |= m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
     return res;
 }
 
 //////////////////////////////////////////////////////////////////
 
-void Z80::PushWordOntoStack(WORD word)
+template <class Bus>
+void Z80<Bus>::PushWordOntoStack(WORD word)
 {
     BYTE hi = word >> 8;
     BYTE lo = word & 0xFF;
     m_ContextZ80.m_StackPointer.reg--;
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_StackPointer.reg, hi);
+    m_Bus.writeMemory(m_ContextZ80.m_StackPointer.reg, hi);
     m_ContextZ80.m_StackPointer.reg--;
-    m_ContextZ80.m_FuncPtrWrite(m_ContextZ80.m_StackPointer.reg, lo);
+    m_Bus.writeMemory(m_ContextZ80.m_StackPointer.reg, lo);
 }
 
 //////////////////////////////////////////////////////////////////
 
-WORD Z80::PopWordOffStack()
+template <class Bus>
+WORD Z80<Bus>::PopWordOffStack()
 {
-    WORD word = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_StackPointer.reg+1) << 8;
-    word |= m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_StackPointer.reg);
+    WORD word = m_Bus.readMemory(m_ContextZ80.m_StackPointer.reg+1) << 8;
+    word |= m_Bus.readMemory(m_ContextZ80.m_StackPointer.reg);
     m_ContextZ80.m_StackPointer.reg+=2;
     return word;
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-int Z80::ExecuteNextOpcode()
+template <class Bus>
+template <bool debug>
+int Z80<Bus>::ExecuteNextOpcode()
 {
-    m_ContextZ80.m_OpcodeCycle = 0;
-
-    BYTE opcode = m_ContextZ80.m_FuncPtrRead(m_ContextZ80.m_ProgramCounter);
+#if defined(Z80_RECOMPILED) && !defined(Z80_TRACE)
+    // a compiled block runs everything up to the instruction which ends
+    // it, and that one runs below as normal. Only rom is ever compiled,
+    // and never in a trace build as the trace has to see every instruction
+    if (!debug && (m_ContextZ80.m_ProgramCounter < m_Recompiled.size()))
+    {
+        RunRecompiled();
+    }
+#endif
 
-    LogInstInfo(opcode, "", false);
+#ifdef Z80_BLOCK_CACHE
+    // the debug path has to see the pc of every instruction
+    BYTE opcode = ExecuteCachedOpcode(!debug);
+#else
+    BYTE opcode = m_Bus.readMemory(m_ContextZ80.m_ProgramCounter);
 
     //if (m_ContextZ80.m_ProgramCounterStart == 0x88)
     //  _asm int 3;
@@ -100,8 +120,25 @@ int Z80::ExecuteNextOpcode()
     m_ContextZ80.m_ProgramCounterStart = m_ContextZ80.m_ProgramCounter;
     m_ContextZ80.m_ProgramCounter++;
 
+#ifdef Z80_PROFILER
+    if (m_Profiler.isEnabled())
+    {
+        ProfileFetch();
+    }
+#endif
 
     ExecuteOpcode(opcode);
+#endif
+
+#ifdef Z80_PROFILER
+    if (m_Profiler.isEnabled())
+    {
+        ProfileInstruction(m_ContextZ80.m_ProgramCounterStart, m_ContextZ80.m_OpcodeCycle);
+    }
+#endif
+#ifdef Z80_TRACE
+    TraceInstruction(m_ContextZ80.m_ProgramCounterStart, m_ContextZ80.m_OpcodeCycle);
+#endif
 
     // if the last opcode we executed wasnt EI (0xFB) but we are pending the enable of interupts
     // then enable them.
@@ -110,102 +147,230 @@ int Z80::ExecuteNextOpcode()
         m_ContextZ80.m_EIPending = false;
         m_ContextZ80.m_IFF1 = true;
         m_ContextZ80.m_IFF2 = true;
+        InteruptsEnabled();
     }
 
+    return m_ContextZ80.m_OpcodeCycle;
+}
 
-    if (m_ContextZ80.m_OpcodeCycle == 0)
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+int Z80<Bus>::Run(int cycleBudget)
+{
+    // runs at least one instruction, then carries on until the budget is
+    // used up, the cpu halts or the bus wants to step in, ie when an
+    // interrupt or the next scanline is due. Returns the cycles run.
+#ifdef Z80_DEBUGGER
+    if (m_Debugger.isActive())
     {
-        char buffer[255];
-        sprintf(buffer, "Opcode %x didnt add to m_CyclesThisUpdate", opcode);
-        LogMessage::GetSingleton()->DoLogMessage(buffer,true);
-        assert(false);
+        return RunLoop<true>(cycleBudget);
     }
+#endif
+    return RunLoop<false>(cycleBudget);
+}
 
-    return m_ContextZ80.m_OpcodeCycle;
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+template <bool debug>
+int Z80<Bus>::RunLoop(int cycleBudget)
+{
+    int total = 0;
+    bool carryOn = true;
+    do
+    {
+#ifdef Z80_DEBUGGER
+        // a breakpoint stops the cpu before the instruction runs, which
+        // may be before running any at all
+        if (debug && m_Debugger.checkBreakpoint(m_ContextZ80.m_ProgramCounter))
+        {
+            break;
+        }
+#endif
+        int cycles = ExecuteNextOpcode<debug>();
+        total += cycles;
+        carryOn = m_Bus.addInstructionCycles(cycles);
+
+#ifdef Z80_DEBUGGER
+        // a watchpoint stops it after the instruction making the access
+        if (debug && m_Debugger.isPaused())
+        {
+            break;
+        }
+#endif
+    } while (carryOn && (total < cycleBudget) && !m_ContextZ80.m_Halted);
+
+    return total;
 }
 
 ///////////////////////////////////////////////////////////////////////
 
-void Z80::LogInstInfo(BYTE opcode, const char* subset, bool showmnemonic)
+template <class Bus>
+void Z80<Bus>::TakeInterupt()
 {
-    if (false)
+    // the nmi is edge triggered so it's lowered as it's taken. The vdp
+    // holds the irq line up until its status is read
+    if ((m_ContextZ80.m_InteruptLines & InteruptLine::NMI) && !m_ContextZ80.m_NMIServicing)
     {
-        char buffer[255];
-        sprintf(buffer, "%s%x %s. PC: %x. AF: %x. BC: %x. DE: %x. HL: %x.", subset, opcode,(showmnemonic)?Z80MNEMONICSSTANDARD[opcode]:"",m_ContextZ80.m_ProgramCounter, m_ContextZ80.m_RegisterAF.reg,m_ContextZ80.m_RegisterBC.reg,m_ContextZ80.m_RegisterDE.reg,m_ContextZ80.m_RegisterHL.reg);
-        LogMessage::GetSingleton()->DoLogMessage(buffer,false);
+        IncreaseRReg();
+        m_ContextZ80.m_InteruptLines &= ~InteruptLine::NMI;
+        m_ContextZ80.m_NMIServicing = true;
+        m_ContextZ80.m_IFF1 = false;
+        m_ContextZ80.m_Halted = false;
+        PushWordOntoStack(m_ContextZ80.m_ProgramCounter);
+        m_ContextZ80.m_ProgramCounter = 0x66;
+    }
+    else if ((m_ContextZ80.m_InteruptLines & InteruptLine::IRQ) && m_ContextZ80.m_IFF1
+        && (m_ContextZ80.m_InteruptMode == 1))
+    {
+        IncreaseRReg();
+        m_ContextZ80.m_Halted = false;
+        PushWordOntoStack(m_ContextZ80.m_ProgramCounter);
+        m_ContextZ80.m_ProgramCounter = 0x38;
+        m_ContextZ80.m_IFF1 = false;
+        m_ContextZ80.m_IFF2 = false;
     }
 }
 
 ///////////////////////////////////////////////////////////////////////
 
+#ifdef Z80_PROFILER
+template <class Bus>
+void Z80<Bus>::ProfileInstruction(WORD address, int cycles)
+{
+    BYTE bytes[4];
+    for (WORD i = 0; i < 4; ++i)
+    {
+        bytes[i] = m_Bus.peekMemory(address + i);
+    }
+
+    BYTE opcode = 0;
+    int table = Z80Profiler::getTable(bytes, opcode);
+    m_Profiler.addInstruction(table, opcode, m_Bus.getBank(address), address, cycles);
+    m_Profiler.addCode(table, opcode, m_ProfileOffsets.data());
+}
 
+///////////////////////////////////////////////////////////////////////
 
+template <class Bus>
+void Z80<Bus>::ProfileFetch()
+{
+    WORD address = m_ContextZ80.m_ProgramCounterStart;
+    for (WORD i = 0; i < 4; ++i)
+    {
+        m_ProfileOffsets[i] = m_Bus.getRomOffset(address + i);
+    }
+}
 
+///////////////////////////////////////////////////////////////////////
+#endif
 
-//////////////////////////////////////////////////////////////////////////////////
+#ifdef Z80_RECOMPILED
+namespace
+{
+    template <class Bus>
+    BYTE RecompiledRead(void* bus, WORD address)
+    {
+        return static_cast<Bus*>(bus)->readMemory(address);
+    }
 
-void Z80::InitDAATable()
+    template <class Bus>
+    void RecompiledWrite(void* bus, WORD address, BYTE data)
+    {
+        static_cast<Bus*>(bus)->writeMemory(address, data);
+    }
+}
+
+template <class Bus>
+void Z80<Bus>::SetRecompiledRom(const Z80RecompiledRom* rom)
 {
+    m_Recompiled.clear();
+    m_RecompiledEnd = nullptr;
+    if (rom == nullptr)
+    {
+        return;
+    }
 
-    for (int i = 0; i < 256; ++i) 
+    // rom is only ever paged below 0xC000. Going backwards leaves the
+    // first of the blocks for each address in the table
+    m_Recompiled.resize(0xC000);
+    for (std::size_t i = rom->count; i-- > 0;)
     {
-        BYTE zFlag = (i == 0) ? 0x40 : 0;
-        BYTE sFlag = i & 0x80;
-        BYTE vFlag = 0x04;
-        for (int v = 128; v != 0; v >>= 1) 
+        const Z80RecompiledBlock& block = rom->blocks[i];
+        if (block.address < m_Recompiled.size())
         {
-            if (i & v)
-            {
-                vFlag ^= 0x04;
-            }
+            m_Recompiled[block.address] = &block;
         }
-        m_ZSPTable[i] = zFlag | sFlag | vFlag;
     }
+    m_RecompiledEnd = rom->blocks + rom->count;
+}
 
+///////////////////////////////////////////////////////////////////////
 
+template <class Bus>
+void Z80<Bus>::RunRecompiled()
+{
+    // a block runs in one go, so it can only start when nothing else can
+    // happen before its last instruction. EI only lets interrupts in once
+    // the next instruction has run, which the interpreter has to see
+    WORD pc = m_ContextZ80.m_ProgramCounter;
+    const Z80RecompiledBlock* block = m_Recompiled[pc];
+    if ((block == nullptr) || m_ContextZ80.m_EIPending)
+    {
+        return;
+    }
+#ifdef Z80_PROFILER
+    // the profiler has to see every instruction while it's counting
+    if (m_Profiler.isEnabled())
+    {
+        return;
+    }
+#endif
 
-    for (int x = 0; x < 0x800; ++x) 
+    int bank = m_Bus.getBank(pc);
+    for (; (block != m_RecompiledEnd) && (block->address == pc); ++block)
     {
-        bool nf = x & 0x400;
-        bool hf = x & 0x200;
-        bool cf = x & 0x100;
-        BYTE a = x & 0xFF;
-        BYTE hi = a / 16;
-        BYTE lo = a & 15;
-        BYTE diff;
-        if (cf) 
-        {
-            diff = ((lo <= 9) && !hf) ? 0x60 : 0x66;
-        } 
-        else 
+        if (block->bank == bank)
         {
-            if (lo >= 10) 
-            {
-                diff = (hi <= 8) ? 0x06 : 0x66;
-            }
-            else 
+            if (block->cycles < m_Bus.getQuietCycles())
             {
-                if (hi >= 10) 
-                {
-                    diff = hf ? 0x66 : 0x60;
-                }
-                else 
-                {
-                    diff = hf ? 0x06 : 0x00;
-                }
+                SyncFlags();
+                const Z80RecompiledBus bus = { &m_Bus, &RecompiledRead<Bus>, &RecompiledWrite<Bus> };
+                int count = block->run(m_ContextZ80, bus);
+                m_Bus.addCycles(block->opcodeCycles, count);
             }
+            return;
         }
-        BYTE res_a = nf ? a - diff : a + diff;
-        BYTE res_f = m_ZSPTable[res_a] | (nf ? 0x02 : 0);
-        if (cf || ((lo <= 9) ? (hi >= 10) : (hi >= 9))) 
-        {
-            res_f |= 0x01;
-        }
-        if (nf ? (hf && (lo <= 5)) : (lo >= 10)) 
-        {
-            res_f |= 0x10;
-        }
-        m_DAATable[x] = (res_a << 8) + res_f;
     }
+}
 
+///////////////////////////////////////////////////////////////////////
+#endif
+
+template <class Bus>
+void Z80<Bus>::DumpTrace()
+{
+#ifdef Z80_TRACE
+    if (m_Trace.dump("z80trace.bin"))
+    {
+        char buffer[255];
+        sprintf(buffer, "Wrote the last %zu instructions to z80trace.bin", m_Trace.getCount());
+        LogMessage::GetSingleton()->DoLogMessage(buffer, true);
+    }
+#endif
 }
+
+///////////////////////////////////////////////////////////////////////
+
+
+
+
+
+//////////////////////////////////////////////////////////////////////////////////
+
+template class Z80<Z80Bus>;
+template int Z80<Z80Bus>::ExecuteNextOpcode<false>();
+#ifdef Z80_DEBUGGER
+template int Z80<Z80Bus>::ExecuteNextOpcode<true>();
+#endif
@@ -27,11 +27,30 @@
 
 #include "Config.hpp"
 
-typedef BYTE (*Z80ReadMemory)(WORD);
-typedef void (*Z80WriteMemory)(WORD, BYTE);
-typedef BYTE (*Z80IOReadMemory)(BYTE);
-typedef void (*Z80IOWriteMemory)(BYTE, BYTE);
+#ifdef Z80_BLOCK_CACHE
+#include <cstddef>
+#include <vector>
+#endif
 
+#ifdef Z80_PROFILER
+#include "Z80.Profiler.hpp"
+#endif
+
+#ifdef Z80_TRACE
+#include "Z80.Trace.hpp"
+#endif
+
+#ifdef Z80_DEBUGGER
+#include "Z80.Debugger.hpp"
+#endif
+
+#ifdef Z80_RECOMPILED
+#include <vector>
+
+// see Z80.Recompiled.hpp
+struct Z80RecompiledBlock;
+struct Z80RecompiledRom;
+#endif
 
 #define FLAG_S 7
 #define FLAG_Z 6
@@ -52,7 +71,19 @@ union REGISTERZ80
     };
 };
 
-struct CONTEXTZ80
+// the interrupt inputs, which the bus raises and lowers
+struct InteruptLine final
+{
+    enum
+    {
+        IRQ = 0x1,
+        NMI = 0x2
+    };
+};
+
+// only the register file lives here so the context stays within a
+// cache line. Memory is owned by the bus and reached through it
+struct alignas(64) CONTEXTZ80
 {
     REGISTERZ80         m_RegisterAF;
     REGISTERZ80         m_RegisterBC;
@@ -69,64 +100,288 @@ struct CONTEXTZ80
     BYTE                m_RegisterR;
     WORD                m_ProgramCounter;
     WORD                m_ProgramCounterStart;
-    BYTE                m_CartridgeMemory[0x100000];
-    BYTE                m_InternalMemory[0x10000];
     BYTE                m_OpcodeCycle;
-    Z80ReadMemory       m_FuncPtrRead;
-    Z80WriteMemory      m_FuncPtrWrite;
-    Z80IOReadMemory     m_FuncPtrIORead;
-    Z80IOWriteMemory    m_FuncPtrIOWrite;
 
     bool                m_Halted;
     bool                m_IFF1;
     bool                m_IFF2;
     bool                m_EIPending;
     int                 m_InteruptMode;
-    bool                m_NMI;
+    BYTE                m_InteruptLines; // InteruptLine bits
     bool                m_NMIServicing;
 };
 
+// The bus is a compile time parameter so that memory and IO accesses
+// are direct calls which the compiler is free to inline into each opcode.
+// It must provide readMemory(), writeMemory(), readIOMemory() and writeIOMemory(),
+// addInstructionCycles() which Run() calls after each instruction,
+// plus getBlockRepeatLimit(), addBlockCycles(), isBlockIOPort() and writeIOBlock()
+// which let the repeating block instructions run several iterations without
+// going back round the main loop. The cpu calls interuptPending() when EI or
+// RETN lets through an interrupt line which is already raised, so that the
+// bus can step in and call TakeInterupt() once the instruction has finished.
+// With Z80_BLOCK_CACHE defined it must also
+// provide getReadPointer(), protectCode(), getQuietCycles() and addCycles(),
+// see Z80.BlockCache.cpp. With Z80_PROFILER or Z80_RECOMPILED defined it must
+// provide getBank(), and with Z80_RECOMPILED getQuietCycles() and addCycles().
+// With Z80_PROFILER it must also provide getRomOffset(), and pass each read
+// the cpu makes from rom to Z80Profiler::addRead() while it's enabled.
+// peekMemory() reads without it counting as an access, for anything which
+// looks at the code rather than running it.
+// With Z80_TRACE defined it must provide getClock(), the cycles run since reset.
+// With Z80_DEBUGGER defined it has to call Z80Debugger::checkWatchpoint()
+// itself for the pages the debugger is watching
+template <class Bus>
 class Z80 final
 {
 public:
-                        Z80();
+        explicit        Z80(Bus& bus);
 
+        template <bool debug = false>
         int             ExecuteNextOpcode();
+        int             Run(int cycleBudget);
         void            PushWordOntoStack(WORD address);
         void            IncreaseRReg();
 
+        // the lines are only looked at between calls to Run(), by the bus
+        // calling TakeInterupt() whenever IsInteruptPending() says so
+        void            SetInteruptLine(int line, bool raised);
+        bool            IsInteruptPending() const;
+        void            TakeInterupt();
+
+        // with Z80_LAZY_FLAGS defined F may be stale until this is called,
+        // so anything reading F through GetContext() should call it first
+        void            SyncFlags();
+
         CONTEXTZ80*     GetContext() { return &m_ContextZ80; }
+
+#ifdef Z80_BLOCK_CACHE
+        // the bus calls these when memory holding decoded code changes
+        void            FlushCodeCache();
+        void            InvalidateCode(const BYTE* start, std::size_t size);
+#endif
+
+#ifdef Z80_PROFILER
+        Z80Profiler&    GetProfiler() { return m_Profiler; }
+#endif
+
+#ifdef Z80_RECOMPILED
+        // the blocks which sms-recompile built for the rom, or nullptr for
+        // none. They have to stay loaded until this is called again
+        void            SetRecompiledRom(const Z80RecompiledRom* rom);
+#endif
+
+#ifdef Z80_TRACE
+        Z80Trace&       GetTrace() { return m_Trace; }
+#endif
+
+#ifdef Z80_DEBUGGER
+        Z80Debugger&    GetDebugger() { return m_Debugger; }
+#endif
 private:
         void            ExecuteOpcode(const BYTE& opcode);
         WORD            ReadWord() const;
 
         WORD            PopWordOffStack();
-        void            LogInstInfo(BYTE opcode, const char* subset, bool showmnemonic);
+        void            InteruptsEnabled();
+        // writes the trace to z80trace.bin when something has gone wrong,
+        // does nothing unless Z80_TRACE is defined
+        void            DumpTrace();
 
+        Bus&            m_Bus;
         CONTEXTZ80      m_ContextZ80;
 
+        // Run() picks the debug loop only while the debugger has something
+        // to check, so the plain loop never looks at the pc
+        template <bool debug>
+        int             RunLoop(int cycleBudget);
+
+#ifdef Z80_DEBUGGER
+        Z80Debugger     m_Debugger;
+#endif
+
+#ifdef Z80_PROFILER
+        Z80Profiler     m_Profiler;
+
+        // where the bytes of the instruction starting at the pc are in the
+        // rom, taken before it runs as it might page itself out
+        std::array<int, 4> m_ProfileOffsets = {};
+
+        void            ProfileFetch();
+        void            ProfileInstruction(WORD address, int cycles);
+#endif
+
+#ifdef Z80_RECOMPILED
+        // the first block for each address rom can be paged to. Any others
+        // for the same address in other banks come straight after it
+        std::vector<const Z80RecompiledBlock*> m_Recompiled;
+        const Z80RecompiledBlock* m_RecompiledEnd = nullptr;
+
+        void            RunRecompiled();
+#endif
+
+#ifdef Z80_TRACE
+        Z80Trace        m_Trace;
+
+        // cycles are those the bus hasn't been given yet, up to the end of
+        // the instruction
+        void            TraceInstruction(WORD address, int cycles)
+        {
+            SyncFlags();
+            TraceRecord& record = m_Trace.addRecord(m_Bus.getClock() + cycles);
+            record.pc = address;
+            record.af = m_ContextZ80.m_RegisterAF.reg;
+            record.bc = m_ContextZ80.m_RegisterBC.reg;
+            record.de = m_ContextZ80.m_RegisterDE.reg;
+            record.hl = m_ContextZ80.m_RegisterHL.reg;
+            record.sp = m_ContextZ80.m_StackPointer.reg;
+            for (WORD i = 0; i < 4; ++i)
+            {
+                record.bytes[i] = m_Bus.peekMemory(address + i);
+            }
+        }
+#endif
+
+#ifdef Z80_LAZY_FLAGS
+        // the 8 bit ALU ops only record their operands and the flags are
+        // worked out by SyncFlags() when an instruction actually needs F
+        enum class LazyFlags : BYTE
+        {
+            None, Add, Sub, And, OrXor
+        };
+
+        LazyFlags       m_LazyFlags = LazyFlags::None;
+        BYTE            m_LazyBefore = 0;
+        BYTE            m_LazyOperand = 0;
+        WORD            m_LazyResult = 0;
+
+        void            SetLazyFlags(LazyFlags kind, BYTE before, BYTE operand, int res)
+        {
+            m_LazyFlags = kind;
+            m_LazyBefore = before;
+            m_LazyOperand = operand;
+            m_LazyResult = static_cast<WORD>(res);
+        }
+#endif
+
+#ifdef Z80_BLOCK_CACHE
+        // Straight line code is decoded once into a block of micro ops, each
+        // holding its handler along with pointers to the registers it uses and
+        // any immediate data. Blocks are keyed on the host address of their
+        // first opcode, which identifies the rom bank or ram it was read from.
+        struct MicroOp
+        {
+            void            (Z80::*handler)(const MicroOp&);
+            BYTE*           dst;
+            BYTE*           src;
+            WORD*           pair;
+            WORD            operand;
+            BYTE            opcode;
+            BYTE            length;
+            BYTE            cycles;
+            BYTE            offset; // from the start of the block
+            BYTE            fusion; // set on the first op of a run FuseBlock() found
+            BYTE            fusedCycles; // of all the ops in the run but the last
+        };
+
+        // the runs of ops which are fused into one, see FuseBlock()
+        struct Fusion final
+        {
+            enum
+            {
+                None,
+                ALUJump,
+                IncDecJump,
+                InALUJump,
+                LoadHLStep,
+
+                Count
+            };
+        };
+        static constexpr BYTE FUSED_COUNT[Fusion::Count] = { 1, 2, 2, 3, 2 };
+
+        // a block never crosses a 1KB boundary, which is the smallest unit
+        // that the memory map can change by
+        static constexpr WORD BLOCK_SPAN = 0x400;
+        static constexpr int BLOCK_MAX_OPS = 16;
+        static constexpr std::size_t BLOCK_CACHE_SIZE = 2048;
+
+        struct DecodedBlock
+        {
+            const BYTE*     source = nullptr;
+            int             count = 0;
+            bool            inRam = false;
+            MicroOp         ops[BLOCK_MAX_OPS];
+        };
+
+        std::vector<DecodedBlock>   m_BlockCache;
+        std::vector<DecodedBlock*>  m_RamBlocks; // the only ones InvalidateCode() needs to look at
+        DecodedBlock*   m_Block = nullptr;
+        int             m_BlockIndex = 0;
+        WORD            m_BlockStart = 0;
+
+        BYTE            ExecuteCachedOpcode(bool batch);
+        const MicroOp&  FetchMicroOp();
+        const MicroOp*  NextBlockOp() const;
+        void            AdvanceBlock();
+        void            DecodeBlock(DecodedBlock& block, const BYTE* source);
+        void            FuseBlock(DecodedBlock& block);
+        void            ExecuteFused(const MicroOp& op);
+        const MicroOp&  NextFusedOp(const MicroOp& op);
+        bool            MicroCondition(BYTE opcode) const;
+        BYTE*           GetRegister8(int code);
+        WORD*           GetRegister16(int code);
+
+        void            MICRO_INTERPRET(const MicroOp& op);
+        void            MICRO_NOP(const MicroOp& op);
+        void            MICRO_LOAD(const MicroOp& op);
+        void            MICRO_LOAD_IMMEDIATE(const MicroOp& op);
+        void            MICRO_LOAD_FROM_HL(const MicroOp& op);
+        void            MICRO_STORE_TO_HL(const MicroOp& op);
+        void            MICRO_16BIT_LOAD(const MicroOp& op);
+        void            MICRO_16BIT_INC(const MicroOp& op);
+        void            MICRO_16BIT_DEC(const MicroOp& op);
+        void            MICRO_INC(const MicroOp& op);
+        void            MICRO_DEC(const MicroOp& op);
+        void            MICRO_ADD(const MicroOp& op);
+        void            MICRO_SUB(const MicroOp& op);
+        void            MICRO_AND(const MicroOp& op);
+        void            MICRO_OR(const MicroOp& op);
+        void            MICRO_XOR(const MicroOp& op);
+        void            MICRO_COMPARE(const MicroOp& op);
+        void            MICRO_JUMP(const MicroOp& op);
+        void            MICRO_JUMP_IMMEDIATE(const MicroOp& op);
+        void            MICRO_JUMP_CONDITIONAL(const MicroOp& op);
+        BYTE            MicroSource(const MicroOp& op);
+
+        void            FUSED_ALU_JUMP(const MicroOp& op);
+        void            FUSED_INCDEC_JUMP(const MicroOp& op);
+        void            FUSED_IN_ALU_JUMP(const MicroOp& op);
+        void            FUSED_LOAD_HL_STEP(const MicroOp& op);
+#endif
+
 
         inline  void            CPU_NEG();
         inline  void            CPU_8BIT_LOAD_IMMEDIATE(BYTE& reg);
         inline  void            CPU_REG_LOAD(BYTE& reg, BYTE load);
         inline  void            CPU_REG_LOAD_ROM(BYTE& reg, WORD address);
         inline  void            CPU_16BIT_LOAD(WORD& reg);
-        inline  void            CPU_8BIT_ADD(BYTE& reg, BYTE toAdd, int cycles, bool useImmediate, bool addCarry);
-        inline  void            CPU_8BIT_SUB(BYTE& reg, BYTE toSub, int cycles, bool useImmediate, bool subCarry);
-        inline  void            CPU_8BIT_AND(BYTE& reg, BYTE toAnd, int cycles, bool useImmediate);
-        inline  void            CPU_8BIT_OR(BYTE& reg, BYTE toOr, int cycles, bool useImmediate);
-        inline  void            CPU_8BIT_XOR(BYTE& reg, BYTE toXOr, int cycles, bool useImmediate);
-        inline  void            CPU_8BIT_COMPARE(BYTE reg, BYTE toSubtract, int cycles, bool useImmediate); //dont pass a reference
-        inline  void            CPU_8BIT_INC(BYTE& reg, int cycles);
-        inline  void            CPU_8BIT_DEC(BYTE& reg, int cycles);
-        inline  void            CPU_8BIT_MEMORY_INC(WORD address, int cycles);
-        inline  void            CPU_8BIT_MEMORY_DEC(WORD address, int cycles);
+        inline  void            CPU_8BIT_ADD(BYTE& reg, BYTE toAdd, bool useImmediate, bool addCarry);
+        inline  void            CPU_8BIT_SUB(BYTE& reg, BYTE toSub, bool useImmediate, bool subCarry);
+        inline  void            CPU_8BIT_AND(BYTE& reg, BYTE toAnd, bool useImmediate);
+        inline  void            CPU_8BIT_OR(BYTE& reg, BYTE toOr, bool useImmediate);
+        inline  void            CPU_8BIT_XOR(BYTE& reg, BYTE toXOr, bool useImmediate);
+        inline  void            CPU_8BIT_COMPARE(BYTE reg, BYTE toSubtract, bool useImmediate); //dont pass a reference
+        inline  void            CPU_8BIT_INC(BYTE& reg);
+        inline  void            CPU_8BIT_DEC(BYTE& reg);
+        inline  void            CPU_8BIT_MEMORY_INC(WORD address);
+        inline  void            CPU_8BIT_MEMORY_DEC(WORD address);
         inline  void            CPU_LOAD_NNN(WORD reg);
 
-        inline  void            CPU_16BIT_DEC(WORD& word, int cycles);
-        inline  void            CPU_16BIT_INC(WORD& word, int cycles);
-        inline  void            CPU_16BIT_ADD(WORD& reg, WORD toAdd, int cycles, bool addCarry);
-        inline  void            CPU_16BIT_SUB(WORD& reg, WORD toSub, int cycles, bool subCarry);
+        inline  void            CPU_16BIT_DEC(WORD& word);
+        inline  void            CPU_16BIT_INC(WORD& word);
+        inline  void            CPU_16BIT_ADD(WORD& reg, WORD toAdd, bool addCarry);
+        inline  void            CPU_16BIT_SUB(WORD& reg, WORD toSub, bool subCarry);
 
         inline  void            CPU_JUMP(bool useCondition, int flag, bool condition);
         inline  void            CPU_JUMP_IMMEDIATE(bool useCondition, int flag, bool condition);
@@ -138,8 +393,8 @@ private:
         inline  void            CPU_RLC_MEMORY(WORD address, bool isAReg);
         inline  void            CPU_RRC(BYTE& reg, bool isAReg);
         inline  void            CPU_RRC_MEMORY(WORD address, bool isAReg);
-        inline  void            CPU_DDFD_RLC(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
-        inline  void            CPU_DDFD_RRC(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
+        inline  void            CPU_DDFD_RLC(BYTE& reg, WORD address);
+        inline  void            CPU_DDFD_RRC(BYTE& reg, WORD address);
 
         inline  void            CPU_DAA();
 
@@ -147,8 +402,8 @@ private:
         inline  void            CPU_RL_MEMORY(WORD address, bool isAReg);
         inline  void            CPU_RR(BYTE& reg, bool isAReg);
         inline  void            CPU_RR_MEMORY(WORD address, bool isAReg);
-        inline  void            CPU_DDFD_RL(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
-        inline  void            CPU_DDFD_RR(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
+        inline  void            CPU_DDFD_RL(BYTE& reg, WORD address);
+        inline  void            CPU_DDFD_RR(BYTE& reg, WORD address);
 
         inline  void            CPU_RLD();
         inline  void            CPU_RRD();
@@ -162,19 +417,19 @@ private:
         inline  void            CPU_SLL(BYTE& reg);
         inline  void            CPU_SLL_MEMORY(WORD address);
 
-        inline  void            CPU_DDFD_SLA(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
-        inline  void            CPU_DDFD_SRA(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
-        inline  void            CPU_DDFD_SRL(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
-        inline  void            CPU_DDFD_SLL(BYTE& reg, WORD& ixiyreg, SIGNED_BYTE& displacement);
+        inline  void            CPU_DDFD_SLA(BYTE& reg, WORD address);
+        inline  void            CPU_DDFD_SRA(BYTE& reg, WORD address);
+        inline  void            CPU_DDFD_SRL(BYTE& reg, WORD address);
+        inline  void            CPU_DDFD_SLL(BYTE& reg, WORD address);
 
 
         inline  void            CPU_RESET_BIT(BYTE& reg, int bit);
-        inline  void            CPU_DDFD_RESET_BIT(BYTE& reg, int bit, WORD& ixiyreg, SIGNED_BYTE& displacement);
+        inline  void            CPU_DDFD_RESET_BIT(BYTE& reg, int bit, WORD address);
         inline  void            CPU_RESET_BIT_MEMORY( WORD address, int bit);
-        inline  void            CPU_TEST_BIT(BYTE reg, int bit, int cycles);
-        inline  void            CPU_DDFD_TEST_BIT(BYTE reg, int bit, WORD& ixiyreg, SIGNED_BYTE& displacement);
+        inline  void            CPU_TEST_BIT(BYTE reg, int bit);
+        inline  void            CPU_DDFD_TEST_BIT(BYTE reg, int bit, WORD address);
         inline  void            CPU_SET_BIT(BYTE& reg, int bit);
-        inline  void            CPU_DDFD_SET_BIT(BYTE& reg, int bit, WORD& ixiyreg, SIGNED_BYTE& displacement);
+        inline  void            CPU_DDFD_SET_BIT(BYTE& reg, int bit, WORD address);
         inline  void            CPU_SET_BIT_MEMORY(WORD address, int bit);
 
         inline  void            CPU_IN(BYTE& data);
@@ -185,6 +440,7 @@ private:
         inline  void            CPU_OTIR();
         inline  void            CPU_OUTD();
         inline  void            CPU_OTDR();
+        inline  void            CPU_OUT_BLOCK(BYTE opcode, bool increment);
         inline  BYTE            CPU_CPI();
         inline  void            CPU_CPIR();
         inline  BYTE            CPU_CPD();
@@ -196,6 +452,7 @@ private:
 
         inline  void            CPU_LDI();
         inline  void            CPU_LDIR();
+        inline  bool            CPU_REPEAT_BLOCK(BYTE opcode, int& repeats, int limit);
 
         inline  void            CPU_DJNZ();
         inline  void            CPU_LDD();
@@ -206,9 +463,11 @@ private:
         inline  void            CPU_REG_LOAD_NNN(WORD& reg);
 
         void            ExecuteCBOpcode();
-        void            ExecuteDDFDCBOpcode(bool isDD);
+        template <bool isDD>
+        void            ExecuteDDFDCBOpcode();
         void            ExecuteEDOpcode();
-        void            ExecuteDDFDOpcode(bool isDD);
+        template <bool isDD>
+        void            ExecuteDDFDOpcode();
 
         inline  void            CPU_EXCHANGE(WORD& reg1, WORD& reg2);
 
@@ -217,8 +476,46 @@ private:
         inline  void            CPU_8BIT_MEM_IXIY_LOAD(BYTE store , const REGISTERZ80& reg);
 
         WORD            GetIXIYAddress(WORD value);
-        void            InitDAATable();
-        
-        WORD            m_DAATable[0x800];
-        BYTE            m_ZSPTable[256];
-};
\ No newline at end of file
+};
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+inline void Z80<Bus>::SetInteruptLine(int line, bool raised)
+{
+    if (raised)
+    {
+        m_ContextZ80.m_InteruptLines |= line;
+    }
+    else
+    {
+        m_ContextZ80.m_InteruptLines &= ~line;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+inline bool Z80<Bus>::IsInteruptPending() const
+{
+    // nothing is raised nearly all of the time, which is a single test.
+    // The irq is only pending when TakeInterupt() would take it, ie in IM 1
+    BYTE lines = m_ContextZ80.m_InteruptLines;
+    return (lines != 0)
+        && (((lines & InteruptLine::NMI) && !m_ContextZ80.m_NMIServicing)
+            || ((lines & InteruptLine::IRQ) && m_ContextZ80.m_IFF1 && (m_ContextZ80.m_InteruptMode == 1)));
+}
+
+///////////////////////////////////////////////////////////////////////
+
+template <class Bus>
+inline void Z80<Bus>::InteruptsEnabled()
+{
+    // called once IFF1 may have been set or IM 1 selected. A line raised
+    // before then hasn't been asked for by the bus, so it's told about it now
+    if (m_ContextZ80.m_IFF1 && (m_ContextZ80.m_InteruptMode == 1)
+        && (m_ContextZ80.m_InteruptLines & InteruptLine::IRQ))
+    {
+        m_Bus.interuptPending();
+    }
+}
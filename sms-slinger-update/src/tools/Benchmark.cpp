@@ -0,0 +1,161 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+//headless runner which plays each ROM for a fixed number of frames
+//as fast as possible and reports the instructions executed per second.
+//build with -DSMS_BUILD_BENCHMARK=ON, and again with -DSMS_LAZY_FLAGS=ON
+//to compare the two flag evaluation modes. With -DSMS_PROFILER=ON a
+//profile of each ROM is written next to it as <rom>.profile.txt/.csv,
+//along with its coverage as <rom>.coverage.bin, and with -DSMS_TRACE=ON
+//the end of its trace as <rom>.trace.bin. With -DSMS_WIDE=ON, -lanes n
+//plays n copies of each ROM in lockstep
+
+#include "Emulator.hpp"
+#include "LogMessages.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    int lanes = 1;
+#ifdef Z80_WIDE
+    if ((argc > 2) && (std::strcmp(argv[1], "-lanes") == 0))
+    {
+        lanes = std::max(1, std::atoi(argv[2]));
+        argc -= 2;
+        argv += 2;
+    }
+#endif
+
+    if (argc < 3)
+    {
+#ifdef Z80_WIDE
+        std::printf("usage: %s [-lanes n] <frames> <rom> [rom...]\n", argv[0]);
+#else
+        std::printf("usage: %s <frames> <rom> [rom...]\n", argv[0]);
+#endif
+        return 1;
+    }
+
+    const int frames = std::atoi(argv[1]);
+
+#ifdef Z80_LAZY_FLAGS
+    std::printf("flags: lazy\n");
+#else
+    std::printf("flags: eager\n");
+#endif
+
+#ifdef Z80_BLOCK_CACHE
+    std::printf("decode: block cache\n");
+#else
+    std::printf("decode: every instruction\n");
+#endif
+
+#ifdef Z80_PROFILER
+    std::printf("profiler: on\n");
+#endif
+
+#ifdef Z80_TRACE
+    std::printf("trace: on\n");
+#endif
+
+#ifdef Z80_WIDE
+    std::printf("lanes: %d\n", lanes);
+#endif
+
+    LogMessage::CreateInstance();
+    auto* emulator = Emulator::createInstance();
+#ifdef Z80_PROFILER
+    emulator->getProfiler().setEnabled(true);
+#endif
+
+    //the first lane is the singleton, so the profiler and trace see it
+    std::vector<std::unique_ptr<Emulator>> copies;
+    std::vector<Emulator*> emulators = { emulator };
+    for (int lane = 1; lane < lanes; ++lane)
+    {
+        copies.push_back(std::make_unique<Emulator>());
+        emulators.push_back(copies.back().get());
+    }
+
+    for (int i = 2; i < argc; ++i)
+    {
+        for (auto* e : emulators)
+        {
+            e->reset();
+            e->insertCartridge(argv[i]);
+        }
+
+        unsigned long long lockstep = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f)
+        {
+#ifdef Z80_WIDE
+            if (lanes > 1)
+            {
+                lockstep += Emulator::updateLockstep(emulators.data(), emulators.size());
+                continue;
+            }
+#endif
+            emulator->update();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double seconds = elapsed.count();
+        unsigned long long instructions = 0;
+        for (auto* e : emulators)
+        {
+            instructions += e->getInstructionCount();
+        }
+        std::printf("%s: %llu instructions in %.3fs, %.2f MIPS, %.1f fps\n",
+            argv[i], instructions, seconds,
+            (static_cast<double>(instructions) / seconds) / 1000000.0,
+            frames / seconds);
+        if (lanes > 1)
+        {
+            std::printf("    %.1f%% of them in lockstep\n",
+                (100.0 * static_cast<double>(lockstep)) / static_cast<double>(instructions));
+        }
+
+#ifdef Z80_PROFILER
+        std::string path(argv[i]);
+        emulator->getProfiler().writeReport(path + ".profile.txt");
+        emulator->getProfiler().writeCSV(path + ".profile.csv");
+        emulator->getProfiler().writeCoverage(path + ".coverage.bin");
+#endif
+#ifdef Z80_TRACE
+        emulator->getTrace().write(std::string(argv[i]) + ".trace.bin");
+#endif
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include "Z80.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+//a flat 64KB of ram with just enough of CP/M to run the zexdoc and zexall
+//instruction exercisers, so the Z80 can be tested and timed on its own.
+//Programs are loaded at 0x100. BDOS calls to 0x0005 land on a stub which
+//hands functions 2 and 9 (print a character and print a string) to
+//writeIOMemory(), and a warm boot to 0x0000 ends the run.
+class CpmBus final
+{
+public:
+    CpmBus();
+
+    void attach(Z80<CpmBus>& cpu) { m_cpu = &cpu; }
+    bool loadProgram(const std::string& path);
+    bool isFinished() const { return m_finished; }
+    unsigned long long getInstructionCount() const { return m_instructionCount; }
+    unsigned long long getClock() const { return m_clock; }
+
+    BYTE readMemory(const WORD& address) const { return m_memory[address]; }
+    BYTE peekMemory(WORD address) const { return m_memory[address]; }
+    void writeMemory(const WORD& address, const BYTE& data);
+    BYTE readIOMemory(const BYTE&) { return 0xFF; }
+    void writeIOMemory(const BYTE& address, const BYTE& data);
+
+    bool addInstructionCycles(int cycles);
+    void interuptPending() {} //nothing here raises an interrupt line
+    int getQuietCycles() const { return m_finished ? 0 : QUIET_CYCLES; }
+    int getBlockRepeatLimit(int cycles) const { return getQuietCycles() / cycles; }
+    void addBlockCycles(int cycles, int count) { m_clock += cycles; m_instructionCount += count; }
+    void addCycles(const BYTE* cycles, int count);
+    bool isBlockIOPort(BYTE) const { return false; }
+    void writeIOBlock(BYTE, const BYTE*, int, int) {}
+
+    const BYTE* getReadPointer(WORD address) const { return &m_memory[address]; }
+    bool protectCode(WORD address);
+    int getBank(WORD) const { return -1; }
+    int getRomOffset(WORD) const { return -1; }
+
+    //the stub at BDOS_ENTRY writes to these
+    static constexpr BYTE BDOS_PORT = 0xFF;
+    static constexpr BYTE EXIT_PORT = 0xFE;
+
+private:
+    Z80<CpmBus>* m_cpu = nullptr;
+    std::vector<BYTE> m_memory;
+    bool m_finished = false;
+    unsigned long long m_instructionCount = 0;
+    unsigned long long m_clock = 0;
+
+    //the cpu can run this long at once with the block cache
+    static constexpr int QUIET_CYCLES = 0x10000;
+
+    //1KB pages which the block cache has decoded code from, as
+    //the exercisers patch each instruction under test into place
+    static constexpr WORD PAGE_SHIFT = 10;
+    static constexpr WORD PAGE_COUNT = 0x10000 >> PAGE_SHIFT;
+    std::array<bool, PAGE_COUNT> m_codePages = {};
+};
+
+using Z80Bus = CpmBus;
+
+inline void CpmBus::writeMemory(const WORD& address, const BYTE& data)
+{
+    m_memory[address] = data;
+
+#ifdef Z80_BLOCK_CACHE
+    auto page = address >> PAGE_SHIFT;
+    if (m_codePages[page])
+    {
+        m_codePages[page] = false;
+        m_cpu->InvalidateCode(&m_memory[page << PAGE_SHIFT], 1 << PAGE_SHIFT);
+    }
+#endif
+}
+
+inline bool CpmBus::addInstructionCycles(int cycles)
+{
+    m_clock += cycles;
+    ++m_instructionCount;
+    return !m_finished;
+}
+
+inline void CpmBus::addCycles(const BYTE* cycles, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        m_clock += cycles[i];
+    }
+    m_instructionCount += count;
+}
+
+inline bool CpmBus::protectCode(WORD address)
+{
+    m_codePages[address >> PAGE_SHIFT] = true;
+    return true;
+}
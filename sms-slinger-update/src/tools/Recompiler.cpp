@@ -0,0 +1,562 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+//compiles a rom ahead of time into C++ for the emulator to load when it's
+//built with -DSMS_RECOMPILED=ON, see Z80.Recompiled.hpp. For game.sms:
+//
+//    sms-recompile game.sms game.cpp [profile.csv]
+//    c++ -std=c++17 -O2 -shared -fPIC -I<src> game.cpp -o game.sms.so
+//
+//and on windows build game.cpp into game.sms.dll next to the rom instead.
+//The walk starts at the reset, interrupt and nmi vectors with the rom paged
+//as it is at boot, and follows jumps, calls and restarts. Code which is only
+//reached through a table of addresses or with other banks paged in isn't
+//found that way, so the addresses in a CSV written by the profiler can be
+//given as more places to start.
+//Built by -DSMS_BUILD_RECOMPILER=ON.
+
+#include "Z80.Cycles.hpp"
+#include "Z80.Profiler.hpp"
+#include "Z80.Recompiled.hpp"
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    //the same as the Emulator, so the checksums match
+    constexpr std::size_t CARTRIDGE_SIZE = 0x100000;
+    constexpr WORD BANK_SIZE = 0x4000;
+
+    //a block never crosses a 1KB page as that's the smallest
+    //unit the memory map can change by, so the bank of its first
+    //byte is the bank of all of them
+    constexpr WORD PAGE_SIZE = 0x400;
+    constexpr int BLOCK_MAX_INSTRUCTIONS = 64;
+
+    const char* REGISTER8[] =
+    {
+        "z80.m_RegisterBC.hi", "z80.m_RegisterBC.lo", "z80.m_RegisterDE.hi", "z80.m_RegisterDE.lo",
+        "z80.m_RegisterHL.hi", "z80.m_RegisterHL.lo", nullptr, "z80.m_RegisterAF.hi"
+    };
+
+    const char* REGISTER16[] =
+    {
+        "z80.m_RegisterBC.reg", "z80.m_RegisterDE.reg", "z80.m_RegisterHL.reg", "z80.m_StackPointer.reg"
+    };
+
+    const char* READ_HL = "bus.readMemory(bus.bus, z80.m_RegisterHL.reg)";
+
+    struct Instruction final
+    {
+        WORD address = 0;
+        BYTE bytes[4] = {};
+        int length = 0;
+
+        BYTE n() const { return bytes[1]; }
+        WORD nn() const { return bytes[1] | (bytes[2] << 8); }
+    };
+
+    struct Block final
+    {
+        int bank = 0;
+        WORD address = 0;
+        int count = 0;
+        int cycles = 0;
+        std::vector<BYTE> opcodeCycles;
+        std::string code;
+    };
+
+    class Rom final
+    {
+    public:
+        bool load(const char* path);
+        std::uint32_t getChecksum() const { return Z80RecompiledChecksum(m_memory.data(), m_memory.size()); }
+        int getBankCount() const { return m_bankCount; }
+
+        //the bank which the code at from in bank expects to find at to
+        int getBank(int bank, WORD from, WORD to) const;
+        Instruction fetch(int bank, WORD address) const;
+
+    private:
+        std::vector<BYTE> m_memory = std::vector<BYTE>(CARTRIDGE_SIZE);
+        int m_bankCount = 0;
+    };
+
+    bool Rom::load(const char* path)
+    {
+        FILE* file = std::fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        //skip the header in the same way as Emulator::insertCartridge()
+        std::fseek(file, 0L, SEEK_END);
+        long header = std::ftell(file) % 16384;
+        std::fseek(file, ((header == 512) || (header == 64)) ? header : 0L, SEEK_SET);
+
+        std::size_t size = std::fread(m_memory.data(), 1, m_memory.size(), file);
+        std::fclose(file);
+
+        m_bankCount = static_cast<int>((size + BANK_SIZE - 1) / BANK_SIZE);
+        return size != 0;
+    }
+
+    int Rom::getBank(int bank, WORD from, WORD to) const
+    {
+        //the first 1KB is always bank 0, and the rest of a slot is
+        //whatever the code jumping there is in. Anything else is a
+        //guess that it's paged as it is at boot, which the emulator
+        //checks before running the block
+        int result = to / BANK_SIZE;
+        if (to < PAGE_SIZE)
+        {
+            result = 0;
+        }
+        else if ((to / BANK_SIZE) == (from / BANK_SIZE))
+        {
+            result = bank;
+        }
+        else if (to >= 0xC000)
+        {
+            return -1;
+        }
+        return (result < m_bankCount) ? result : -1;
+    }
+
+    Instruction Rom::fetch(int bank, WORD address) const
+    {
+        Instruction op;
+        op.address = address;
+        for (WORD i = 0; i < 4; ++i)
+        {
+            WORD at = address + i;
+            int atBank = getBank(bank, address, at);
+            if (atBank >= 0)
+            {
+                op.bytes[i] = m_memory[atBank * BANK_SIZE + (at % BANK_SIZE)];
+            }
+        }
+        op.length = Z80Profiler::getLength(op.bytes);
+        return op;
+    }
+
+    std::string format(const char* text, unsigned value)
+    {
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), text, value);
+        return buffer;
+    }
+
+    //the code which leaves the block before the instruction at address
+    //rather than make a write which the emulator might do more than store
+    std::string checkWrite(const std::string& address, const Instruction& op, int index)
+    {
+        return "        if (!Z80RecompiledCanWrite(" + address + ")) return Z80RecompiledExit(z80, "
+            + format("0x%04X", op.address) + ", " + std::to_string(index) + ");\n";
+    }
+
+    std::string write(const std::string& address, const std::string& data)
+    {
+        return "        bus.writeMemory(bus.bus, " + address + ", " + data + ");\n";
+    }
+
+    std::string compileALU(int operation, const std::string& value)
+    {
+        switch (operation)
+        {
+        default:
+        case 0: return "        Z80RecompiledAdd(z80, " + value + ", 0);\n";
+        case 1: return "        Z80RecompiledAdd(z80, " + value + ", Z80RecompiledCarry(z80));\n";
+        case 2: return "        Z80RecompiledSub(z80, " + value + ", 0);\n";
+        case 3: return "        Z80RecompiledSub(z80, " + value + ", Z80RecompiledCarry(z80));\n";
+        case 4: return "        Z80RecompiledAnd(z80, " + value + ");\n";
+        case 5: return "        Z80RecompiledXor(z80, " + value + ");\n";
+        case 6: return "        Z80RecompiledOr(z80, " + value + ");\n";
+        case 7: return "        Z80RecompiledCompare(z80, " + value + ");\n";
+        }
+    }
+
+    //the code for the instruction, which is the index'th of its block, or
+    //false for one which is left to the interpreter. Only the unprefixed
+    //loads and the 8 bit ALU ops are compiled, the same as the ones the
+    //block cache runs itself, as nothing else is spent enough time in to
+    //be worth proving exact by hand
+    bool compileInstruction(const Instruction& op, int index, std::string& code)
+    {
+        const BYTE opcode = op.bytes[0];
+        const int dst = (opcode >> 3) & 7;
+        const int src = opcode & 7;
+        const int pair = (opcode >> 4) & 3;
+
+        if (opcode == 0x00)
+        {
+            // NOP
+        }
+        else if ((opcode >= 0x40) && (opcode < 0x80) && (opcode != 0x76))
+        {
+            if (src == 6)
+            {
+                code += "        " + std::string(REGISTER8[dst]) + " = " + READ_HL + ";\n";
+            }
+            else if (dst == 6)
+            {
+                code += checkWrite(REGISTER16[2], op, index);
+                code += write(REGISTER16[2], REGISTER8[src]);
+            }
+            else
+            {
+                code += "        " + std::string(REGISTER8[dst]) + " = " + REGISTER8[src] + ";\n";
+            }
+        }
+        else if ((opcode & 0xC7) == 0x06)
+        {
+            if (dst == 6)
+            {
+                code += checkWrite(REGISTER16[2], op, index);
+                code += write(REGISTER16[2], format("0x%02X", op.n()));
+            }
+            else
+            {
+                code += "        " + std::string(REGISTER8[dst]) + format(" = 0x%02X;\n", op.n());
+            }
+        }
+        else if ((opcode & 0xCF) == 0x01)
+        {
+            code += "        " + std::string(REGISTER16[pair]) + format(" = 0x%04X;\n", op.nn());
+        }
+        else if ((opcode & 0xCF) == 0x03)
+        {
+            code += "        " + std::string(REGISTER16[pair]) + "++;\n";
+        }
+        else if ((opcode & 0xCF) == 0x0B)
+        {
+            code += "        " + std::string(REGISTER16[pair]) + "--;\n";
+        }
+        else if (((opcode & 0xC6) == 0x04) && (dst != 6))
+        {
+            code += std::string((opcode & 0x01) ? "        Z80RecompiledDec(z80, " : "        Z80RecompiledInc(z80, ")
+                + REGISTER8[dst] + ");\n";
+        }
+        else if ((opcode >= 0x80) && (opcode < 0xC0))
+        {
+            code += compileALU(dst, (src == 6) ? READ_HL : REGISTER8[src]);
+        }
+        else if ((opcode & 0xC7) == 0xC6)
+        {
+            code += compileALU(dst, format("0x%02X", op.n()));
+        }
+        else if ((opcode == 0x0A) || (opcode == 0x1A))
+        {
+            code += "        z80.m_RegisterAF.hi = bus.readMemory(bus.bus, " + std::string(REGISTER16[pair]) + ");\n";
+        }
+        else if ((opcode == 0x02) || (opcode == 0x12))
+        {
+            code += checkWrite(REGISTER16[pair], op, index);
+            code += write(REGISTER16[pair], REGISTER8[7]);
+        }
+        else if (opcode == 0x3A)
+        {
+            code += format("        z80.m_RegisterAF.hi = bus.readMemory(bus.bus, 0x%04X);\n", op.nn());
+        }
+        else if ((opcode == 0x32) && Z80RecompiledCanWrite(op.nn()))
+        {
+            code += write(format("0x%04X", op.nn()), REGISTER8[7]);
+        }
+        else if (opcode == 0xEB)
+        {
+            code += "        std::swap(z80.m_RegisterDE.reg, z80.m_RegisterHL.reg);\n";
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    class Recompiler final
+    {
+    public:
+        explicit Recompiler(const Rom& rom) : m_rom(rom) {}
+
+        void addEntryPoint(int bank, WORD address);
+        void run();
+        bool write(const char* path, const char* romPath) const;
+
+        std::size_t getBlockCount() const { return m_blocks.size(); }
+        std::size_t getInstructionCount() const;
+
+    private:
+        const Rom& m_rom;
+        std::set<std::uint32_t> m_visited;
+        std::vector<std::pair<int, WORD>> m_pending;
+        //ordered by address then bank, as the emulator needs them
+        std::map<std::uint32_t, Block> m_blocks;
+
+        void walk(int bank, WORD address);
+        void addSuccessors(int bank, const Instruction& op);
+    };
+
+    void Recompiler::addEntryPoint(int bank, WORD address)
+    {
+        if ((bank >= 0) && (bank < m_rom.getBankCount()) && (address < 0xC000)
+            && m_visited.insert((bank << 16) | address).second)
+        {
+            m_pending.emplace_back(bank, address);
+        }
+    }
+
+    void Recompiler::run()
+    {
+        while (!m_pending.empty())
+        {
+            auto [bank, address] = m_pending.back();
+            m_pending.pop_back();
+            walk(bank, address);
+        }
+    }
+
+    void Recompiler::walk(int bank, WORD address)
+    {
+        //compiles what it can from the start, then carries on from wherever
+        //the instruction which ended the block can go
+        Block block;
+        block.bank = bank;
+        block.address = address;
+
+        const int pageEnd = (address & ~(PAGE_SIZE - 1)) + PAGE_SIZE;
+        WORD pc = address;
+        while (true)
+        {
+            Instruction op = m_rom.fetch(bank, pc);
+            if (op.length == 0)
+            {
+                //not an instruction, so whatever this is can't be followed
+                break;
+            }
+
+            //a full block is carried on by the next one, and an
+            //instruction which is left out of any is interpreted
+            std::string code;
+            bool fits = (pc + op.length <= pageEnd) && (block.count < BLOCK_MAX_INSTRUCTIONS);
+            if (!fits && (block.count != 0))
+            {
+                addEntryPoint(m_rom.getBank(bank, address, pc), pc);
+                break;
+            }
+            if (!fits || !compileInstruction(op, block.count, code))
+            {
+                addSuccessors(bank, op);
+                break;
+            }
+
+            BYTE cycles = Z80CYCLES.Main.base[op.bytes[0]];
+            block.code += "        // " + format("%04X  ", pc) + Z80Profiler::disassemble(op.bytes, pc) + "\n" + code;
+            block.opcodeCycles.push_back(cycles);
+            block.cycles += cycles;
+            block.count++;
+            pc += op.length;
+        }
+
+        //a single instruction isn't worth the call
+        if (block.count > 1)
+        {
+            block.code += format("        return Z80RecompiledExit(z80, 0x%04X, ", pc) + std::to_string(block.count) + ");\n";
+            m_blocks[(address << 8) | bank] = std::move(block);
+        }
+    }
+
+    void Recompiler::addSuccessors(int bank, const Instruction& op)
+    {
+        const BYTE opcode = op.bytes[0];
+        const WORD next = op.address + op.length;
+        const WORD relative = next + static_cast<SIGNED_BYTE>(op.bytes[1]);
+        auto add = [&](WORD to)
+        {
+            addEntryPoint(m_rom.getBank(bank, op.address, to), to);
+        };
+
+        if ((opcode == 0xED) && ((op.bytes[1] & 0xC7) == 0x45))
+        {
+            // RETN and RETI
+            return;
+        }
+        if (((opcode == 0xDD) || (opcode == 0xFD)) && (op.bytes[1] == 0xE9))
+        {
+            // JP (IX) and JP (IY)
+            return;
+        }
+
+        switch (opcode)
+        {
+        case 0xC3: add(op.nn()); return;
+        case 0x18: add(relative); return;
+        case 0xC9: return;
+        case 0xE9: return;
+        case 0x10: case 0x20: case 0x28: case 0x30: case 0x38: add(relative); break;
+        case 0xCD: add(op.nn()); break;
+        default:
+            if (((opcode & 0xC7) == 0xC2) || ((opcode & 0xC7) == 0xC4))
+            {
+                // JP cc and CALL cc
+                add(op.nn());
+            }
+            else if ((opcode & 0xC7) == 0xC7)
+            {
+                // RST
+                add(opcode & 0x38);
+            }
+            break;
+        }
+
+        //anything else carries on to the next instruction, including
+        //calls as they're expected to return
+        add(next);
+    }
+
+    std::size_t Recompiler::getInstructionCount() const
+    {
+        std::size_t count = 0;
+        for (const auto& [key, block] : m_blocks)
+        {
+            count += block.count;
+        }
+        return count;
+    }
+
+    bool Recompiler::write(const char* path, const char* romPath) const
+    {
+        FILE* file = std::fopen(path, "w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        std::fprintf(file, "//generated by sms-recompile from %s, see Z80.Recompiled.hpp\n\n", romPath);
+        std::fprintf(file, "#include \"Z80.Recompiled.hpp\"\n\n#include <utility>\n\nnamespace\n{\n");
+
+        for (const auto& [key, block] : m_blocks)
+        {
+            std::fprintf(file, "    const BYTE Cycles_%02X_%04X[] = { ", block.bank, block.address);
+            for (std::size_t i = 0; i < block.opcodeCycles.size(); ++i)
+            {
+                std::fprintf(file, "%s%d", (i == 0) ? "" : ", ", block.opcodeCycles[i]);
+            }
+            std::fprintf(file, " };\n\n");
+            std::fprintf(file, "    int Block_%02X_%04X(CONTEXTZ80& z80, const Z80RecompiledBus& bus)\n    {\n%s    }\n\n",
+                block.bank, block.address, block.code.c_str());
+        }
+
+        std::fprintf(file, "    const Z80RecompiledBlock Blocks[] =\n    {\n");
+        for (const auto& [key, block] : m_blocks)
+        {
+            std::fprintf(file, "        { 0x%04X, 0x%02X, %d, %d, Cycles_%02X_%04X, &Block_%02X_%04X },\n",
+                block.address, block.bank, block.count, block.cycles,
+                block.bank, block.address, block.bank, block.address);
+        }
+        std::fprintf(file, "    };\n}\n\n");
+
+        std::fprintf(file, "Z80RECOMPILED_EXPORT const Z80RecompiledRom %s =\n{\n", Z80RECOMPILED_SYMBOL);
+        std::fprintf(file, "    %u, 0x%08Xu, sizeof(Blocks) / sizeof(Blocks[0]), Blocks\n};\n",
+            Z80RECOMPILED_VERSION, static_cast<unsigned>(m_rom.getChecksum()));
+
+        std::fclose(file);
+        return true;
+    }
+
+    //the addresses which a profiler CSV has counts for, see Z80Profiler::writeCSV()
+    int addProfiledEntryPoints(Recompiler& recompiler, const char* path)
+    {
+        FILE* file = std::fopen(path, "r");
+        if (file == nullptr)
+        {
+            return -1;
+        }
+
+        int count = 0;
+        char line[256];
+        while (std::fgets(line, sizeof(line), file) != nullptr)
+        {
+            //address rows have an empty table, opcode and mnemonic. RAM won't parse as a bank
+            unsigned int bank = 0;
+            unsigned int address = 0;
+            if (std::sscanf(line, "address,,,,%x,%x", &bank, &address) == 2)
+            {
+                recompiler.addEntryPoint(static_cast<int>(bank), static_cast<WORD>(address));
+                ++count;
+            }
+        }
+        std::fclose(file);
+        return count;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::printf("usage: %s <rom> <output.cpp> [profile.csv]\n", argv[0]);
+        return 1;
+    }
+
+    Rom rom;
+    if (!rom.load(argv[1]))
+    {
+        std::printf("failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    Recompiler recompiler(rom);
+    recompiler.addEntryPoint(0, 0x0000);
+    recompiler.addEntryPoint(0, 0x0038);
+    recompiler.addEntryPoint(0, 0x0066);
+
+    if (argc > 3)
+    {
+        int count = addProfiledEntryPoints(recompiler, argv[3]);
+        if (count < 0)
+        {
+            std::printf("failed to open %s\n", argv[3]);
+            return 1;
+        }
+        std::printf("%d addresses from %s\n", count, argv[3]);
+    }
+
+    recompiler.run();
+
+    if (!recompiler.write(argv[2], argv[1]))
+    {
+        std::printf("failed to write %s\n", argv[2]);
+        return 1;
+    }
+
+    std::printf("%zu blocks of %zu instructions written to %s\n",
+        recompiler.getBlockCount(), recompiler.getInstructionCount(), argv[2]);
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+//prints a trace written by Z80Trace, either by the File menu or when
+//the cpu hit something it couldn't run, oldest instruction first.
+//Each line shows the registers as they were once the instruction ran.
+//Built along with the emulator by -DSMS_TRACE=ON.
+
+#include "Z80.Trace.hpp"
+#include "Z80.Profiler.hpp"
+
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <trace.bin>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<TraceRecord> records;
+    if (!Z80Trace::read(argv[1], records))
+    {
+        std::printf("%s is not a trace, or was written by a different version\n", argv[1]);
+        return 1;
+    }
+
+    std::printf("%-14s %-4s  %-11s  %-20s %-4s %-4s %-4s %-4s %-4s\n", "cycle", "pc", "bytes", "instruction", "af", "bc", "de", "hl", "sp");
+    for (const auto& record : records)
+    {
+        std::printf("%14llu %04X  %02X %02X %02X %02X  %-20s %04X %04X %04X %04X %04X\n",
+            static_cast<unsigned long long>(record.cycle), record.pc,
+            record.bytes[0], record.bytes[1], record.bytes[2], record.bytes[3],
+            Z80Profiler::disassemble(record.bytes, record.pc).c_str(),
+            record.af, record.bc, record.de, record.hl, record.sp);
+    }
+
+    return 0;
+}
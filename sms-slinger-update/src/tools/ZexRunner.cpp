@@ -0,0 +1,211 @@
+/*
+    http://www.codeslinger.co.uk/pages/projects/mastersystem.html
+
+    Copyright(c) 2008 < copyright holders > (sic)
+    Modified 2021 Matt Marchant https://github.com/fallahn
+
+    This software is provided 'as-is', without any express or implied
+    warranty.In no event will the authors be held liable for any damages
+    arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose,
+    including commercial applications, and to alter itand redistribute it
+    freely, subject to the following restrictions :
+
+    1. The origin of this software must not be misrepresented; you must not
+    claim that you wrote the original software.If you use this software
+    in a product, an acknowledgment in the product documentation would be
+    appreciated but is not required.
+
+    2. Altered source versions must be plainly marked as such, and must not be
+    misrepresented as being the original software.
+
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+//runs the Z80 on its own on CP/M programs, such as the zexdoc and
+//zexall instruction exercisers, and reports how many of the tests
+//passed and how many instructions per second the core reached.
+//Build with -DSMS_BUILD_ZEX=ON, along with any of the Z80 options
+//such as -DSMS_BLOCK_CACHE=ON to test and time them.
+
+#include "tools/CpmBus.hpp"
+#include "LogMessages.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    constexpr WORD BDOS_ENTRY = 0x0005;
+    constexpr WORD BDOS_STUB = 0xFE00; //also the top of the stack
+    constexpr WORD PROGRAM_START = 0x100;
+
+    //the test results are collected from what the program prints
+    std::string line;
+    int passed = 0;
+    int failed = 0;
+
+    void print(char c)
+    {
+        std::putchar(c);
+        if (c == '\n')
+        {
+            //zexdoc ends each test with "OK" or "ERROR **** crc expected..."
+            if (line.find("ERROR") != std::string::npos)
+            {
+                ++failed;
+            }
+            else if (line.size() > 2 && line.compare(line.size() - 2, 2, "OK") == 0)
+            {
+                ++passed;
+            }
+            line.clear();
+        }
+        else if (c != '\r')
+        {
+            line += c;
+        }
+    }
+}
+
+CpmBus::CpmBus()
+    : m_memory(0x10000)
+{
+
+}
+
+bool CpmBus::loadProgram(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    std::fill(m_memory.begin(), m_memory.end(), 0);
+    std::fread(&m_memory[PROGRAM_START], 1, BDOS_STUB - PROGRAM_START, file);
+    std::fclose(file);
+
+    //warm boot: OUT (EXIT_PORT),A
+    const BYTE boot[] = { 0xD3, EXIT_PORT, 0x76 };
+    //BDOS: JP BDOS_STUB. The exercisers also read the top of the stack from 0x0006
+    const BYTE bdos[] = { 0xC3, BDOS_STUB & 0xFF, BDOS_STUB >> 8 };
+    //OUT (BDOS_PORT),A then RET
+    const BYTE stub[] = { 0xD3, BDOS_PORT, 0xC9 };
+
+    std::memcpy(&m_memory[0], boot, sizeof(boot));
+    std::memcpy(&m_memory[BDOS_ENTRY], bdos, sizeof(bdos));
+    std::memcpy(&m_memory[BDOS_STUB], stub, sizeof(stub));
+
+    m_codePages = {};
+    m_finished = false;
+    m_instructionCount = 0;
+    return true;
+}
+
+void CpmBus::writeIOMemory(const BYTE& address, const BYTE& data)
+{
+    if (address == EXIT_PORT)
+    {
+        m_finished = true;
+        return;
+    }
+
+    if (address != BDOS_PORT)
+    {
+        return;
+    }
+
+    const CONTEXTZ80* context = m_cpu->GetContext();
+    switch (context->m_RegisterBC.lo)
+    {
+    case 2:
+        print(static_cast<char>(context->m_RegisterDE.lo));
+        break;
+    case 9:
+        for (WORD address = context->m_RegisterDE.reg; m_memory[address] != '$'; ++address)
+        {
+            print(static_cast<char>(m_memory[address]));
+        }
+        break;
+    default:
+        std::printf("\nunsupported BDOS function %d\n", context->m_RegisterBC.lo);
+        m_finished = true;
+        break;
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <program.com> [program.com...]\n", argv[0]);
+        return 1;
+    }
+
+#ifdef Z80_LAZY_FLAGS
+    std::printf("flags: lazy\n");
+#else
+    std::printf("flags: eager\n");
+#endif
+
+#ifdef Z80_BLOCK_CACHE
+    std::printf("decode: block cache\n");
+#else
+    std::printf("decode: every instruction\n");
+#endif
+
+    LogMessage::CreateInstance();
+
+    CpmBus bus;
+    auto cpu = std::make_unique<Z80<CpmBus>>(bus);
+    bus.attach(*cpu);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!bus.loadProgram(argv[i]))
+        {
+            std::printf("failed to open %s\n", argv[i]);
+            return 1;
+        }
+
+        //make sure no pending lazy flags get written over the reset AF
+        cpu->SyncFlags();
+
+        CONTEXTZ80* context = cpu->GetContext();
+        *context = {};
+        context->m_ProgramCounter = PROGRAM_START;
+        context->m_StackPointer.reg = BDOS_STUB;
+#ifdef Z80_BLOCK_CACHE
+        cpu->FlushCodeCache();
+#endif
+
+        passed = failed = 0;
+        line.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        while (!bus.isFinished() && !context->m_Halted)
+        {
+            cpu->Run(0x10000);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double seconds = elapsed.count();
+        auto instructions = bus.getInstructionCount();
+        std::printf("\n%s: %d passed, %d failed. %llu instructions in %.3fs, %.2f MIPS\n",
+            argv[i], passed, failed, instructions, seconds,
+            (static_cast<double>(instructions) / seconds) / 1000000.0);
+
+        if (failed != 0 || !bus.isFinished())
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}